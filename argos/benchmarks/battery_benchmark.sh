@@ -0,0 +1,72 @@
+#!/usr/bin/env bash
+# Runs the headless experiment with several random seeds in parallel processes for each return trigger, letting the drones explore
+# until they return on low battery, and summarizes how late they returned
+# Usage: benchmarks/battery_benchmark.sh [run count] [parallel run count]
+
+set -o errexit
+set -o nounset
+set -o pipefail
+
+cd "$(dirname "$0")/.."
+
+readonly RUN_COUNT=${1:-8}
+readonly PARALLEL_RUN_COUNT=${2:-$(nproc)}
+# Longer than any battery lasts, so that every run stops once the drones landed or crashed
+readonly TIME_LIMIT=1800
+readonly EXPERIMENT=experiments/hivexplore_headless.argos
+readonly RESULTS_DIR=results/battery_benchmark
+readonly RETURN_TRIGGERS=(threshold predictive)
+
+# The drones are the entity distributed right before the crazyflie node
+DRONE_COUNT=$(grep -B 1 '<crazyflie ' "$EXPERIMENT" | sed -n 's/.*quantity="\([0-9]*\)".*/\1/p' | head -n 1)
+readonly DRONE_COUNT
+
+run_experiment() {
+    local trigger=$1
+    local seed=$2
+    local config="$RESULTS_DIR/$trigger/seed_$seed.argos"
+
+    sed -e "s/random_seed=\"[0-9]*\"/random_seed=\"$seed\"/" \
+        -e "s|output=\"[^\"]*\"|output=\"$RESULTS_DIR/$trigger/seed_$seed.csv\"|" \
+        -e "s/return_trigger=\"[a-z_]*\"/return_trigger=\"$trigger\"/" \
+        -e "s/return_time=\"[0-9.]*\"/return_time=\"0\"/" \
+        -e "s/coverage_target=\"[0-9.]*\"/coverage_target=\"1\"/" \
+        -e "s/time_limit=\"[0-9.]*\"/time_limit=\"$TIME_LIMIT\"/" \
+        "$EXPERIMENT" > "$config"
+    argos3 -z -c "$config" > "$RESULTS_DIR/$trigger/seed_$seed.log" 2>&1
+}
+
+for trigger in "${RETURN_TRIGGERS[@]}"; do
+    mkdir -p "$RESULTS_DIR/$trigger"
+    for seed in $(seq 1 "$RUN_COUNT"); do
+        # Limit the number of experiments running at once
+        while [ "$(jobs -rp | wc -l)" -ge "$PARALLEL_RUN_COUNT" ]; do
+            wait -n
+        done
+        run_experiment "$trigger" "$seed" &
+    done
+done
+wait
+
+for trigger in "${RETURN_TRIGGERS[@]}"; do
+    echo "Return trigger: $trigger"
+
+    # The last row of each CSV holds the final results of the run, where the landing charge is the mean over the landed drones
+    printf '%-6s %10s %12s %10s %15s %16s %16s\n' "Seed" "Drones" "Coverage" "Time (s)" "Landed drones" "Stranded drones" "Landing charge"
+    for seed in $(seq 1 "$RUN_COUNT"); do
+        tail -n 1 "$RESULTS_DIR/$trigger/seed_$seed.csv" |
+            awk -F, -v seed="$seed" -v droneCount="$DRONE_COUNT" '{
+                printf "%-6s %10d %11.1f%% %10.1f %15d %16d %15.1f%%\n", seed, droneCount, $2 * 100, $1, $8, $9, $10 * 100
+            }'
+    done | tee "$RESULTS_DIR/$trigger/summary.txt"
+
+    # The mean landing charge is weighted by the number of drones which landed in each run
+    awk '{ drones += $2; coverage += $3; landed += $5; stranded += $6; landingCharge += $5 * $7; runs++ }
+         END {
+             landedRate = drones > 0 ? landed * 100 / drones : 0
+             meanLandingCharge = landed > 0 ? landingCharge / landed : 0
+             meanCoverage = runs > 0 ? coverage / runs : 0
+             if (runs > 0) printf "Mean: %.1f%% coverage, %.1f%% landed, %d stranded, %.1f%% charge left once landed over %d runs\n\n", meanCoverage, landedRate, stranded, meanLandingCharge, runs
+         }' \
+        "$RESULTS_DIR/$trigger/summary.txt"
+done
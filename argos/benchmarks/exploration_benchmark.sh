@@ -0,0 +1,69 @@
+#!/usr/bin/env bash
+# Runs the headless experiment with several random seeds in parallel processes for each exploration mode and summarizes the
+# exploration results
+# Usage: benchmarks/exploration_benchmark.sh [run count] [parallel run count]
+
+set -o errexit
+set -o nounset
+set -o pipefail
+
+cd "$(dirname "$0")/.."
+
+readonly RUN_COUNT=${1:-8}
+readonly PARALLEL_RUN_COUNT=${2:-$(nproc)}
+readonly EXPERIMENT=experiments/hivexplore_headless.argos
+readonly RESULTS_DIR=results/exploration_benchmark
+readonly EXPLORATION_MODES=(wall_bounce frontier)
+# Energy of a full Crazyflie battery, 250 mAh at 3.7 V
+readonly BATTERY_ENERGY_J=3330
+
+# The drones are the entity distributed right before the crazyflie node
+DRONE_COUNT=$(grep -B 1 '<crazyflie ' "$EXPERIMENT" | sed -n 's/.*quantity="\([0-9]*\)".*/\1/p' | head -n 1)
+readonly DRONE_COUNT
+
+run_experiment() {
+    local mode=$1
+    local seed=$2
+    local config="$RESULTS_DIR/$mode/seed_$seed.argos"
+
+    sed -e "s/random_seed=\"[0-9]*\"/random_seed=\"$seed\"/" \
+        -e "s|output=\"[^\"]*\"|output=\"$RESULTS_DIR/$mode/seed_$seed.csv\"|" \
+        -e "s/exploration_mode=\"[a-z_]*\"/exploration_mode=\"$mode\"/" \
+        "$EXPERIMENT" > "$config"
+    argos3 -z -c "$config" > "$RESULTS_DIR/$mode/seed_$seed.log" 2>&1
+}
+
+for mode in "${EXPLORATION_MODES[@]}"; do
+    mkdir -p "$RESULTS_DIR/$mode"
+    for seed in $(seq 1 "$RUN_COUNT"); do
+        # Limit the number of experiments running at once
+        while [ "$(jobs -rp | wc -l)" -ge "$PARALLEL_RUN_COUNT" ]; do
+            wait -n
+        done
+        run_experiment "$mode" "$seed" &
+    done
+done
+wait
+
+for mode in "${EXPLORATION_MODES[@]}"; do
+    echo "Exploration mode: $mode"
+
+    # The last row of each CSV holds the final results of the run, where the battery used is the mean over the drones
+    printf '%-6s %10s %10s %14s %12s %16s %14s %18s\n' "Seed" "Time (s)" "Coverage" "Battery used" "Collisions" "Crashed drones" \
+        "Coverage/min" "Coverage/kJ"
+    for seed in $(seq 1 "$RUN_COUNT"); do
+        tail -n 1 "$RESULTS_DIR/$mode/seed_$seed.csv" |
+            awk -F, -v seed="$seed" -v droneCount="$DRONE_COUNT" -v batteryEnergy="$BATTERY_ENERGY_J" '{
+                energy = $3 / 100 * droneCount * batteryEnergy / 1000
+                coveragePerMinute = $1 > 0 ? $2 * 100 / ($1 / 60) : 0
+                coveragePerEnergy = energy > 0 ? $2 * 100 / energy : 0
+                printf "%-6s %10.1f %9.1f%% %13.1f%% %12d %16d %13.2f%% %17.2f%%\n", seed, $1, $2 * 100, $3, $4, $5,
+                    coveragePerMinute, coveragePerEnergy
+            }'
+    done | tee "$RESULTS_DIR/$mode/summary.txt"
+
+    awk '{ time += $2; coverage += $3; collisions += $5; coveragePerMinute += $7; coveragePerEnergy += $8; runs++ }
+         END { if (runs > 0) printf "Mean: %.1f s, %.1f%% coverage, %.1f collisions, %.2f%% coverage/min, %.2f%% coverage/kJ over %d runs\n\n",
+                   time / runs, coverage / runs, collisions / runs, coveragePerMinute / runs, coveragePerEnergy / runs, runs }' \
+        "$RESULTS_DIR/$mode/summary.txt"
+done
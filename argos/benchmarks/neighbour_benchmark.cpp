@@ -0,0 +1,97 @@
+// Compares the neighbour searches done by the controllers each tick, with every drone checking every other drone (like the range
+// and bearing medium) and with the spatial hash rebuilt by the loop functions, for increasing swarm sizes. Only the searches are
+// timed, scaling_benchmark.sh measures the simulation's ticks per second with and without the spatial hash
+// Usage: neighbour_benchmark [max drone count] [tick count]
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "utils/spatial_hash.h"
+
+namespace {
+    constexpr float neighbourRadius = 3.0f; // Default range of the Crazyflie's range and bearing device, in meters
+    constexpr float areaPerDrone = 4.0f; // Swarm density kept constant as the arena grows, in square meters
+    constexpr float maximumStep = 0.01f; // Largest distance travelled by a drone in one tick at 1 m/s, in meters
+
+    void findNeighboursBruteForce(const std::vector<CSpatialHash::SPoint>& positions, std::vector<std::size_t>& neighbours) {
+        const float squaredRadius = neighbourRadius * neighbourRadius;
+        for (std::size_t i = 0; i < positions.size(); i++) {
+            neighbours.clear();
+            for (std::size_t j = 0; j < positions.size(); j++) {
+                const float deltaX = positions[j].X - positions[i].X;
+                const float deltaY = positions[j].Y - positions[i].Y;
+                if (j != i && deltaX * deltaX + deltaY * deltaY <= squaredRadius) {
+                    neighbours.push_back(j);
+                }
+            }
+        }
+    }
+
+    void findNeighboursWithSpatialHash(CSpatialHash& spatialHash,
+                                       const std::vector<CSpatialHash::SPoint>& positions,
+                                       std::vector<std::size_t>& neighbours) {
+        spatialHash.Rebuild(positions);
+        for (std::size_t i = 0; i < positions.size(); i++) {
+            spatialHash.FindInRadius(positions[i].X, positions[i].Y, neighbourRadius, neighbours, i);
+        }
+    }
+
+    // Returns how many times per second the whole swarm's neighbours can be searched, with drones moving randomly between ticks
+    template<typename Function>
+    double runBenchmark(std::size_t droneCount, std::size_t tickCount, Function findNeighbours) {
+        const float arenaSize = std::sqrt(areaPerDrone * droneCount);
+        std::default_random_engine randomEngine(droneCount);
+        std::uniform_real_distribution<float> positionDistribution(0.0f, arenaSize);
+        std::uniform_real_distribution<float> stepDistribution(-maximumStep, maximumStep);
+
+        std::vector<CSpatialHash::SPoint> positions(droneCount);
+        for (auto& position : positions) {
+            position = {positionDistribution(randomEngine), positionDistribution(randomEngine)};
+        }
+
+        std::chrono::steady_clock::duration searchDuration{};
+        for (std::size_t tick = 0; tick < tickCount; tick++) {
+            for (auto& position : positions) {
+                position.X += stepDistribution(randomEngine);
+                position.Y += stepDistribution(randomEngine);
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            findNeighbours(positions);
+            searchDuration += std::chrono::steady_clock::now() - start;
+        }
+        return tickCount / std::chrono::duration<double>(searchDuration).count();
+    }
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t maxDroneCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2048;
+    const std::size_t tickCount = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100;
+
+    std::cout << "Neighbour searches within " << neighbourRadius << " m, one drone per " << areaPerDrone << " m2, averaged over "
+              << tickCount << " ticks\n"
+              << std::setw(8) << "Drones" << std::setw(23) << "Brute force searches/s" << std::setw(24) << "Spatial hash searches/s"
+              << std::setw(10) << "Speedup" << '\n';
+
+    CSpatialHash spatialHash;
+    spatialHash.SetCellSize(neighbourRadius);
+    std::vector<std::size_t> neighbours;
+    for (std::size_t droneCount = 16; droneCount <= maxDroneCount; droneCount *= 2) {
+        const double bruteForceSearchesPerSecond = runBenchmark(droneCount, tickCount, [&](const auto& positions) {
+            findNeighboursBruteForce(positions, neighbours);
+        });
+        const double spatialHashSearchesPerSecond = runBenchmark(droneCount, tickCount, [&](const auto& positions) {
+            findNeighboursWithSpatialHash(spatialHash, positions, neighbours);
+        });
+
+        std::cout << std::fixed << std::setprecision(0) << std::setw(8) << droneCount << std::setw(23) << bruteForceSearchesPerSecond
+                  << std::setw(24) << spatialHashSearchesPerSecond << std::setprecision(1) << std::setw(9)
+                  << spatialHashSearchesPerSecond / bruteForceSearchesPerSecond << "x\n";
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,177 @@
+// Compares the time taken by the loop functions to receive and dispatch a mission state change broadcast to every drone
+// Usage: param_benchmark [drone count] [broadcast count]
+
+#include <algorithm>
+#include <any>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "libs/json.hpp"
+#include "utils/id_registry.h"
+#include "utils/socket_message.h"
+
+using json = nlohmann::json;
+
+namespace {
+    // Messages sent before being received, kept below the socket's buffer capacity so the sender never blocks
+    constexpr std::size_t messagesPerBatch = 50;
+
+    // Stands in for the ARGoS controller hierarchy, to keep the cost of the dynamic_cast done for each entity
+    class CController {
+    public:
+        virtual ~CController() = default;
+    };
+
+    class CFakeCrazyflieController : public CController {
+    public:
+        explicit CFakeCrazyflieController(std::string id) : m_id(std::move(id)) {
+        }
+
+        const std::string& GetId() const {
+            return m_id;
+        }
+
+        void SetParamData(const std::string& param, json value) {
+            if (param == "hivexplore.missionState") {
+                m_missionState = value.get<std::uint8_t>();
+            }
+        }
+
+        std::uint8_t GetMissionState() const {
+            return m_missionState;
+        }
+
+    private:
+        std::string m_id;
+        std::uint8_t m_missionState = 0;
+    };
+
+    // Previous implementation: controller list rebuilt every tick, fixed zero-filled buffer and linear search by ID
+    void receiveWithLinearSearch(int socket, std::map<std::string, std::any>& entities) {
+        std::vector<std::reference_wrapper<CFakeCrazyflieController>> controllers;
+        std::transform(entities.begin(), entities.end(), std::back_inserter(controllers), [](const auto& pair) {
+            return std::ref(dynamic_cast<CFakeCrazyflieController&>(*std::any_cast<CController*>(pair.second)));
+        });
+
+        while (true) {
+            static char buffer[4096] = {};
+            std::fill(std::begin(buffer), std::end(buffer), '\0');
+            ssize_t count = recv(socket, buffer, sizeof(buffer), MSG_DONTWAIT);
+            if (count <= 0) {
+                break;
+            }
+
+            json packet = json::parse(buffer);
+            std::string droneId = packet["droneId"];
+            auto it = std::find_if(controllers.begin(), controllers.end(), [&droneId](const auto& controller) {
+                return controller.get().GetId() == droneId;
+            });
+            if (it != controllers.end()) {
+                it->get().SetParamData(packet["paramName"], packet["value"]);
+            }
+        }
+    }
+
+    // Current implementation: registry built once, in place parsing of a reused buffer and hashed lookup by ID
+    void receiveWithRegistry(int socket, const CIdRegistry<CFakeCrazyflieController>& controllers, std::vector<char>& buffer) {
+        while (true) {
+            ssize_t count = receiveSocketMessage(socket, buffer);
+            if (count <= 0) {
+                break;
+            }
+
+            json packet = json::parse(buffer.begin(), buffer.begin() + count);
+            CFakeCrazyflieController* controller = controllers.Find(packet["droneId"].get_ref<const std::string&>());
+            if (controller != nullptr) {
+                controller->SetParamData(packet["paramName"], packet["value"]);
+            }
+        }
+    }
+
+    template<typename Function>
+    double runBenchmark(int sendSocket,
+                        const std::vector<std::string>& packets,
+                        std::size_t broadcastCount,
+                        Function receiveMessages) {
+        std::chrono::steady_clock::duration receiveDuration{};
+        for (std::size_t broadcast = 0; broadcast < broadcastCount; broadcast++) {
+            for (std::size_t first = 0; first < packets.size(); first += messagesPerBatch) {
+                const std::size_t last = std::min(first + messagesPerBatch, packets.size());
+                for (std::size_t i = first; i < last; i++) {
+                    if (send(sendSocket, packets[i].c_str(), packets[i].size(), 0) == -1) {
+                        std::perror("Benchmark socket send");
+                        std::exit(EXIT_FAILURE);
+                    }
+                }
+
+                // Only time the receiving end, which is what the loop functions do
+                auto start = std::chrono::steady_clock::now();
+                receiveMessages();
+                receiveDuration += std::chrono::steady_clock::now() - start;
+            }
+        }
+        return std::chrono::duration<double, std::micro>(receiveDuration).count() / broadcastCount;
+    }
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t droneCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 500;
+    const std::size_t broadcastCount = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100;
+
+    int sockets[2];
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, sockets) == -1) {
+        std::perror("Benchmark socketpair");
+        return EXIT_FAILURE;
+    }
+
+    std::vector<CFakeCrazyflieController> controllerStorage;
+    controllerStorage.reserve(droneCount);
+    std::map<std::string, std::any> entities;
+    CIdRegistry<CFakeCrazyflieController> controllers;
+    std::vector<std::string> packets;
+    for (std::size_t i = 0; i < droneCount; i++) {
+        CFakeCrazyflieController& controller = controllerStorage.emplace_back("s" + std::to_string(i));
+        entities.emplace(controller.GetId(), static_cast<CController*>(&controller));
+        controllers.Add(controller.GetId(), controller);
+
+        // Same packet as the one sent by the server to set the mission state
+        json packet = {
+            {"paramName", "hivexplore.missionState"},
+            {"droneId", controller.GetId()},
+            {"value", 1},
+        };
+        packets.push_back(packet.dump());
+    }
+
+    const double linearSearchDuration = runBenchmark(sockets[0], packets, broadcastCount, [&]() {
+        receiveWithLinearSearch(sockets[1], entities);
+    });
+
+    std::vector<char> buffer;
+    const double registryDuration = runBenchmark(sockets[0], packets, broadcastCount, [&]() {
+        receiveWithRegistry(sockets[1], controllers, buffer);
+    });
+
+    const bool isEveryDroneUpdated = std::all_of(controllerStorage.begin(), controllerStorage.end(), [](const auto& controller) {
+        return controller.GetMissionState() == 1;
+    });
+    if (!isEveryDroneUpdated) {
+        std::cerr << "Mission state was not dispatched to every drone\n";
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "Mission state broadcast to " << droneCount << " drones, averaged over " << broadcastCount << " broadcasts\n"
+              << "Linear search: " << linearSearchDuration << " us/broadcast\n"
+              << "Registry:      " << registryDuration << " us/broadcast\n";
+
+    close(sockets[0]);
+    close(sockets[1]);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,72 @@
+#!/usr/bin/env bash
+# Runs the headless experiment with several random seeds in parallel processes for each return mode, ordering the drones to return
+# to their base after exploring for a while, and summarizes the return results
+# Usage: benchmarks/return_benchmark.sh [run count] [parallel run count] [return time]
+
+set -o errexit
+set -o nounset
+set -o pipefail
+
+cd "$(dirname "$0")/.."
+
+readonly RUN_COUNT=${1:-8}
+readonly PARALLEL_RUN_COUNT=${2:-$(nproc)}
+readonly RETURN_TIME=${3:-120}
+# Drones which did not find their base by then are counted as failed returns
+readonly MAXIMUM_RETURN_DURATION=300
+readonly EXPERIMENT=experiments/hivexplore_headless.argos
+readonly RESULTS_DIR=results/return_benchmark
+readonly RETURN_MODES=(beeline breadcrumbs)
+
+# The drones are the entity distributed right before the crazyflie node
+DRONE_COUNT=$(grep -B 1 '<crazyflie ' "$EXPERIMENT" | sed -n 's/.*quantity="\([0-9]*\)".*/\1/p' | head -n 1)
+readonly DRONE_COUNT
+
+run_experiment() {
+    local mode=$1
+    local seed=$2
+    local config="$RESULTS_DIR/$mode/seed_$seed.argos"
+
+    sed -e "s/random_seed=\"[0-9]*\"/random_seed=\"$seed\"/" \
+        -e "s|output=\"[^\"]*\"|output=\"$RESULTS_DIR/$mode/seed_$seed.csv\"|" \
+        -e "s/return_mode=\"[a-z_]*\"/return_mode=\"$mode\"/" \
+        -e "s/return_time=\"[0-9.]*\"/return_time=\"$RETURN_TIME\"/" \
+        -e "s/time_limit=\"[0-9.]*\"/time_limit=\"$((RETURN_TIME + MAXIMUM_RETURN_DURATION))\"/" \
+        "$EXPERIMENT" > "$config"
+    argos3 -z -c "$config" > "$RESULTS_DIR/$mode/seed_$seed.log" 2>&1
+}
+
+for mode in "${RETURN_MODES[@]}"; do
+    mkdir -p "$RESULTS_DIR/$mode"
+    for seed in $(seq 1 "$RUN_COUNT"); do
+        # Limit the number of experiments running at once
+        while [ "$(jobs -rp | wc -l)" -ge "$PARALLEL_RUN_COUNT" ]; do
+            wait -n
+        done
+        run_experiment "$mode" "$seed" &
+    done
+done
+wait
+
+for mode in "${RETURN_MODES[@]}"; do
+    echo "Return mode: $mode"
+
+    # The last row of each CSV holds the final results of the run, where the return time is the mean over the returned drones
+    printf '%-6s %10s %16s %16s %14s %12s\n' "Seed" "Drones" "Returned drones" "Crashed drones" "Success rate" "Return (s)"
+    for seed in $(seq 1 "$RUN_COUNT"); do
+        tail -n 1 "$RESULTS_DIR/$mode/seed_$seed.csv" |
+            awk -F, -v seed="$seed" -v droneCount="$DRONE_COUNT" '{
+                successRate = droneCount > 0 ? $6 * 100 / droneCount : 0
+                printf "%-6s %10d %16d %16d %13.1f%% %12.1f\n", seed, droneCount, $6, $5, successRate, $7
+            }'
+    done | tee "$RESULTS_DIR/$mode/summary.txt"
+
+    # The mean return time is weighted by the number of drones which returned in each run
+    awk '{ drones += $2; returned += $3; returnTime += $3 * $6; runs++ }
+         END {
+             successRate = drones > 0 ? returned * 100 / drones : 0
+             meanReturnTime = returned > 0 ? returnTime / returned : 0
+             if (runs > 0) printf "Mean: %.1f%% success rate, %.1f s to return to the base over %d runs\n\n", successRate, meanReturnTime, runs
+         }' \
+        "$RESULTS_DIR/$mode/summary.txt"
+done
@@ -0,0 +1,57 @@
+#!/usr/bin/env bash
+# Measures the ticks per second of the simulation for several swarm sizes and thread counts, with the drones finding their
+# neighbours with the range and bearing sensor and in the loop functions' spatial hash
+# Usage: benchmarks/scaling_benchmark.sh [experiment length in seconds]
+
+set -o errexit
+set -o nounset
+set -o pipefail
+
+cd "$(dirname "$0")/.."
+
+readonly LENGTH_SECONDS=${1:-60}
+readonly TICKS_PER_SECOND=10
+readonly DRONE_COUNTS=(4 16 64 256)
+readonly THREAD_COUNTS=(1 2 4 8)
+readonly TEMPLATE=benchmarks/scaling_benchmark.argos.in
+
+readonly NEIGHBOURS_NODE='<neighbours radius="3" \/>'
+
+config=$(mktemp --suffix=.argos)
+metrics=$(mktemp --suffix=.csv)
+trap 'rm -f "$config" "$metrics"' EXIT
+
+echo "Simulation ticks per second over $LENGTH_SECONDS simulated seconds (faster than real time above $TICKS_PER_SECOND)"
+for neighbours in "range and bearing" "spatial hash"; do
+    printf '\nNeighbours from the %s\n' "$neighbours"
+    printf '%-8s' "Drones"
+    for threads in "${THREAD_COUNTS[@]}"; do
+        printf '%14s' "$threads threads"
+    done
+    printf '\n'
+
+    if [[ "$neighbours" == "spatial hash" ]]; then
+        # The range and bearing medium would still compute every drone's readings if it was declared
+        neighbour_substitutions=(-e "s/@NEIGHBOURS@/$NEIGHBOURS_NODE/" -e "/range_and_bearing/d")
+    else
+        neighbour_substitutions=(-e "/@NEIGHBOURS@/d")
+    fi
+
+    for drones in "${DRONE_COUNTS[@]}"; do
+        printf '%-8s' "$drones"
+        for threads in "${THREAD_COUNTS[@]}"; do
+            sed -e "s/@DRONE_COUNT@/$drones/" -e "s/@THREAD_COUNT@/$threads/" -e "s/@LENGTH@/$LENGTH_SECONDS/" \
+                -e "s|@OUTPUT@|$metrics|" "${neighbour_substitutions[@]}" "$TEMPLATE" > "$config"
+
+            # Wall time includes loading the experiment, which is small compared to a long enough run
+            start=$(date +%s.%N)
+            argos3 -z -c "$config" > /dev/null
+            end=$(date +%s.%N)
+
+            # Ticks simulated are read from the last time written by the headless loop functions, in case the run ended early
+            awk -F, -v ticks_per_second=$TICKS_PER_SECOND -v start="$start" -v end="$end" \
+                'NR > 1 { time = $1 } END { printf "%14.1f", time * ticks_per_second / (end - start) }' "$metrics"
+        done
+        printf '\n'
+    done
+done
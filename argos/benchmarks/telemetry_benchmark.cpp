@@ -0,0 +1,195 @@
+// Compares the size, serialization time and heap allocations per tick of the telemetry formats sent by the loop functions
+// Usage: telemetry_benchmark [drone count] [tick count]
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+#include "utils/telemetry_frame.h"
+
+namespace {
+    std::size_t allocationCount = 0;
+} // namespace
+
+// Count every heap allocation made by the benchmarked code
+void* operator new(std::size_t size) {
+    allocationCount++;
+    if (void* pointer = std::malloc(size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+namespace {
+    // Representation of the log data returned by the controllers before TelemetrySnapshot, kept as a baseline
+    using LogVariableMap = std::unordered_map<std::string, std::variant<std::uint8_t, std::uint16_t, float>>;
+    using LogConfigs = std::vector<std::pair<LogName, LogVariableMap>>;
+
+    struct BenchmarkResult {
+        std::size_t bytesPerTick = 0;
+        std::size_t packetsPerTick = 0;
+        double allocationsPerTick = 0.0;
+        double microsecondsPerTick = 0.0;
+    };
+
+    TelemetrySnapshot generateSnapshot(std::default_random_engine& randomEngine) {
+        std::uniform_real_distribution<float> floatDistribution(-5.0f, 5.0f);
+        std::uniform_int_distribution<std::uint16_t> rangeDistribution(0, 4000);
+        std::uniform_int_distribution<std::uint16_t> byteDistribution(0, 100);
+
+        TelemetrySnapshot snapshot = {};
+        for (const auto& field : telemetryFields) {
+            std::uint8_t* destination = reinterpret_cast<std::uint8_t*>(&snapshot) + field.offset;
+            switch (field.type) {
+            case TelemetryFieldType::UInt8: {
+                auto value = static_cast<std::uint8_t>(byteDistribution(randomEngine));
+                std::memcpy(destination, &value, sizeof(value));
+            } break;
+            case TelemetryFieldType::UInt16: {
+                std::uint16_t value = rangeDistribution(randomEngine);
+                std::memcpy(destination, &value, sizeof(value));
+            } break;
+            case TelemetryFieldType::Float: {
+                float value = floatDistribution(randomEngine);
+                std::memcpy(destination, &value, sizeof(value));
+            } break;
+            }
+        }
+        return snapshot;
+    }
+
+    LogConfigs toLogConfigs(const TelemetrySnapshot& snapshot) {
+        LogConfigs logConfigs;
+        for (LogName logName : telemetryLogNames) {
+            LogVariableMap variables;
+            for (const auto& field : telemetryFields) {
+                if (field.logName != logName) {
+                    continue;
+                }
+
+                const std::uint8_t* source = reinterpret_cast<const std::uint8_t*>(&snapshot) + field.offset;
+                switch (field.type) {
+                case TelemetryFieldType::UInt8:
+                    variables.emplace(field.name, *source);
+                    break;
+                case TelemetryFieldType::UInt16: {
+                    std::uint16_t value;
+                    std::memcpy(&value, source, sizeof(value));
+                    variables.emplace(field.name, value);
+                } break;
+                case TelemetryFieldType::Float: {
+                    float value;
+                    std::memcpy(&value, source, sizeof(value));
+                    variables.emplace(field.name, value);
+                } break;
+                }
+            }
+            logConfigs.emplace_back(logName, std::move(variables));
+        }
+        return logConfigs;
+    }
+
+    template<typename Function>
+    BenchmarkResult runBenchmark(std::size_t tickCount, Function serializeTick) {
+        // Warm up to let reused buffers reach their final capacity
+        BenchmarkResult result = serializeTick(0);
+
+        allocationCount = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t tick = 1; tick <= tickCount; tick++) {
+            result = serializeTick(static_cast<std::uint32_t>(tick));
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        result.allocationsPerTick = static_cast<double>(allocationCount) / tickCount;
+        result.microsecondsPerTick = std::chrono::duration<double, std::micro>(end - start).count() / tickCount;
+        return result;
+    }
+
+    void printResult(const std::string& format, const BenchmarkResult& result) {
+        std::cout << std::left << std::setw(12) << format << std::right << std::setw(14) << result.bytesPerTick << std::setw(16)
+                  << result.packetsPerTick << std::setw(16) << std::fixed << std::setprecision(1) << result.allocationsPerTick
+                  << std::setw(14) << result.microsecondsPerTick << '\n';
+    }
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t droneCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000;
+    const std::size_t tickCount = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100;
+
+    std::default_random_engine randomEngine(0);
+    std::vector<std::string> droneIds;
+    std::vector<TelemetrySnapshot> snapshots;
+    for (std::size_t i = 0; i < droneCount; i++) {
+        droneIds.push_back("s" + std::to_string(i));
+        snapshots.push_back(generateSnapshot(randomEngine));
+    }
+
+    BenchmarkResult mapsResult = runBenchmark(tickCount, [&](std::uint32_t) {
+        BenchmarkResult result;
+        for (std::size_t i = 0; i < droneCount; i++) {
+            for (const auto& [logName, variables] : toLogConfigs(snapshots[i])) {
+                json variablesJson;
+                for (const auto& [key, variant] : variables) {
+                    std::visit([&key = std::as_const(key), &variablesJson](const auto& value) { variablesJson.emplace(key, value); },
+                               variant);
+                }
+                std::string packet = serializeJsonPacket(logName, droneIds[i], variablesJson);
+                result.bytesPerTick += packet.size();
+                result.packetsPerTick++;
+            }
+        }
+        return result;
+    });
+
+    BenchmarkResult jsonResult = runBenchmark(tickCount, [&](std::uint32_t) {
+        BenchmarkResult result;
+        for (std::size_t i = 0; i < droneCount; i++) {
+            for (LogName logName : telemetryLogNames) {
+                std::string packet = serializeJsonPacket(logName, droneIds[i], telemetryGroupToJson(snapshots[i], logName));
+                result.bytesPerTick += packet.size();
+                result.packetsPerTick++;
+            }
+        }
+        return result;
+    });
+
+    CTelemetryFrameWriter frameWriter;
+    BenchmarkResult binaryResult = runBenchmark(tickCount, [&](std::uint32_t tick) {
+        BenchmarkResult result;
+        frameWriter.Clear(tick);
+        for (std::size_t i = 0; i < droneCount; i++) {
+            frameWriter.Append(static_cast<std::uint16_t>(i), snapshots[i]);
+        }
+        for (const auto& frame : frameWriter.GetFrames()) {
+            result.bytesPerTick += frame.second;
+            result.packetsPerTick++;
+        }
+        return result;
+    });
+
+    std::cout << "Telemetry serialization for " << droneCount << " drones over " << tickCount << " ticks\n"
+              << std::left << std::setw(12) << "Format" << std::right << std::setw(14) << "Bytes/tick" << std::setw(16) << "Packets/tick"
+              << std::setw(16) << "Allocs/tick" << std::setw(14) << "us/tick" << '\n';
+    printResult("maps+json", mapsResult);
+    printResult("json", jsonResult);
+    printResult("binary", binaryResult);
+
+    return EXIT_SUCCESS;
+}
@@ -3,6 +3,8 @@
 #include <array>
 #include <cmath>
 #include <random>
+#include <vector>
+#include <argos3/core/utility/math/rng.h>
 #include <argos3/core/utility/math/vector2.h>
 #include <argos3/core/utility/logging/argos_log.h>
 #include "utils/constants.h"
@@ -22,6 +24,13 @@ namespace {
     static constexpr std::uint16_t maximumReorientationTicks = 600;
     static constexpr std::uint16_t stabilizeRotationTicks = 40;
 
+    // Frontier exploration constants, matching the drone firmware's occupancy grid
+    static constexpr std::uint16_t frontierReplanTicks = 100;
+    static constexpr float occupancyGridSide = 12.8f;
+    static constexpr float occupancyGridCellSize = 0.2f;
+    static constexpr float frontierClaimRadius = 1.0f;
+    static constexpr double frontierYawTolerance = 20.0; // In degrees
+
     // Return to base constants
     static constexpr std::uint16_t maximumReturnTicks = 800;
     static constexpr std::uint64_t initialExploreTicks = 600;
@@ -31,13 +40,10 @@ namespace {
         return reading == obstacleTooFar ? 0.0 : threshold - std::min(threshold, reading);
     }
 
-    std::uint8_t GetRandomRotationChangeCount() {
-        static std::random_device randomDevice;
-        static std::default_random_engine randomEngine(randomDevice());
-
+    std::uint8_t GetRandomRotationChangeCount(std::default_random_engine& randomEngine) {
         static constexpr std::uint8_t minRotationCount = 3;
         static constexpr std::uint8_t maxRotationCount = 6;
-        static std::uniform_int_distribution<std::uint8_t> randomDistribution(minRotationCount, maxRotationCount);
+        std::uniform_int_distribution<std::uint8_t> randomDistribution(minRotationCount, maxRotationCount);
 
         return randomDistribution(randomEngine);
     }
@@ -48,8 +54,13 @@ void CCrazyflieController::Init(TConfigurationNode& t_node) {
     try {
         m_pcDistance = GetSensor<CCI_CrazyflieDistanceScannerSensor>("crazyflie_distance_scanner");
         m_pcPropellers = GetActuator<CCI_QuadRotorPositionActuator>("quadrotor_position");
-        m_pcRABA = GetActuator<CCI_RangeAndBearingActuator>("range_and_bearing");
-        m_pcRABS = GetSensor<CCI_RangeAndBearingSensor>("range_and_bearing");
+        // Experiments which find neighbours in the loop functions' spatial hash leave out the range and bearing device and its medium
+        if (HasActuator("range_and_bearing")) {
+            m_pcRABA = GetActuator<CCI_RangeAndBearingActuator>("range_and_bearing");
+        }
+        if (HasSensor("range_and_bearing")) {
+            m_pcRABS = GetSensor<CCI_RangeAndBearingSensor>("range_and_bearing");
+        }
         m_pcPos = GetSensor<CCI_PositioningSensor>("positioning");
         m_pcBattery = GetSensor<CCI_BatterySensor>("battery");
     } catch (CARGoSException& e) {
@@ -57,6 +68,42 @@ void CCrazyflieController::Init(TConfigurationNode& t_node) {
     }
 
     m_initialPosition = m_pcPos->GetReading().Position;
+    m_previousPosition = m_initialPosition;
+
+    // Allow experiments without a server (such as benchmarks) to start the mission
+    GetNodeAttributeOrDefault(t_node, "start_exploring", m_shouldStartExploring, false);
+
+    std::string explorationMode;
+    GetNodeAttributeOrDefault(t_node, "exploration_mode", explorationMode, std::string("wall_bounce"));
+    if (explorationMode == "wall_bounce") {
+        m_explorationMode = ExplorationMode::WallBounce;
+    } else if (explorationMode == "frontier") {
+        m_explorationMode = ExplorationMode::Frontier;
+    } else {
+        THROW_ARGOSEXCEPTION("Unknown exploration mode \"" << explorationMode << "\", expected \"wall_bounce\" or \"frontier\"");
+    }
+
+    // The beeline return is kept to compare it with the breadcrumb trail, which the drone firmware uses
+    std::string returnMode;
+    GetNodeAttributeOrDefault(t_node, "return_mode", returnMode, std::string("breadcrumbs"));
+    if (returnMode == "beeline") {
+        m_returnMode = ReturnMode::Beeline;
+    } else if (returnMode == "breadcrumbs") {
+        m_returnMode = ReturnMode::Breadcrumbs;
+    } else {
+        THROW_ARGOSEXCEPTION("Unknown return mode \"" << returnMode << "\", expected \"beeline\" or \"breadcrumbs\"");
+    }
+
+    // The fixed threshold is kept to compare it with the predictive return, which the drone firmware uses
+    std::string returnTrigger;
+    GetNodeAttributeOrDefault(t_node, "return_trigger", returnTrigger, std::string("predictive"));
+    if (returnTrigger == "threshold") {
+        m_returnTrigger = ReturnTrigger::Threshold;
+    } else if (returnTrigger == "predictive") {
+        m_returnTrigger = ReturnTrigger::Predictive;
+    } else {
+        THROW_ARGOSEXCEPTION("Unknown return trigger \"" << returnTrigger << "\", expected \"threshold\" or \"predictive\"");
+    }
 
     Reset();
 }
@@ -71,6 +118,9 @@ void CCrazyflieController::ControlStep() {
     UpdateVelocity();
     UpdateSensorReadings();
     UpdateRssi();
+    UpdateNeighbourReadings();
+    UpdateOccupancyGrid();
+    UpdateBreadcrumbTrail();
 
     if (m_isOutOfService) {
         return;
@@ -92,7 +142,7 @@ void CCrazyflieController::ControlStep() {
         break;
     case MissionState::Exploring:
         if (!AvoidObstaclesAndDrones()) {
-            if (m_isBatteryBelowMinimumThreshold) {
+            if (m_isReturnChargeReached) {
                 ReturnToBase();
             } else {
                 Explore();
@@ -123,67 +173,68 @@ void CCrazyflieController::ControlStep() {
 }
 
 void CCrazyflieController::Reset() {
+    // Give each drone its own random stream, reproducible from the experiment's random seed and the robot ID, so that
+    // controllers share no state when ARGoS steps them in parallel
+    const std::string& id = GetId();
+    std::vector<std::uint32_t> seedData = {CRandom::GetCategory("argos").GetSeed()};
+    seedData.insert(seedData.end(), id.begin(), id.end());
+    std::seed_seq seedSequence(seedData.begin(), seedData.end());
+    m_randomEngine.seed(seedSequence);
+
+    if (m_shouldStartExploring) {
+        m_missionState = MissionState::Exploring;
+    }
+
+    // The battery models are recharged when the experiment is reset
+    m_batteryEstimator.Clear();
     ResetInternalStates();
 }
 
 void CCrazyflieController::Destroy() {
 }
 
-// Returns an unordered_map. The key is the log config name and the value is
-// an unordered_map that contains the log variables' names and their values
-CCrazyflieController::LogConfigs CCrazyflieController::GetLogData() const {
-    // Fill map progressively
-    LogConfigs logDataMap;
+TelemetrySnapshot CCrazyflieController::GetTelemetrySnapshot() const {
+    TelemetrySnapshot snapshot = {};
 
     // Battery level group
-    LogVariableMap batteryLevelLog;
-    batteryLevelLog.emplace("hivexplore.batteryLevel", m_batteryLevel);
-    logDataMap.emplace_back(LogName::BatteryLevel, batteryLevelLog);
+    snapshot.batteryLevel = m_batteryLevel;
 
     // Orientation group
     CRadians angleRadians;
     CVector3 angleUnitVector;
     m_pcPos->GetReading().Orientation.ToAngleAxis(angleRadians, angleUnitVector);
     Real angleDegrees = ToDegrees(angleRadians.SignedNormalize()).GetValue();
-    LogVariableMap orientationLog;
-    orientationLog.emplace("stateEstimate.roll", static_cast<float>(angleDegrees * angleUnitVector.GetX()));
-    orientationLog.emplace("stateEstimate.pitch", static_cast<float>(angleDegrees * angleUnitVector.GetY()));
+    snapshot.roll = static_cast<float>(angleDegrees * angleUnitVector.GetX());
+    snapshot.pitch = static_cast<float>(angleDegrees * angleUnitVector.GetY());
     // Rotate 90 degrees clockwise to make a yaw of 0 face forward
-    orientationLog.emplace("stateEstimate.yaw", static_cast<float>(angleDegrees * angleUnitVector.GetZ() - 90.0));
-    logDataMap.emplace_back(LogName::Orientation, orientationLog);
+    snapshot.yaw = static_cast<float>(angleDegrees * angleUnitVector.GetZ() - 90.0);
 
     // Position group
-    CVector3 position = m_pcPos->GetReading().Position;
-    LogVariableMap positionLog;
-    positionLog.emplace("stateEstimate.x", static_cast<float>(position.GetX()));
-    positionLog.emplace("stateEstimate.y", static_cast<float>(position.GetY()));
-    positionLog.emplace("stateEstimate.z", static_cast<float>(position.GetZ()));
-    logDataMap.emplace_back(LogName::Position, positionLog);
+    const CVector3& position = m_pcPos->GetReading().Position;
+    snapshot.x = static_cast<float>(position.GetX());
+    snapshot.y = static_cast<float>(position.GetY());
+    snapshot.z = static_cast<float>(position.GetZ());
 
     // Velocity group
-    LogVariableMap velocityLog;
-    velocityLog.emplace("stateEstimate.vx", static_cast<float>(m_velocityReading.GetX()));
-    velocityLog.emplace("stateEstimate.vy", static_cast<float>(m_velocityReading.GetY()));
-    velocityLog.emplace("stateEstimate.vz", static_cast<float>(m_velocityReading.GetZ()));
-    logDataMap.emplace_back(LogName::Velocity, velocityLog);
-
-    // Range group - must be added after orientation and position
-    static const std::array<std::string, 6> rangeLogNames =
-        {"range.front", "range.left", "range.back", "range.right", "range.up", "range.zrange"};
-    LogVariableMap rangeLog = GetSensorReadings<std::uint16_t, LogVariableMap::mapped_type>(rangeLogNames);
-    logDataMap.emplace_back(LogName::Range, rangeLog);
+    snapshot.vx = static_cast<float>(m_velocityReading.GetX());
+    snapshot.vy = static_cast<float>(m_velocityReading.GetY());
+    snapshot.vz = static_cast<float>(m_velocityReading.GetZ());
+
+    // Range group
+    snapshot.rangeFront = static_cast<std::uint16_t>(m_sensorReadings.front);
+    snapshot.rangeLeft = static_cast<std::uint16_t>(m_sensorReadings.left);
+    snapshot.rangeBack = static_cast<std::uint16_t>(m_sensorReadings.back);
+    snapshot.rangeRight = static_cast<std::uint16_t>(m_sensorReadings.right);
+    snapshot.rangeUp = static_cast<std::uint16_t>(m_sensorReadings.up);
+    snapshot.rangeZrange = static_cast<std::uint16_t>(m_sensorReadings.down);
 
     // RSSI group
-    LogVariableMap rssiLog;
-    rssiLog.emplace("radio.rssi", m_rssiReading);
-    logDataMap.emplace_back(LogName::Rssi, rssiLog);
+    snapshot.rssi = m_rssiReading;
 
     // Drone status group
-    LogVariableMap droneStatusLog;
-    droneStatusLog.emplace("hivexplore.droneStatus", static_cast<std::uint8_t>(m_droneStatus));
-    logDataMap.emplace_back(LogName::DroneStatus, droneStatusLog);
+    snapshot.droneStatus = static_cast<std::uint8_t>(m_droneStatus);
 
-    return logDataMap;
+    return snapshot;
 }
 
 const std::string& CCrazyflieController::GetDebugPrint() const {
@@ -197,22 +248,48 @@ void CCrazyflieController::SetParamData(const std::string& param, json value) {
     } else if (param == "hivexplore." + paramNameToString(ParamName::IsLedEnabled)) {
         // Print LED state since simulated Crazyflie doesn't have LEDs
         RLOG << "Set LED state: " << value.get<bool>() << '\n';
+    } else if (param == "hivexplore." + paramNameToString(ParamName::ExplorationMode)) {
+        const std::uint8_t explorationMode = value.get<std::uint8_t>();
+        if (explorationMode != static_cast<std::uint8_t>(ExplorationMode::WallBounce) &&
+            explorationMode != static_cast<std::uint8_t>(ExplorationMode::Frontier)) {
+            RLOGERR << "Unknown exploration mode: " << static_cast<int>(explorationMode) << '\n';
+            return;
+        }
+        m_explorationMode = static_cast<ExplorationMode>(explorationMode);
+        RLOG << "Set exploration mode: " << static_cast<int>(explorationMode) << '\n';
     } else {
         RLOG << "Unknown param: " << param << '\n';
     }
 }
 
+void CCrazyflieController::SetDroneSpatialHash(const CSpatialHash* droneSpatialHash, std::size_t droneIndex, float neighbourRadius) {
+    m_droneSpatialHash = droneSpatialHash;
+    m_droneIndex = droneIndex;
+    m_neighbourRadius = neighbourRadius;
+}
+
+ClaimedFrontier CCrazyflieController::GetClaimedFrontier() const {
+    return {m_explorationMode == ExplorationMode::Frontier && m_hasFrontierTarget, m_frontierTarget};
+}
+
+void CCrazyflieController::SetClaimedFrontiers(const std::vector<ClaimedFrontier>* claimedFrontiers) {
+    m_claimedFrontiers = claimedFrontiers;
+}
+
 bool CCrazyflieController::AvoidObstaclesAndDrones() {
     // The obstacle detection threshold (similar to the logic found in the drone firmware) is smaller than the map edge rotation
     // detection threshold to avoid conflicts between the obstacle/drone collision avoidance and the exploration logic
     static constexpr std::uint16_t obstacleDetectedThreshold = 300;
 
-    bool isObstacleDetected = std::any_of(m_sensorReadings.begin(), m_sensorReadings.end(), [](const auto& reading) {
-        return reading.second <= obstacleDetectedThreshold;
-    });
+    bool isObstacleDetected = std::min({m_sensorReadings.front,
+                                        m_sensorReadings.left,
+                                        m_sensorReadings.back,
+                                        m_sensorReadings.right,
+                                        m_sensorReadings.up,
+                                        m_sensorReadings.down}) <= obstacleDetectedThreshold;
 
-    bool isOtherDroneDetected = std::any_of(m_pcRABS->GetReadings().begin(), m_pcRABS->GetReadings().end(), [](const auto& packet) {
-        return packet.Range * 10 <= obstacleDetectedThreshold; // Convert range from cm to mm
+    bool isOtherDroneDetected = std::any_of(m_neighbourReadings.begin(), m_neighbourReadings.end(), [](const auto& neighbour) {
+        return neighbour.range * 10 <= obstacleDetectedThreshold; // Convert range from cm to mm
     });
 
     bool isExploringAvoidanceDisallowed = m_missionState == MissionState::Exploring &&
@@ -234,22 +311,22 @@ bool CCrazyflieController::AvoidObstaclesAndDrones() {
         // Obstacle collision avoidance
         if (isObstacleDetected) {
             leftDistanceCorrection +=
-                CalculateObstacleDistanceCorrection(obstacleDetectedThreshold, m_sensorReadings["left"]) * avoidanceSensitivity;
+                CalculateObstacleDistanceCorrection(obstacleDetectedThreshold, m_sensorReadings.left) * avoidanceSensitivity;
             rightDistanceCorrection +=
-                CalculateObstacleDistanceCorrection(obstacleDetectedThreshold, m_sensorReadings["right"]) * avoidanceSensitivity;
+                CalculateObstacleDistanceCorrection(obstacleDetectedThreshold, m_sensorReadings.right) * avoidanceSensitivity;
             frontDistanceCorrection +=
-                CalculateObstacleDistanceCorrection(obstacleDetectedThreshold, m_sensorReadings["front"]) * avoidanceSensitivity;
+                CalculateObstacleDistanceCorrection(obstacleDetectedThreshold, m_sensorReadings.front) * avoidanceSensitivity;
             backDistanceCorrection +=
-                CalculateObstacleDistanceCorrection(obstacleDetectedThreshold, m_sensorReadings["back"]) * avoidanceSensitivity;
+                CalculateObstacleDistanceCorrection(obstacleDetectedThreshold, m_sensorReadings.back) * avoidanceSensitivity;
         }
 
         // Drone collision avoidance
         if (isOtherDroneDetected) {
-            for (const auto& packet : m_pcRABS->GetReadings()) {
-                const double horizontalAngle = packet.HorizontalBearing.GetValue();
-                // Convert packet range from cm to mm
-                const auto vectorToDrone = packet.Range * 10 * CVector3(std::cos(horizontalAngle), std::sin(horizontalAngle), 0.0);
-                static const double droneAvoidanceSensitivity = 1.0 / 3000.0;
+            for (const auto& neighbour : m_neighbourReadings) {
+                const double horizontalAngle = neighbour.horizontalBearing.GetValue();
+                // Convert neighbour range from cm to mm
+                const auto vectorToDrone = neighbour.range * 10 * CVector3(std::cos(horizontalAngle), std::sin(horizontalAngle), 0.0);
+                static constexpr double droneAvoidanceSensitivity = 1.0 / 3000.0;
                 leftDistanceCorrection += vectorToDrone.GetX() * droneAvoidanceSensitivity;
                 backDistanceCorrection += vectorToDrone.GetY() * droneAvoidanceSensitivity;
             }
@@ -291,9 +368,20 @@ bool CCrazyflieController::AvoidObstaclesAndDrones() {
 
 void CCrazyflieController::Explore() {
     static constexpr std::uint8_t lowBatteryThreshold = 30;
-    if (m_batteryLevel < lowBatteryThreshold) {
+    if (m_returnTrigger == ReturnTrigger::Predictive) {
+        // Return just in time to fly back along the path the drone will take
+        const CVector3& position = m_pcPos->GetReading().Position;
+        const COccupancyGrid::SPosition trailPosition = {static_cast<float>(position.GetX()), static_cast<float>(position.GetY())};
+        const CVector2 vectorToBase(m_initialPosition.GetX() - position.GetX(), m_initialPosition.GetY() - position.GetY());
+        const float returnDistance = m_returnMode == ReturnMode::Breadcrumbs ? m_breadcrumbTrail.GetLength(trailPosition)
+                                                                             : static_cast<float>(vectorToBase.Length());
+        if (m_droneStatus == DroneStatus::Flying && m_batteryEstimator.GetCharge() < m_batteryEstimator.GetReturnCharge(returnDistance)) {
+            m_isReturnChargeReached = true;
+            DebugPrint("Low battery\n");
+        }
+    } else if (m_batteryLevel < lowBatteryThreshold) {
         if (m_lowBatteryIgnoredCounter == 0) {
-            m_isBatteryBelowMinimumThreshold = true;
+            m_isReturnChargeReached = true;
             DebugPrint("Low battery\n");
         } else {
             m_lowBatteryIgnoredCounter--;
@@ -316,9 +404,15 @@ void CCrazyflieController::Explore() {
     case ExploringState::Explore: {
         m_droneStatus = DroneStatus::Flying;
 
-        // Only reorient away from the center of mass when other drones are detected
-        const std::uint8_t activeP2PIdsCount = m_pcRABS->GetReadings().size();
-        if (activeP2PIdsCount > 0) {
+        // Frontier exploration spreads the drones with claimed frontiers instead of reorienting away from the center of mass, and
+        // falls back to bouncing off walls when no frontier is reachable
+        const std::size_t activeP2PIdsCount = m_neighbourReadings.size();
+        if (m_explorationMode == ExplorationMode::Frontier) {
+            if (ExploreFrontier()) {
+                break;
+            }
+        } else if (activeP2PIdsCount > 0) {
+            // Only reorient away from the center of mass when other drones are detected
             if (m_reorientationWatchdog == 0) {
                 m_exploringState = ExploringState::BrakeAway;
                 break;
@@ -364,13 +458,70 @@ void CCrazyflieController::Explore() {
             m_rotationChangeWatchdog--;
             if (m_rotationChangeWatchdog == 0) {
                 m_shouldTurnLeft = !m_shouldTurnLeft;
-                m_rotationChangeWatchdog = GetRandomRotationChangeCount();
+                m_rotationChangeWatchdog = GetRandomRotationChangeCount(m_randomEngine);
             }
         }
     } break;
     }
 }
 
+// Returns false when no frontier can be flown towards
+bool CCrazyflieController::ExploreFrontier() {
+    const CVector3& position = m_pcPos->GetReading().Position;
+    if (m_frontierReplanWatchdog > 0) {
+        m_frontierReplanWatchdog--;
+    } else {
+        m_neighbourClaimedFrontiers.clear();
+        if (m_droneSpatialHash != nullptr && m_claimedFrontiers != nullptr) {
+            for (std::size_t index : m_neighbourIndices) {
+                const ClaimedFrontier& claimedFrontier = (*m_claimedFrontiers)[index];
+                if (claimedFrontier.isClaimed) {
+                    m_neighbourClaimedFrontiers.push_back(claimedFrontier.position);
+                }
+            }
+        }
+
+        const COccupancyGrid::SPosition currentPosition = {static_cast<float>(position.GetX()), static_cast<float>(position.GetY())};
+        m_hasFrontierTarget =
+            m_occupancyGrid.FindNearestFrontier(currentPosition, m_neighbourClaimedFrontiers, frontierClaimRadius, m_frontierTarget);
+        m_frontierReplanWatchdog = frontierReplanTicks;
+    }
+
+    if (!m_hasFrontierTarget) {
+        return false;
+    }
+
+    const CVector2 vectorToFrontier(m_frontierTarget.X - position.GetX(), m_frontierTarget.Y - position.GetY());
+    static constexpr double frontierReachedDistance = 0.3;
+    if (vectorToFrontier.Length() < frontierReachedDistance) {
+        m_hasFrontierTarget = false;
+        m_frontierReplanWatchdog = 0;
+        return false;
+    }
+
+    // Face the frontier before flying towards it, so that the front sensor watches the way
+    CRadians angleRadians;
+    CVector3 angleUnitVector;
+    m_pcPos->GetReading().Orientation.ToAngleAxis(angleRadians, angleUnitVector);
+    const CRadians currentAbsoluteYaw = angleRadians * angleUnitVector.GetZ();
+    const CRadians frontierYaw = vectorToFrontier.Angle() + CRadians::PI / 2; // Add PI / 2 because a zero degree yaw is along negative Y
+    m_pcPropellers->SetAbsoluteYaw(frontierYaw);
+
+    if (std::abs(ToDegrees((frontierYaw - currentAbsoluteYaw).SignedNormalize()).GetValue()) < frontierYawTolerance) {
+        // Bounce off the obstacle like the default exploration until the next search, which will find a way around it
+        if (m_sensorReadings.front <= edgeDetectedThreshold) {
+            m_hasFrontierTarget = false;
+            return false;
+        }
+
+        static constexpr double distanceToTravel = 0.07;
+        const CVector2 step = vectorToFrontier * (distanceToTravel / vectorToFrontier.Length());
+        m_pcPropellers->SetAbsolutePosition(CVector3(position.GetX() + step.GetX(), position.GetY() + step.GetY(), position.GetZ()));
+    }
+
+    return true;
+}
+
 void CCrazyflieController::ReturnToBase() {
     // If returned to base, land
     static constexpr double distanceToReturnEpsilon = 0.3;
@@ -391,9 +542,16 @@ void CCrazyflieController::ReturnToBase() {
         if (Brake()) {
             DebugPrint("Return: Braking towards base finished\n");
 
-            // Calculate rotation angle to turn towards base
-            m_targetYaw = CRadians(std::atan2(m_initialPosition.GetY() - m_pcPos->GetReading().Position.GetY(),
-                                              m_initialPosition.GetX() - m_pcPos->GetReading().Position.GetX())) +
+            // Plan once per leg, the search checks the grid along the path to every breadcrumb
+            const CVector3& position = m_pcPos->GetReading().Position;
+            m_returnWaypoint = {static_cast<float>(m_initialPosition.GetX()), static_cast<float>(m_initialPosition.GetY())};
+            if (m_returnMode == ReturnMode::Breadcrumbs) {
+                m_breadcrumbTrail.GetNextWaypoint(
+                    {static_cast<float>(position.GetX()), static_cast<float>(position.GetY())}, m_occupancyGrid, m_returnWaypoint);
+            }
+
+            // Calculate rotation angle to turn towards the next waypoint
+            m_targetYaw = CRadians(std::atan2(m_returnWaypoint.Y - position.GetY(), m_returnWaypoint.X - position.GetX())) +
                           CRadians::PI / 2; // Add PI / 2 because a zero degree yaw is along negative Y
 
             m_returningState = ReturningState::RotateTowardsBase;
@@ -409,6 +567,16 @@ void CCrazyflieController::ReturnToBase() {
     case ReturningState::Return: {
         m_droneStatus = DroneStatus::Returning;
 
+        // Head to the next breadcrumb once this one is reached, the base is reached when the drone lands
+        static constexpr double waypointReachedDistance = 0.3;
+        const CVector3& position = m_pcPos->GetReading().Position;
+        if (m_returnMode == ReturnMode::Breadcrumbs && m_breadcrumbTrail.GetSize() > 1 &&
+            CVector2(m_returnWaypoint.X - position.GetX(), m_returnWaypoint.Y - position.GetY()).Length() < waypointReachedDistance) {
+            m_returnWatchdog = maximumReturnTicks;
+            m_returningState = ReturningState::BrakeTowardsBase;
+            break;
+        }
+
         // Go to explore algorithm when a wall is detected in front or return watchdog is finished
         if (!Forward() || m_returnWatchdog == 0) {
             if (m_returnWatchdog == 0) {
@@ -443,7 +611,7 @@ void CCrazyflieController::ReturnToBase() {
         m_droneStatus = DroneStatus::Returning;
 
         // Check right sensor when turning left, and left sensor when turning right
-        static float sensorReadingToCheck = m_shouldTurnLeft ? m_sensorReadings["right"] : m_sensorReadings["left"];
+        const float sensorReadingToCheck = m_shouldTurnLeft ? m_sensorReadings.right : m_sensorReadings.left;
 
         // Return to base when obstacle has been passed or explore watchdog is finished
         if ((sensorReadingToCheck > edgeDetectedThreshold + openSpaceThreshold && m_clearObstacleCounter == 0) || m_exploreWatchdog == 0) {
@@ -530,7 +698,7 @@ bool CCrazyflieController::Liftoff() {
 bool CCrazyflieController::Forward() {
     // Change state when a wall is detected in front
     static constexpr double distanceToTravelEpsilon = 0.005;
-    if (m_sensorReadings["front"] <= edgeDetectedThreshold) {
+    if (m_sensorReadings.front <= edgeDetectedThreshold) {
         m_isForwardCommandFinished = true;
         return false;
     }
@@ -592,7 +760,7 @@ bool CCrazyflieController::Rotate() {
 
     // Wait for rotation to finish
     if (std::abs((currentYaw - m_lastReferenceYaw).GetValue()) >= m_rotationAngle.GetValue()) {
-        if (m_sensorReadings["front"] > edgeDetectedThreshold + openSpaceThreshold) {
+        if (m_sensorReadings.front > edgeDetectedThreshold + openSpaceThreshold) {
             m_isRotateCommandFinished = true;
             return true;
         }
@@ -617,7 +785,7 @@ bool CCrazyflieController::RotateToTargetYaw() {
     CRadians currentAbsoluteYaw = angleRadians * angleUnitVector.GetZ();
 
     // If target yaw has been reached, decrease stabilize rotation counter
-    static const CRadians yawEpsilon = CRadians::PI / 64;
+    const CRadians yawEpsilon = CRadians::PI / 64;
     CRadians yawDifference = currentAbsoluteYaw - m_targetYaw;
 
     bool isTargetYawReached = (((yawDifference <= yawEpsilon) && (yawDifference >= -yawEpsilon)) ||
@@ -679,8 +847,9 @@ void CCrazyflieController::ResetInternalStates() {
     m_returningState = ReturningState::BrakeTowardsBase;
     m_emergencyState = EmergencyState::Land;
 
-    m_isBatteryBelowMinimumThreshold = false;
+    m_isReturnChargeReached = false;
     m_lowBatteryIgnoredCounter = initialLowBatteryIgnoredTicks;
+    m_batteryEstimator.Reset();
 
     m_isAvoidingObstacle = false;
     m_exploringStateOnHold = ExploringState::Idle;
@@ -692,7 +861,7 @@ void CCrazyflieController::ResetInternalStates() {
 
     m_isRotateCommandFinished = true;
     m_shouldTurnLeft = true;
-    m_rotationChangeWatchdog = GetRandomRotationChangeCount();
+    m_rotationChangeWatchdog = GetRandomRotationChangeCount(m_randomEngine);
     m_isRotateToTargetYawCommandFinished = true;
     m_stabilizeRotationCounter = stabilizeRotationTicks;
 
@@ -700,10 +869,19 @@ void CCrazyflieController::ResetInternalStates() {
     m_maximumExploreTicks = initialExploreTicks;
     m_exploreWatchdog = initialExploreTicks;
     m_clearObstacleCounter = clearObstacleTicks;
+    m_breadcrumbTrail.Reset({static_cast<float>(m_initialPosition.GetX()), static_cast<float>(m_initialPosition.GetY())});
+
+    // The grid is cleared when it is next used, to avoid clearing it on each standby step
+    m_isOccupancyGridEmpty = true;
+    m_hasFrontierTarget = false;
+    m_frontierReplanWatchdog = 0;
 }
 
 void CCrazyflieController::UpdateBatteryLevel() {
-    m_batteryLevel = static_cast<std::uint8_t>(m_pcBattery->GetReading().AvailableCharge * 100);
+    // Like the battery model, which charges for the distance in 3D
+    const auto distance = static_cast<float>((m_pcPos->GetReading().Position - m_previousPosition).Length());
+    m_batteryEstimator.Update(static_cast<float>(m_pcBattery->GetReading().AvailableCharge), distance);
+    m_batteryLevel = static_cast<std::uint8_t>(std::lround(std::clamp(m_batteryEstimator.GetCharge(), 0.0f, 1.0f) * 100));
 }
 
 void CCrazyflieController::UpdateVelocity() {
@@ -711,8 +889,7 @@ void CCrazyflieController::UpdateVelocity() {
 }
 
 void CCrazyflieController::UpdateSensorReadings() {
-    static const std::array<std::string, 6> sensorDirections = {"front", "left", "back", "right", "up", "down"};
-    m_sensorReadings = GetSensorReadings<float>(sensorDirections);
+    m_sensorReadings = ReadDistanceSensors();
 }
 
 void CCrazyflieController::UpdateRssi() {
@@ -724,7 +901,75 @@ void CCrazyflieController::UpdateRssi() {
     m_rssiReading = static_cast<std::uint8_t>(distanceToBase * distanceToRssiMultiplier);
 }
 
+void CCrazyflieController::UpdateNeighbourReadings() {
+    m_neighbourReadings.clear();
+    if (m_droneSpatialHash == nullptr) {
+        if (m_pcRABS == nullptr) {
+            THROW_ARGOSEXCEPTION("Robot \"" << GetId()
+                                             << "\" needs the range and bearing sensor when the loop functions have no <neighbours> node");
+        }
+        for (const auto& packet : m_pcRABS->GetReadings()) {
+            m_neighbourReadings.push_back({packet.Range, packet.HorizontalBearing});
+        }
+        return;
+    }
+
+    // Convert the neighbours' absolute positions to the range and bearing sensor's frame, relative to the drone's yaw
+    const CVector3& position = m_pcPos->GetReading().Position;
+    CRadians angleRadians;
+    CVector3 angleUnitVector;
+    m_pcPos->GetReading().Orientation.ToAngleAxis(angleRadians, angleUnitVector);
+    const CRadians currentAbsoluteYaw = angleRadians * angleUnitVector.GetZ();
+
+    m_droneSpatialHash->FindInRadius(static_cast<float>(position.GetX()),
+                                     static_cast<float>(position.GetY()),
+                                     m_neighbourRadius,
+                                     m_neighbourIndices,
+                                     m_droneIndex);
+    for (std::size_t index : m_neighbourIndices) {
+        const CSpatialHash::SPoint& neighbourPosition = m_droneSpatialHash->GetPoint(index);
+        const CVector2 vectorToDrone(neighbourPosition.X - position.GetX(), neighbourPosition.Y - position.GetY());
+        // Convert range from m to cm
+        m_neighbourReadings.push_back({vectorToDrone.Length() * 100.0, (vectorToDrone.Angle() - currentAbsoluteYaw).SignedNormalize()});
+    }
+}
+
+void CCrazyflieController::UpdateOccupancyGrid() {
+    const bool isGridUsed = m_explorationMode == ExplorationMode::Frontier || m_returnMode == ReturnMode::Breadcrumbs;
+    if (!isGridUsed || (m_droneStatus != DroneStatus::Flying && m_droneStatus != DroneStatus::Returning)) {
+        return;
+    }
+
+    // Like the drone firmware's grid, centered on the takeoff position
+    if (m_isOccupancyGridEmpty) {
+        static constexpr float halfSide = occupancyGridSide / 2.0f;
+        const auto initialX = static_cast<float>(m_initialPosition.GetX());
+        const auto initialY = static_cast<float>(m_initialPosition.GetY());
+        m_occupancyGrid.Reset(initialX - halfSide, initialY - halfSide, initialX + halfSide, initialY + halfSide, occupancyGridCellSize);
+        m_isOccupancyGridEmpty = false;
+    }
+
+    m_occupancyGrid.AddRangeReadings(GetTelemetrySnapshot());
+    // Changed cells are only used by the loop functions' arena grid
+    m_occupancyGrid.ClearChangedCells();
+}
+
+void CCrazyflieController::UpdateBreadcrumbTrail() {
+    // Like the drone firmware, the trail is only recorded while exploring, the return removes the breadcrumbs it flies past instead
+    if (m_returnMode != ReturnMode::Breadcrumbs || m_droneStatus != DroneStatus::Flying) {
+        return;
+    }
+
+    const CVector3& position = m_pcPos->GetReading().Position;
+    m_breadcrumbTrail.Add({static_cast<float>(position.GetX()), static_cast<float>(position.GetY())}, m_occupancyGrid);
+}
+
 void CCrazyflieController::PingOtherDrones() {
+    // Neighbours found in the spatial hash need no packets, which would only keep the range and bearing medium busy
+    if (m_droneSpatialHash != nullptr || m_pcRABA == nullptr) {
+        return;
+    }
+
     static constexpr std::uint8_t pingData = 0;
     m_pcRABA->SetData(sizeof(pingData), pingData);
 }
@@ -742,17 +987,17 @@ CRadians CCrazyflieController::CalculateAngleAwayFromCenterOfMass() {
     CVector2 centerOfMass = currentPosition;
 
     // Sum of other drones' received positions
-    for (const auto& packet : m_pcRABS->GetReadings()) {
-        const double horizontalAngle = packet.HorizontalBearing.GetValue() + currentYawAdjustment.GetValue();
-        // Convert packet range from cm to m
-        const auto vectorToDrone = packet.Range * 0.01 * CVector2(std::cos(horizontalAngle), std::sin(horizontalAngle));
+    for (const auto& neighbour : m_neighbourReadings) {
+        const double horizontalAngle = neighbour.horizontalBearing.GetValue() + currentYawAdjustment.GetValue();
+        // Convert neighbour range from cm to m
+        const auto vectorToDrone = neighbour.range * 0.01 * CVector2(std::cos(horizontalAngle), std::sin(horizontalAngle));
 
         CVector2 otherDronePosition =
             CVector2(currentPosition.GetX() - vectorToDrone.GetY(), currentPosition.GetY() + vectorToDrone.GetX());
         centerOfMass = CVector2(centerOfMass.GetX() + otherDronePosition.GetX(), centerOfMass.GetY() + otherDronePosition.GetY());
     }
 
-    const std::uint8_t activeP2PIdsCount = m_pcRABS->GetReadings().size();
+    const std::size_t activeP2PIdsCount = m_neighbourReadings.size();
     centerOfMass = CVector2(centerOfMass.GetX() / (activeP2PIdsCount + 1), centerOfMass.GetY() / (activeP2PIdsCount + 1));
     const auto vectorAway = CVector2(currentPosition.GetX() - centerOfMass.GetX(), currentPosition.GetY() - centerOfMass.GetY());
 
@@ -765,13 +1010,16 @@ void CCrazyflieController::DebugPrint(const std::string& text) {
     m_debugPrint += text;
 }
 
-template<typename T, typename U = T>
-std::unordered_map<std::string, U> CCrazyflieController::GetSensorReadings(const std::array<std::string, 6>& sensorNames) const {
-    std::unordered_map<std::string, U> sensorReadings;
-    CCI_CrazyflieDistanceScannerSensor::TReadingsMap distanceReadings = m_pcDistance->GetReadingsMap();
-    for (auto it = distanceReadings.begin(); it != distanceReadings.end(); ++it) {
-        std::size_t index = std::distance(distanceReadings.begin(), it);
-        Real rangeData = it->second;
+SensorReadings CCrazyflieController::ReadDistanceSensors() const {
+    // The distance scanner readings are ordered front, left, back and right
+    std::array<float, 4> distanceReadings = {obstacleTooFar, obstacleTooFar, obstacleTooFar, obstacleTooFar};
+    std::size_t index = 0;
+    for (const auto& [angle, reading] : m_pcDistance->GetReadingsMap()) {
+        if (index == distanceReadings.size()) {
+            break;
+        }
+
+        Real rangeData = reading;
         static constexpr std::int8_t sensorSaturated = -1;
         static constexpr std::int8_t sensorEmpty = -2;
         if (rangeData == sensorSaturated) {
@@ -782,21 +1030,15 @@ std::unordered_map<std::string, U> CCrazyflieController::GetSensorReadings(const
             rangeData *= 10; // Convert cm to mm to reflect multiranger deck
         }
 
-        sensorReadings.emplace(sensorNames[index], static_cast<T>(rangeData));
+        distanceReadings[index] = static_cast<float>(rangeData);
+        index++;
     }
 
-    // Future work: Write sensor to get range.up value
-    sensorReadings.emplace(sensorNames[4], static_cast<T>(obstacleTooFar));
-    // Future work: Write sensor to get range.zrange value
-    sensorReadings.emplace(sensorNames[5], static_cast<T>(m_pcPos->GetReading().Position.GetZ() * meterToMillimeterFactor));
+    // Future work: Write sensors to get range.up and range.zrange values
+    const float upReading = obstacleTooFar;
+    const float downReading = static_cast<float>(m_pcPos->GetReading().Position.GetZ() * meterToMillimeterFactor);
 
-    return sensorReadings;
+    return {distanceReadings[0], distanceReadings[1], distanceReadings[2], distanceReadings[3], upReading, downReading};
 }
 
-template std::unordered_map<std::string, float> CCrazyflieController::GetSensorReadings<float>(
-    const std::array<std::string, 6>& sensorNames) const;
-
-template CCrazyflieController::LogVariableMap CCrazyflieController::GetSensorReadings<std::uint16_t>(
-    const std::array<std::string, 6>& sensorNames) const;
-
 REGISTER_CONTROLLER(CCrazyflieController, "crazyflie_controller")
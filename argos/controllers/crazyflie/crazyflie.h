@@ -1,9 +1,7 @@
 #ifndef CRAZYFLIE_H
 #define CRAZYFLIE_H
 
-#include <unordered_map>
-#include <utility>
-#include <variant>
+#include <random>
 #include <string>
 #include <argos3/core/control_interface/ci_controller.h>
 #include <argos3/plugins/robots/crazyflie/control_interface/ci_crazyflie_distance_scanner_sensor.h>
@@ -13,7 +11,12 @@
 #include <argos3/plugins/robots/generic/control_interface/ci_range_and_bearing_sensor.h>
 #include <argos3/plugins/robots/generic/control_interface/ci_battery_sensor.h>
 #include "libs/json.hpp"
+#include "utils/battery_estimator.h"
+#include "utils/breadcrumb_trail.h"
 #include "utils/log_name.h"
+#include "utils/occupancy_grid.h"
+#include "utils/spatial_hash.h"
+#include "utils/telemetry_snapshot.h"
 
 using namespace argos;
 using json = nlohmann::json;
@@ -52,6 +55,21 @@ enum class EmergencyState {
     Idle,
 };
 
+enum class ExplorationMode {
+    WallBounce,
+    Frontier,
+};
+
+enum class ReturnMode {
+    Beeline,
+    Breadcrumbs,
+};
+
+enum class ReturnTrigger {
+    Threshold,
+    Predictive,
+};
+
 enum class DroneStatus {
     Standby,
     Liftoff,
@@ -62,24 +80,50 @@ enum class DroneStatus {
     Crashed,
 };
 
+// Distance readings in millimeters, like the multiranger deck
+struct SensorReadings {
+    float front;
+    float left;
+    float back;
+    float right;
+    float up;
+    float down;
+};
+
+// Other drone in communication range, in the same units and frame as the range and bearing sensor
+struct NeighbourReading {
+    Real range; // In centimeters
+    CRadians horizontalBearing;
+};
+
+// Frontier a drone is flying towards in frontier exploration, in the arena's frame
+struct ClaimedFrontier {
+    bool isClaimed;
+    COccupancyGrid::SPosition position;
+};
+
 class CCrazyflieController : public CCI_Controller {
 public:
-    // Use vector of pairs to preserve insertion order (required to receive orientation and position data before range data for mapping)
-    using LogVariableMap = std::unordered_map<std::string, std::variant<std::uint8_t, std::uint16_t, float>>;
-    using LogConfigs = std::vector<std::pair<LogName, LogVariableMap>>;
-
     virtual void Init(TConfigurationNode& t_node) override;
     virtual void ControlStep() override;
     virtual void Reset() override;
     virtual void Destroy() override;
 
-    LogConfigs GetLogData() const;
+    TelemetrySnapshot GetTelemetrySnapshot() const;
     const std::string& GetDebugPrint() const;
     void SetParamData(const std::string& param, json value);
+    // Neighbours are found in the spatial hash, rebuilt by the loop functions before each step, instead of the range and bearing
+    // readings. The hash must outlive the controller or be unset with nullptr
+    void SetDroneSpatialHash(const CSpatialHash* droneSpatialHash, std::size_t droneIndex, float neighbourRadius);
+    ClaimedFrontier GetClaimedFrontier() const;
+    // Frontiers claimed by every drone, indexed like the spatial hash's points and updated by the loop functions before each step.
+    // Neighbours' claims are only known when a spatial hash is set
+    void SetClaimedFrontiers(const std::vector<ClaimedFrontier>* claimedFrontiers);
 
 private:
     bool AvoidObstaclesAndDrones();
     void Explore();
+    bool ExploreFrontier();
     void ReturnToBase();
     void EmergencyLand();
     bool Liftoff();
@@ -96,6 +140,9 @@ private:
     void UpdateVelocity();
     void UpdateSensorReadings();
     void UpdateRssi();
+    void UpdateNeighbourReadings();
+    void UpdateOccupancyGrid();
+    void UpdateBreadcrumbTrail();
 
     void PingOtherDrones();
 
@@ -103,8 +150,7 @@ private:
 
     void DebugPrint(const std::string& text);
 
-    template<typename T, typename U = T>
-    std::unordered_map<std::string, U> GetSensorReadings(const std::array<std::string, 6>& sensorNames) const;
+    SensorReadings ReadDistanceSensors() const;
 
     // Sensors and actuators
     CCI_CrazyflieDistanceScannerSensor* m_pcDistance = nullptr;
@@ -124,15 +170,29 @@ private:
     CVector3 m_initialPosition;
     CVector3 m_previousPosition;
     std::uint8_t m_batteryLevel;
-    bool m_isBatteryBelowMinimumThreshold = false;
+    bool m_isReturnChargeReached = false;
     bool m_isOutOfService = false;
     DroneStatus m_droneStatus = DroneStatus::Standby;
     std::string m_debugPrint;
+    std::default_random_engine m_randomEngine; // Per-drone stream, never shared between controllers
+    bool m_shouldStartExploring = false;
+    ExplorationMode m_explorationMode = ExplorationMode::WallBounce;
+    ReturnMode m_returnMode = ReturnMode::Breadcrumbs;
+    ReturnTrigger m_returnTrigger = ReturnTrigger::Predictive;
+    CBatteryEstimator m_batteryEstimator;
 
     // Readings
     CVector3 m_velocityReading;
-    std::unordered_map<std::string, float> m_sensorReadings;
+    SensorReadings m_sensorReadings = {};
     std::uint8_t m_rssiReading = 0;
+    std::vector<NeighbourReading> m_neighbourReadings;
+
+    // Neighbour search, the range and bearing sensor is used when no spatial hash is set
+    const CSpatialHash* m_droneSpatialHash = nullptr;
+    std::size_t m_droneIndex = 0;
+    float m_neighbourRadius = 0.0f; // In meters
+    std::vector<std::size_t> m_neighbourIndices;
+    const std::vector<ClaimedFrontier>* m_claimedFrontiers = nullptr;
 
     // Obstacle avoidance variables
     bool m_isAvoidingObstacle = false;
@@ -150,6 +210,14 @@ private:
     std::uint8_t m_lowBatteryIgnoredCounter; // To protect from low voltage spikes triggering return
     std::uint16_t m_reorientationWatchdog; // To reorient away from the swarm's center of mass
 
+    // Frontier exploration and return path variables, the grid is only allocated when it is first used
+    COccupancyGrid m_occupancyGrid;
+    bool m_isOccupancyGridEmpty = true;
+    bool m_hasFrontierTarget = false;
+    COccupancyGrid::SPosition m_frontierTarget = {};
+    std::uint16_t m_frontierReplanWatchdog = 0; // To search for a new frontier as the map grows
+    std::vector<COccupancyGrid::SPosition> m_neighbourClaimedFrontiers;
+
     // Braking variables
     bool m_isBrakeCommandFinished = true;
     CVector3 m_brakingReferencePosition;
@@ -169,6 +237,8 @@ private:
     std::uint64_t m_maximumExploreTicks;
     std::uint64_t m_exploreWatchdog; // Prevent staying stuck in forward state by attempting to beeline periodically
     std::uint16_t m_clearObstacleCounter; // Ensure obstacles are sufficiently cleared before resuming
+    CBreadcrumbTrail m_breadcrumbTrail;
+    COccupancyGrid::SPosition m_returnWaypoint = {};
 
     // Crash detection variables
     CVector3 m_lastActivePosition;
@@ -0,0 +1,70 @@
+#include "coverage_grid.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+
+namespace {
+    // Must match the sensor threshold of the server's map generator
+    constexpr float sensorThreshold = 2000.0f;
+    constexpr float millimeterToMeterFactor = 0.001f;
+    constexpr float degreesToRadiansFactor = static_cast<float>(M_PI / 180.0);
+} // namespace
+
+void CCoverageGrid::Reset(float minX, float minY, float maxX, float maxY, float cellSize) {
+    m_minX = minX;
+    m_minY = minY;
+    m_cellSize = cellSize;
+    m_width = static_cast<std::size_t>(std::ceil((maxX - minX) / cellSize));
+    m_height = static_cast<std::size_t>(std::ceil((maxY - minY) / cellSize));
+    m_observedCells.assign(m_width * m_height, 0);
+    m_observedCellCount = 0;
+}
+
+void CCoverageGrid::AddRangeReadings(const TelemetrySnapshot& snapshot) {
+    // Angle of each horizontal sensor relative to the drone's yaw
+    const std::array<std::pair<std::uint16_t, float>, 4> readings = {{
+        {snapshot.rangeFront, 0.0f},
+        {snapshot.rangeLeft, 90.0f},
+        {snapshot.rangeBack, 180.0f},
+        {snapshot.rangeRight, -90.0f},
+    }};
+
+    for (const auto& [reading, angleOffset] : readings) {
+        // Readings above the threshold are not plotted by the server, but the space up to the threshold is still free
+        const float distance = std::min(static_cast<float>(reading), sensorThreshold) * millimeterToMeterFactor;
+        MarkRay(snapshot.x, snapshot.y, (snapshot.yaw + angleOffset) * degreesToRadiansFactor, distance);
+    }
+}
+
+double CCoverageGrid::GetCoverage() const {
+    if (m_observedCells.empty()) {
+        return 0.0;
+    }
+    return static_cast<double>(m_observedCellCount) / m_observedCells.size();
+}
+
+void CCoverageGrid::MarkRay(float originX, float originY, float angle, float distance) {
+    // Step by half a cell to visit every cell crossed by the ray
+    const float step = m_cellSize / 2.0f;
+    const float directionX = std::cos(angle);
+    const float directionY = std::sin(angle);
+    for (float travelled = 0.0f; travelled < distance; travelled += step) {
+        MarkCell(originX + directionX * travelled, originY + directionY * travelled);
+    }
+    MarkCell(originX + directionX * distance, originY + directionY * distance);
+}
+
+void CCoverageGrid::MarkCell(float x, float y) {
+    const float column = std::floor((x - m_minX) / m_cellSize);
+    const float row = std::floor((y - m_minY) / m_cellSize);
+    if (column < 0.0f || row < 0.0f || column >= m_width || row >= m_height) {
+        return;
+    }
+
+    std::uint8_t& cell = m_observedCells[static_cast<std::size_t>(row) * m_width + static_cast<std::size_t>(column)];
+    if (cell == 0) {
+        cell = 1;
+        m_observedCellCount++;
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef COVERAGE_GRID_H
+#define COVERAGE_GRID_H
+
+#include <cstdint>
+#include <vector>
+#include "utils/telemetry_snapshot.h"
+
+// Tracks which cells of the arena's floor have been observed by the drones' horizontal range sensors, the same way the server
+// builds its map from the range log group. Used to measure exploration without the server
+class CCoverageGrid {
+public:
+    // The grid covers the rectangle from (minX, minY) to (maxX, maxY), in meters
+    void Reset(float minX, float minY, float maxX, float maxY, float cellSize);
+    void AddRangeReadings(const TelemetrySnapshot& snapshot);
+
+    // Fraction of the cells which have been observed, between 0 and 1
+    double GetCoverage() const;
+
+private:
+    void MarkRay(float originX, float originY, float angle, float distance);
+    void MarkCell(float x, float y);
+
+    float m_minX = 0.0f;
+    float m_minY = 0.0f;
+    float m_cellSize = 1.0f;
+    std::size_t m_width = 0;
+    std::size_t m_height = 0;
+    std::vector<std::uint8_t> m_observedCells;
+    std::size_t m_observedCellCount = 0;
+};
+
+#endif
@@ -1,10 +1,14 @@
 #include "hivexplore_loop_functions.h"
+#include <cmath>
+#include <filesystem>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <unistd.h>
 #include <argos3/plugins/robots/crazyflie/simulator/crazyflie_entity.h>
 #include "libs/json.hpp"
 #include "utils/constants.h"
+#include "utils/param_name.h"
+#include "utils/socket_message.h"
 
 using json = nlohmann::json;
 
@@ -13,48 +17,198 @@ namespace {
 } // namespace
 
 void CHivexploreLoopFunctions::Init(TConfigurationNode& t_tree) {
+    // Telemetry format used for log data sent to the server, JSON is kept as the default for compatibility
+    if (NodeExists(t_tree, "telemetry")) {
+        TConfigurationNode& telemetryNode = GetNode(t_tree, "telemetry");
+
+        std::string format;
+        GetNodeAttributeOrDefault(telemetryNode, "format", format, std::string("json"));
+        if (!telemetryFormatFromString(format, m_telemetryFormat)) {
+            THROW_ARGOSEXCEPTION("Unknown telemetry format: \"" << format << "\", expected \"json\" or \"binary\"");
+        }
+
+        // Rate of each log group, groups which are not listed are sent once per second
+        TConfigurationNodeIterator groupIt("group");
+        for (groupIt = groupIt.begin(&telemetryNode); groupIt != groupIt.end(); ++groupIt) {
+            std::string name;
+            GetNodeAttribute(*groupIt, "name", name);
+            LogName logName;
+            if (!logNameFromString(name, logName) || telemetryGroupBit(logName) == 0) {
+                THROW_ARGOSEXCEPTION("Unknown telemetry group: \"" << name << '"');
+            }
+
+            // Groups sent on change are checked every tick unless a frequency is given
+            bool isSentOnChange;
+            GetNodeAttributeOrDefault(*groupIt, "on_change", isSentOnChange, false);
+            double frequency;
+            GetNodeAttributeOrDefault(*groupIt, "frequency", frequency, isSentOnChange ? Constants::ticksPerSecond : 1.0);
+            if (frequency <= 0.0 || frequency > Constants::ticksPerSecond) {
+                THROW_ARGOSEXCEPTION("Invalid frequency for telemetry group \"" << name << "\": " << frequency
+                                                                                 << " Hz, expected a value in ]0, "
+                                                                                 << static_cast<int>(Constants::ticksPerSecond) << "]");
+            }
+
+            m_telemetrySchedule.SetGroupPeriod(logName, static_cast<std::uint32_t>(std::lround(Constants::ticksPerSecond / frequency)));
+            m_telemetrySchedule.SetGroupSentOnChange(logName, isSentOnChange);
+        }
+    }
+
+    // Neighbour searches in a spatial hash of the drones' positions instead of the range and bearing sensor, which does not scale with
+    // the swarm's size
+    if (NodeExists(t_tree, "neighbours")) {
+        TConfigurationNode& neighboursNode = GetNode(t_tree, "neighbours");
+        m_isSpatialHashEnabled = true;
+        GetNodeAttributeOrDefault(neighboursNode, "radius", m_neighbourRadius, 3.0f);
+        if (m_neighbourRadius <= 0.0f) {
+            THROW_ARGOSEXCEPTION("Invalid neighbour radius: " << m_neighbourRadius << " m");
+        }
+        // Searches then cover at most 3 x 3 cells
+        m_droneSpatialHash.SetCellSize(m_neighbourRadius);
+    }
+
+    // Map the arena from the drones' range sensors in the simulation instead of the server
+    if (NodeExists(t_tree, "mapping")) {
+        TConfigurationNode& mappingNode = GetNode(t_tree, "mapping");
+        m_isMappingEnabled = true;
+        GetNodeAttributeOrDefault(mappingNode, "cell_size", m_mapCellSize, 0.05f);
+        if (m_mapCellSize <= 0.0f) {
+            THROW_ARGOSEXCEPTION("Invalid mapping cell size: " << m_mapCellSize << " m");
+        }
+    }
+
+    // Headless mode runs the mission without the server and stops once the coverage or time target is reached
+    if (NodeExists(t_tree, "headless")) {
+        TConfigurationNode& headlessNode = GetNode(t_tree, "headless");
+        m_isHeadless = true;
+        GetNodeAttribute(headlessNode, "output", m_metricsPath);
+        GetNodeAttributeOrDefault(headlessNode, "coverage_target", m_coverageTarget, 1.0);
+        GetNodeAttributeOrDefault(headlessNode, "time_limit", m_timeLimit, 0.0);
+        GetNodeAttributeOrDefault(headlessNode, "cell_size", m_coverageCellSize, 0.1f);
+        GetNodeAttributeOrDefault(headlessNode, "return_time", m_returnTime, 0.0);
+        if (m_coverageCellSize <= 0.0f) {
+            THROW_ARGOSEXCEPTION("Invalid headless coverage cell size: " << m_coverageCellSize << " m");
+        }
+    }
+
     Reset();
 }
 
 void CHivexploreLoopFunctions::Reset() {
     m_isExperimentFinished = false;
-    StartSocket();
-    SendDroneIdsToServer();
+    RefreshControllers();
+    if (m_isMappingEnabled) {
+        ResetMap();
+    }
+    if (m_isHeadless) {
+        ResetHeadlessMode();
+        return;
+    }
+
+    m_packetBatch.Clear();
+    m_lastReportedDroppedPacketCount = m_packetBatch.GetStatistics().DroppedPacketCount;
+    m_telemetrySchedule.Reset(m_controllers.GetSize());
+
+    // The socket stays open across resets, the server connects whenever it is ready
+    if (!m_socketServer.IsOpen()) {
+        m_socketServer.Open(socketPath);
+    }
+    if (m_socketServer.IsConnected()) {
+        SendDroneIdsToServer();
+        FlushPackets();
+    }
 }
 
 void CHivexploreLoopFunctions::Destroy() {
-    // Close socket
-    if (close(m_connectionSocket) == -1 && errno != EBADF) {
-        std::perror("Unix connection socket close");
+    m_socketServer.Close();
+}
+
+void CHivexploreLoopFunctions::PreStep() {
+    // Controllers search the hash during their step, which ARGoS may run in parallel, so it is only written here
+    if (m_isSpatialHashEnabled) {
+        UpdateDroneSpatialHash();
+    }
+
+    if (m_isHeadless) {
+        return;
+    }
+
+    // Accept the server's connection without blocking, the simulation keeps running while no server is connected
+    TelemetryGroupMask forcedGroups = 0;
+    if (m_socketServer.PollConnection()) {
+        // Replay the drone IDs and the latest log data of every group, since the new peer knows nothing about the swarm
+        m_packetBatch.Clear();
+        m_telemetrySchedule.Reset(m_controllers.GetSize());
+        SendDroneIdsToServer();
+        forcedGroups = allTelemetryGroups;
+        if (m_isMappingEnabled) {
+            m_occupancyGrid.MarkKnownCellsChanged();
+        }
     }
-    if (close(m_dataSocket) == -1 && errno != EBADF) {
-        std::perror("Unix connection socket close");
+    if (!m_socketServer.IsConnected()) {
+        return;
     }
-    if (unlink(socketPath) == -1 && errno != ENOENT) {
-        std::perror("Unix socket unlink");
+
+    ReceiveParamData();
+    if (!m_socketServer.IsConnected()) {
+        return;
     }
+
+    // Send the log groups which are due from each Crazyflie
+    SendLogData(forcedGroups);
+    if (m_isMappingEnabled) {
+        SendMapData();
+    }
+
+    // Flush every tick to drain the backlog left by a slow server as soon as possible
+    FlushPackets();
 }
 
-void CHivexploreLoopFunctions::PreStep() {
-    // Get list of Crazyflie controllers
-    std::vector<std::reference_wrapper<CCrazyflieController>> controllers = GetControllers();
+void CHivexploreLoopFunctions::PostStep() {
+    // Keep mapping while no server is connected, the changed cells are sent once it connects
+    if (m_isMappingEnabled) {
+        UpdateMap();
+    }
+
+    if (m_isHeadless) {
+        UpdateHeadlessMode();
+    }
+}
+
+bool CHivexploreLoopFunctions::IsExperimentFinished() {
+    return m_isExperimentFinished;
+}
+
+void CHivexploreLoopFunctions::PostExperiment() {
+    if (m_isHeadless) {
+        LOG << "Headless experiment finished after " << GetSpace().GetSimulationClock() * Constants::secondsPerTick << " s: "
+            << m_coverageGrid.GetCoverage() * 100.0 << "% coverage, " << m_collisionCount << " collisions\n";
+        m_metricsFile.close();
+        return;
+    }
+
+    const CPacketBatch::SStatistics& statistics = m_packetBatch.GetStatistics();
+    LOG << "Unix socket statistics: " << statistics.SentPacketCount << " packets (" << statistics.SentByteCount << " bytes) sent, "
+        << statistics.BackpressureCount << " backpressure events, " << statistics.DroppedPacketCount << " packets dropped\n";
+}
+
+void CHivexploreLoopFunctions::ReceiveParamData() {
+    const std::string missionStateParam = "hivexplore." + paramNameToString(ParamName::MissionState);
+    bool isExplorationStarted = false;
 
     // Receive param data from server
     while (true) {
-        static char buffer[4096] = {};
-        std::fill(std::begin(buffer), std::end(buffer), '\0');
-        ssize_t count = recv(m_dataSocket, buffer, sizeof(buffer), MSG_DONTWAIT);
+        ssize_t count = receiveSocketMessage(m_socketServer.GetDataSocket(), m_receiveBuffer);
 
-        // Restart simulation if server disconnects
+        // Wait for a new connection if server disconnects
         if (count == 0) {
             LOGERR << "Unix socket connection closed\n";
-            Stop();
+            DisconnectFromServer();
             return;
         } else if (count == -1) {
-            // Restart simulation in case of socket error
+            // Wait for a new connection in case of socket error
             if (errno != EAGAIN && errno != EWOULDBLOCK) {
                 std::perror("Unix socket recv");
-                Stop();
+                DisconnectFromServer();
                 return;
             }
             // Loop until there is no more data to receive
@@ -62,14 +216,15 @@ void CHivexploreLoopFunctions::PreStep() {
         }
 
         try {
-            json packet = json::parse(buffer);
-
-            std::string droneId = packet["droneId"];
-            auto it = std::find_if(controllers.begin(), controllers.end(), [&droneId](const auto& controller) {
-                return controller.get().GetId() == droneId;
-            });
-            if (it != controllers.end()) {
-                it->get().SetParamData(packet["paramName"], packet["value"]);
+            // Parse the message in place, the buffer is reused and not null-terminated
+            json packet = json::parse(m_receiveBuffer.begin(), m_receiveBuffer.begin() + count);
+
+            const std::string& droneId = packet["droneId"].get_ref<const std::string&>();
+            CCrazyflieController* controller = m_controllers.Find(droneId);
+            if (controller != nullptr) {
+                isExplorationStarted = isExplorationStarted || (packet["paramName"] == missionStateParam &&
+                                                                packet["value"] == static_cast<std::uint8_t>(MissionState::Exploring));
+                controller->SetParamData(packet["paramName"], packet["value"]);
             } else {
                 LOGERR << "Unknown drone ID: " << droneId << '\n';
             }
@@ -79,148 +234,322 @@ void CHivexploreLoopFunctions::PreStep() {
         }
     }
 
-    // Send log data to server from each Crazyflie every second
-    if (GetSpace().GetSimulationClock() % Constants::ticksPerSecond == 0) {
-        for (const auto& controller : controllers) {
-            auto logData = controller.get().GetLogData();
-            for (const auto& [logName, variables] : logData) {
-                json variablesJson;
-                for (const auto& [key, variant] : variables) {
-                    std::visit([&key = std::as_const(key), &variablesJson](const auto& value) { variablesJson.emplace(key, value); },
-                               variant);
-                }
+    // The server clears its map when a mission starts
+    if (isExplorationStarted && m_isMappingEnabled) {
+        ResetMap();
+    }
+}
+
+void CHivexploreLoopFunctions::SendLogData(TelemetryGroupMask forcedGroups) {
+    const std::uint64_t tick = GetSpace().GetSimulationClock();
+    const std::vector<std::reference_wrapper<CCrazyflieController>>& controllers = m_controllers.GetItems();
+
+    // Pack every drone's log data in records containing only its due groups, the drone index matches the order of the drone
+    // IDs packet
+    if (m_telemetryFormat == TelemetryFormat::Binary) {
+        m_telemetryFrameWriter.Clear(static_cast<std::uint32_t>(tick));
+    }
 
-                if (!Send(logName, controller.get().GetId(), variablesJson)) {
-                    return;
+    for (std::size_t i = 0; i < controllers.size(); i++) {
+        const CCrazyflieController& controller = controllers[i].get();
+        const TelemetrySnapshot snapshot = controller.GetTelemetrySnapshot();
+        const TelemetryGroupMask groupMask = m_telemetrySchedule.Update(i, tick, snapshot, forcedGroups);
+
+        if (groupMask != 0 && m_telemetryFormat == TelemetryFormat::Binary) {
+            m_telemetryFrameWriter.Append(static_cast<std::uint16_t>(i), snapshot, groupMask);
+        } else if (m_telemetryFormat == TelemetryFormat::Json) {
+            for (LogName logName : telemetryLogNames) {
+                if (groupMask & telemetryGroupBit(logName)) {
+                    Send(logName, controller.GetId(), telemetryGroupToJson(snapshot, logName));
                 }
             }
+        }
 
-            // Send console log data if it has been flushed (with '\n') in the previous step
-            std::string debugPrint = controller.get().GetDebugPrint();
+        // Send console log data every second if it has been flushed (with '\n') in the previous step
+        if (tick % Constants::ticksPerSecond == 0) {
+            std::string debugPrint = controller.GetDebugPrint();
             if (debugPrint.find('\n') != std::string::npos) {
-                if (!Send(LogName::Console, controller.get().GetId(), debugPrint)) {
-                    return;
-                }
+                Send(LogName::Console, controller.GetId(), debugPrint);
             }
         }
     }
-}
 
-void CHivexploreLoopFunctions::PostStep() {
-}
-
-bool CHivexploreLoopFunctions::IsExperimentFinished() {
-    return m_isExperimentFinished;
+    if (m_telemetryFormat == TelemetryFormat::Binary) {
+        for (const auto& [frameOffset, frameSize] : m_telemetryFrameWriter.GetFrames()) {
+            Send(m_telemetryFrameWriter.GetBuffer() + frameOffset, frameSize);
+        }
+    }
 }
 
-void CHivexploreLoopFunctions::PostExperiment() {
-    // Close socket
-    if (close(m_connectionSocket) == -1) {
-        std::perror("Unix connection socket close");
+void CHivexploreLoopFunctions::SendMapData() {
+    const std::vector<std::size_t>& changedCells = m_occupancyGrid.GetChangedCells();
+    if (changedCells.empty()) {
+        return;
     }
-    if (close(m_dataSocket) == -1) {
-        std::perror("Unix connection socket close");
+
+    m_mapFrameWriter.Clear(m_occupancyGrid.GetCellSize(), m_occupancyGrid.GetMinX(), m_occupancyGrid.GetMinY());
+    for (std::size_t index : changedCells) {
+        m_mapFrameWriter.Append(m_occupancyGrid.GetColumn(index),
+                                m_occupancyGrid.GetRow(index),
+                                m_occupancyGrid.GetCellState(index),
+                                m_occupancyGrid.GetCellHeight(index));
     }
-    if (unlink(socketPath) == -1) {
-        std::perror("Unix socket unlink");
+    m_occupancyGrid.ClearChangedCells();
+
+    for (const auto& [frameOffset, frameSize] : m_mapFrameWriter.GetFrames()) {
+        Send(m_mapFrameWriter.GetBuffer() + frameOffset, frameSize);
     }
 }
 
-void CHivexploreLoopFunctions::StartSocket() {
-    // Remove socket if it already exists
-    if (unlink(socketPath) == -1 && errno != ENOENT) {
-        std::perror("Unix socket unlink");
-        std::exit(EXIT_FAILURE);
+void CHivexploreLoopFunctions::Send(LogName logName, const json& droneId, const json& variables) {
+    std::string serializedPacket = serializeJsonPacket(logName, droneId, variables);
+    Send(serializedPacket.c_str(), serializedPacket.size());
+}
+
+void CHivexploreLoopFunctions::Send(const void* data, std::size_t size) {
+    // Packets are only queued here, they are sent together once per tick by FlushPackets
+    m_packetBatch.Add(data, size);
+}
+
+bool CHivexploreLoopFunctions::FlushPackets() {
+    if (!m_packetBatch.Flush(m_socketServer.GetDataSocket())) {
+        // Wait for a new connection in case of socket error
+        DisconnectFromServer();
+        return false;
     }
 
-    // Create Unix domain socket
-    m_connectionSocket = socket(AF_UNIX, SOCK_SEQPACKET, 0);
-    if (m_connectionSocket == -1) {
-        std::perror("Unix socket creation");
-        std::exit(EXIT_FAILURE);
+    // Report dropped packets at most once per second to avoid flooding the log while the server is slow
+    const std::uint64_t droppedPacketCount = m_packetBatch.GetStatistics().DroppedPacketCount;
+    if (droppedPacketCount != m_lastReportedDroppedPacketCount && GetSpace().GetSimulationClock() % Constants::ticksPerSecond == 0) {
+        LOGERR << "Unix socket backlog full, dropped " << droppedPacketCount - m_lastReportedDroppedPacketCount << " packets\n";
+        m_lastReportedDroppedPacketCount = droppedPacketCount;
     }
 
-    // Bind socket to socket name
-    std::memset(&m_socketName, 0, sizeof(m_socketName));
-    m_socketName.sun_family = AF_UNIX;
-    std::strncpy(m_socketName.sun_path, socketPath, sizeof(m_socketName.sun_path));
+    return true;
+}
+
+void CHivexploreLoopFunctions::DisconnectFromServer() {
+    // Packets queued for the previous peer are stale, the new peer receives the latest state once connected
+    m_socketServer.Disconnect();
+    m_packetBatch.Clear();
+    LOG << "Waiting for the server to reconnect, the simulation keeps running\n";
+}
+
+void CHivexploreLoopFunctions::SendDroneIdsToServer() {
+    const std::vector<std::reference_wrapper<CCrazyflieController>>& controllers = m_controllers.GetItems();
+    std::vector<std::string> droneIds;
+
+    std::transform(controllers.begin(), controllers.end(), std::back_inserter(droneIds), [](const auto& controller) {
+        return controller.get().GetId();
+    });
+
+    Send(LogName::DroneIds, nullptr, droneIds);
+}
 
-    int ret = bind(m_connectionSocket, reinterpret_cast<const struct sockaddr*>(&m_socketName), sizeof(m_socketName));
-    if (ret == -1) {
-        std::perror("Unix socket bind");
-        std::exit(EXIT_FAILURE);
+void CHivexploreLoopFunctions::RefreshControllers() {
+    // Entities are only added or removed when the experiment is initialized or reset, so the registry is built once instead of every
+    // tick
+    m_controllers.Clear();
+    m_droneBodies.clear();
+    m_droneBatteries.clear();
+    for (const auto& [id, entity] : GetSpace().GetEntitiesByType("crazyflie")) {
+        CCrazyflieEntity& crazyflie = *any_cast<CCrazyflieEntity*>(entity);
+        CCrazyflieController& controller = dynamic_cast<CCrazyflieController&>(crazyflie.GetControllableEntity().GetController());
+        controller.SetDroneSpatialHash(m_isSpatialHashEnabled ? &m_droneSpatialHash : nullptr, m_droneBodies.size(), m_neighbourRadius);
+        controller.SetClaimedFrontiers(m_isSpatialHashEnabled ? &m_claimedFrontiers : nullptr);
+        m_controllers.Add(controller.GetId(), controller);
+        m_droneBodies.push_back(&crazyflie.GetEmbodiedEntity());
+        m_droneBatteries.push_back(&crazyflie.GetBatterySensorEquippedEntity());
     }
 
-    // Prepare to listen for connections
-    ret = listen(m_connectionSocket, 1);
-    if (ret == -1) {
-        std::perror("Unix socket listen");
-        std::exit(EXIT_FAILURE);
+    // Controllers may search the hash before the first PreStep
+    if (m_isSpatialHashEnabled) {
+        UpdateDroneSpatialHash();
     }
+}
 
-    // Wait for incoming connection
-    std::cout << "Waiting for Unix socket connection\n";
-    m_dataSocket = accept(m_connectionSocket, nullptr, nullptr);
-    if (m_dataSocket == -1) {
-        std::perror("Unix socket accept");
-        std::exit(EXIT_FAILURE);
+void CHivexploreLoopFunctions::UpdateDroneSpatialHash() {
+    m_dronePositions.resize(m_droneBodies.size());
+    for (std::size_t i = 0; i < m_droneBodies.size(); i++) {
+        const CVector3& position = m_droneBodies[i]->GetOriginAnchor().Position;
+        m_dronePositions[i] = {static_cast<float>(position.GetX()), static_cast<float>(position.GetY())};
     }
+    m_droneSpatialHash.Rebuild(m_dronePositions);
 
-    std::cout << "Unix socket connection accepted\n";
+    const std::vector<std::reference_wrapper<CCrazyflieController>>& controllers = m_controllers.GetItems();
+    m_claimedFrontiers.resize(controllers.size());
+    for (std::size_t i = 0; i < controllers.size(); i++) {
+        m_claimedFrontiers[i] = controllers[i].get().GetClaimedFrontier();
+    }
 }
 
-bool CHivexploreLoopFunctions::Send(LogName logName, const json& droneId, const json& variables) {
-    json packet = {
-        {"logName", logNameToString(logName)},
-        {"droneId", droneId},
-        {"variables", variables},
-    };
+void CHivexploreLoopFunctions::ResetMap() {
+    // Map the floor of the arena
+    const CVector3& arenaCenter = GetSpace().GetArenaCenter();
+    const CVector3& arenaSize = GetSpace().GetArenaSize();
+    m_occupancyGrid.Reset(static_cast<float>(arenaCenter.GetX() - arenaSize.GetX() / 2.0),
+                          static_cast<float>(arenaCenter.GetY() - arenaSize.GetY() / 2.0),
+                          static_cast<float>(arenaCenter.GetX() + arenaSize.GetX() / 2.0),
+                          static_cast<float>(arenaCenter.GetY() + arenaSize.GetY() / 2.0),
+                          m_mapCellSize);
+}
 
-    std::string serializedPacket = packet.dump();
+void CHivexploreLoopFunctions::UpdateMap() {
+    for (const auto& controller : m_controllers.GetItems()) {
+        const TelemetrySnapshot snapshot = controller.get().GetTelemetrySnapshot();
 
-    ssize_t count = send(m_dataSocket, serializedPacket.c_str(), serializedPacket.size(), MSG_DONTWAIT);
+        // Like the server, ignore the readings of drones which are not flying
+        const auto droneStatus = static_cast<DroneStatus>(snapshot.droneStatus);
+        if (droneStatus != DroneStatus::Standby && droneStatus != DroneStatus::Landed && droneStatus != DroneStatus::Crashed) {
+            m_occupancyGrid.AddRangeReadings(snapshot);
+        }
+    }
+}
 
-    if (count == -1 && errno != EAGAIN && errno != EWOULDBLOCK) {
-        // Restart simulation in case of socket error
-        std::perror("Unix socket send");
-        Stop();
-        return false;
+void CHivexploreLoopFunctions::ResetHeadlessMode() {
+    // Cover the floor of the arena
+    const CVector3& arenaCenter = GetSpace().GetArenaCenter();
+    const CVector3& arenaSize = GetSpace().GetArenaSize();
+    m_coverageGrid.Reset(static_cast<float>(arenaCenter.GetX() - arenaSize.GetX() / 2.0),
+                         static_cast<float>(arenaCenter.GetY() - arenaSize.GetY() / 2.0),
+                         static_cast<float>(arenaCenter.GetX() + arenaSize.GetX() / 2.0),
+                         static_cast<float>(arenaCenter.GetY() + arenaSize.GetY() / 2.0),
+                         m_coverageCellSize);
+
+    m_initialBatteryLevels.clear();
+    m_wasDroneColliding.clear();
+    m_collisionCount = 0;
+    m_isReturnOrdered = false;
+    m_returnDurations.clear();
+    m_landingCharges.clear();
+    m_isDroneStranded.clear();
+
+    m_metricsFile.close();
+    const std::filesystem::path metricsDirectory = std::filesystem::path(m_metricsPath).parent_path();
+    if (!metricsDirectory.empty()) {
+        std::error_code error;
+        std::filesystem::create_directories(metricsDirectory, error);
     }
+    m_metricsFile.open(m_metricsPath, std::ios::trunc);
+    if (!m_metricsFile) {
+        THROW_ARGOSEXCEPTION("Could not open headless metrics file: \"" << m_metricsPath << '"');
+    }
+    m_metricsFile << "time,coverage,battery_used,collisions,crashed_drones,returned_drones,mean_return_time,"
+                     "landed_drones,stranded_drones,mean_landing_charge\n";
 
-    return true;
+    // Start the mission right away since no server will send the mission state
+    for (const auto& controller : m_controllers.GetItems()) {
+        controller.get().SetParamData("hivexplore." + paramNameToString(ParamName::MissionState),
+                                      static_cast<std::uint8_t>(MissionState::Exploring));
+    }
 }
 
-void CHivexploreLoopFunctions::Stop() {
-    LOG << "Stopping simulation...\n"
-           "Please do the following to restart the mission:\n"
-           "1. Press the restart button on the ARGoS client - the simulation will freeze\n"
-           "2. Restart the server\n"
-           "3. Press the play button on the ARGoS client\n";
-    m_isExperimentFinished = true;
-}
+void CHivexploreLoopFunctions::UpdateHeadlessMode() {
+    const std::vector<std::reference_wrapper<CCrazyflieController>>& controllers = m_controllers.GetItems();
+    m_initialBatteryLevels.resize(controllers.size(), 0);
+    m_wasDroneColliding.resize(controllers.size(), false);
+    m_returnDurations.resize(controllers.size(), -1.0);
+    m_landingCharges.resize(controllers.size(), -1.0);
+    m_isDroneStranded.resize(controllers.size(), false);
+    const bool isFirstUpdate = GetSpace().GetSimulationClock() == 1;
+    const double elapsedTime = GetSpace().GetSimulationClock() * Constants::secondsPerTick;
+
+    if (m_returnTime > 0.0 && !m_isReturnOrdered && elapsedTime >= m_returnTime) {
+        for (const auto& controller : m_controllers.GetItems()) {
+            controller.get().SetParamData("hivexplore." + paramNameToString(ParamName::MissionState),
+                                          static_cast<std::uint8_t>(MissionState::Returning));
+        }
+        m_isReturnOrdered = true;
+    }
 
-void CHivexploreLoopFunctions::SendDroneIdsToServer() {
-    std::vector<std::reference_wrapper<CCrazyflieController>> controllers = GetControllers();
-    std::vector<std::string> droneIds;
+    std::uint32_t batteryUsedSum = 0;
+    std::size_t crashedDroneCount = 0;
+    std::size_t returnedDroneCount = 0;
+    double returnDurationSum = 0.0;
+    std::size_t landedDroneCount = 0;
+    std::size_t strandedDroneCount = 0;
+    double landingChargeSum = 0.0;
+    for (std::size_t droneIndex = 0; droneIndex < controllers.size(); droneIndex++) {
+        const TelemetrySnapshot snapshot = controllers[droneIndex].get().GetTelemetrySnapshot();
+
+        m_coverageGrid.AddRangeReadings(snapshot);
+
+        // Battery levels are only read by the controllers once they have stepped
+        if (isFirstUpdate) {
+            m_initialBatteryLevels[droneIndex] = snapshot.batteryLevel;
+        }
+        if (snapshot.batteryLevel < m_initialBatteryLevels[droneIndex]) {
+            batteryUsedSum += m_initialBatteryLevels[droneIndex] - snapshot.batteryLevel;
+        }
 
-    std::transform(controllers.begin(), controllers.end(), std::back_inserter(droneIds), [](const auto& controller) {
-        return controller.get().GetId();
-    });
+        // Count each contact once, not every tick it lasts
+        const bool isColliding = m_droneBodies[droneIndex]->IsCollidingWithSomething();
+        if (isColliding && !m_wasDroneColliding[droneIndex]) {
+            m_collisionCount++;
+        }
+        m_wasDroneColliding[droneIndex] = isColliding;
 
-    if (!Send(LogName::DroneIds, nullptr, droneIds)) {
-        return;
+        if (snapshot.droneStatus == static_cast<std::uint8_t>(DroneStatus::Crashed)) {
+            crashedDroneCount++;
+        }
+
+        // Returning drones only land once they found their base
+        if (m_isReturnOrdered && m_returnDurations[droneIndex] < 0.0 &&
+            snapshot.droneStatus == static_cast<std::uint8_t>(DroneStatus::Landed)) {
+            m_returnDurations[droneIndex] = elapsedTime - m_returnTime;
+        }
+        if (m_returnDurations[droneIndex] >= 0.0) {
+            returnedDroneCount++;
+            returnDurationSum += m_returnDurations[droneIndex];
+        }
+
+        // The battery model's charge, not the noisy reading the controllers estimate it from
+        const double charge = m_droneBatteries[droneIndex]->GetAvailableCharge();
+        const bool isDroneDown = snapshot.droneStatus == static_cast<std::uint8_t>(DroneStatus::Landed) ||
+                                 snapshot.droneStatus == static_cast<std::uint8_t>(DroneStatus::Crashed);
+        if (m_landingCharges[droneIndex] < 0.0 && snapshot.droneStatus == static_cast<std::uint8_t>(DroneStatus::Landed)) {
+            m_landingCharges[droneIndex] = charge;
+        }
+        if (charge <= 0.0 && !isDroneDown) {
+            m_isDroneStranded[droneIndex] = true;
+        }
+        if (m_landingCharges[droneIndex] >= 0.0) {
+            landedDroneCount++;
+            landingChargeSum += m_landingCharges[droneIndex];
+        }
+        if (m_isDroneStranded[droneIndex]) {
+            strandedDroneCount++;
+        }
+    }
+
+    const bool isTargetReached = m_returnTime > 0.0 ? m_isReturnOrdered && returnedDroneCount + crashedDroneCount == controllers.size()
+                                                    : m_coverageGrid.GetCoverage() >= m_coverageTarget;
+    // Drones which returned on low battery do not take off again
+    const bool areAllDronesDown = !controllers.empty() && landedDroneCount + crashedDroneCount == controllers.size();
+    m_isExperimentFinished = isTargetReached || areAllDronesDown || (m_timeLimit > 0.0 && elapsedTime >= m_timeLimit);
+
+    // Sample once per second, and on the last tick to record the final results
+    if (GetSpace().GetSimulationClock() % Constants::ticksPerSecond == 0 || m_isExperimentFinished) {
+        const double batteryUsed = controllers.empty() ? 0.0 : static_cast<double>(batteryUsedSum) / controllers.size();
+        const double meanReturnDuration = returnedDroneCount > 0 ? returnDurationSum / returnedDroneCount : 0.0;
+        const double meanLandingCharge = landedDroneCount > 0 ? landingChargeSum / landedDroneCount : 0.0;
+        WriteMetrics(elapsedTime,
+                     batteryUsed,
+                     crashedDroneCount,
+                     returnedDroneCount,
+                     meanReturnDuration,
+                     landedDroneCount,
+                     strandedDroneCount,
+                     meanLandingCharge);
     }
 }
 
-std::vector<std::reference_wrapper<CCrazyflieController>> CHivexploreLoopFunctions::GetControllers() {
-    CSpace::TMapPerType& entities = GetSpace().GetEntitiesByType("crazyflie");
-    std::vector<std::reference_wrapper<CCrazyflieController>> controllers;
-    std::transform(entities.begin(), entities.end(), std::back_inserter(controllers), [](const auto& pair) {
-        CCrazyflieEntity& crazyflie = *any_cast<CCrazyflieEntity*>(pair.second);
-        CCrazyflieController& controller = dynamic_cast<CCrazyflieController&>(crazyflie.GetControllableEntity().GetController());
-        return std::ref(controller);
-    });
-    return controllers;
+void CHivexploreLoopFunctions::WriteMetrics(double elapsedTime, double batteryUsed, std::size_t crashedDroneCount,
+                                            std::size_t returnedDroneCount, double meanReturnDuration, std::size_t landedDroneCount,
+                                            std::size_t strandedDroneCount, double meanLandingCharge) {
+    m_metricsFile << elapsedTime << ',' << m_coverageGrid.GetCoverage() << ',' << batteryUsed << ',' << m_collisionCount << ','
+                  << crashedDroneCount << ',' << returnedDroneCount << ',' << meanReturnDuration << ',' << landedDroneCount << ','
+                  << strandedDroneCount << ',' << meanLandingCharge << '\n';
 }
 
 REGISTER_LOOP_FUNCTIONS(CHivexploreLoopFunctions, "hivexplore_loop_functions")
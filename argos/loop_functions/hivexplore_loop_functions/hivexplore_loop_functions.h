@@ -1,10 +1,19 @@
 #ifndef HIVEXPLORE_LOOP_FUNCTIONS_H
 #define HIVEXPLORE_LOOP_FUNCTIONS_H
 
-#include <sys/un.h>
+#include <fstream>
 #include <argos3/core/simulator/loop_functions.h>
+#include <argos3/plugins/simulator/entities/battery_equipped_entity.h>
 #include "controllers/crazyflie/crazyflie.h"
+#include "utils/id_registry.h"
 #include "utils/log_name.h"
+#include "utils/map_frame.h"
+#include "utils/spatial_hash.h"
+#include "utils/telemetry_frame.h"
+#include "utils/telemetry_schedule.h"
+#include "coverage_grid.h"
+#include "packet_batch.h"
+#include "unix_socket_server.h"
 
 using namespace argos;
 
@@ -19,17 +28,70 @@ public:
     virtual void PostExperiment() override;
 
 private:
-    void StartSocket();
-    bool Send(LogName logName, const json& droneId, const json& variables);
-    void Stop();
+    void ReceiveParamData();
+    void SendLogData(TelemetryGroupMask forcedGroups);
+    void SendMapData();
+    void Send(LogName logName, const json& droneId, const json& variables);
+    void Send(const void* data, std::size_t size);
+    bool FlushPackets();
+    void DisconnectFromServer();
     void SendDroneIdsToServer();
-    std::vector<std::reference_wrapper<CCrazyflieController>> GetControllers();
+    void RefreshControllers();
+    void UpdateDroneSpatialHash();
+    void ResetMap();
+    void UpdateMap();
 
-    int m_connectionSocket = -1;
-    sockaddr_un m_socketName;
-    int m_dataSocket = -1;
+    void ResetHeadlessMode();
+    void UpdateHeadlessMode();
+    void WriteMetrics(double elapsedTime, double batteryUsed, std::size_t crashedDroneCount, std::size_t returnedDroneCount,
+                      double meanReturnDuration, std::size_t landedDroneCount, std::size_t strandedDroneCount, double meanLandingCharge);
+
+    CUnixSocketServer m_socketServer;
+    std::vector<char> m_receiveBuffer;
+    CIdRegistry<CCrazyflieController> m_controllers;
+    // Battery models of the drones, in the same order as the registry, for the headless mode's metrics
+    std::vector<CBatteryEquippedEntity*> m_droneBatteries;
+
+    // Drone positions shared with the controllers for their neighbour searches, in the same order as the registry
+    bool m_isSpatialHashEnabled = false;
+    float m_neighbourRadius = 3.0f; // In meters
+    std::vector<CEmbodiedEntity*> m_droneBodies;
+    std::vector<CSpatialHash::SPoint> m_dronePositions;
+    CSpatialHash m_droneSpatialHash;
+    std::vector<ClaimedFrontier> m_claimedFrontiers; // Shared like the positions, for frontier exploration
+
+    TelemetryFormat m_telemetryFormat = TelemetryFormat::Json;
+    CTelemetrySchedule m_telemetrySchedule;
+    CTelemetryFrameWriter m_telemetryFrameWriter;
+    CPacketBatch m_packetBatch;
+    std::uint64_t m_lastReportedDroppedPacketCount = 0;
+
+    // Map built from the drones' range sensors, of which only the changed cells are sent to the server
+    bool m_isMappingEnabled = false;
+    float m_mapCellSize = 0.05f;
+    COccupancyGrid m_occupancyGrid;
+    CMapFrameWriter m_mapFrameWriter;
 
     bool m_isExperimentFinished = false;
+
+    // Headless mode, where exploration is measured without any server connection
+    bool m_isHeadless = false;
+    std::string m_metricsPath;
+    double m_coverageTarget = 1.0;
+    double m_timeLimit = 0.0; // In seconds, 0 for no limit other than the experiment's length
+    float m_coverageCellSize = 0.1f;
+    CCoverageGrid m_coverageGrid;
+    std::ofstream m_metricsFile;
+    std::vector<std::uint8_t> m_initialBatteryLevels;
+    std::vector<bool> m_wasDroneColliding;
+    std::uint64_t m_collisionCount = 0;
+    // Every drone is ordered to return to its base at the return time, then the experiment stops once they all landed or crashed
+    double m_returnTime = 0.0; // In seconds, 0 to never order the return
+    bool m_isReturnOrdered = false;
+    std::vector<double> m_returnDurations; // In seconds, negative until the drone landed
+    // Drones also return by themselves when their battery runs low, the charge left once landed shows how late they returned
+    std::vector<double> m_landingCharges; // Negative until the drone landed
+    std::vector<bool> m_isDroneStranded; // Whether the battery ran out before the drone landed
 };
 
 #endif
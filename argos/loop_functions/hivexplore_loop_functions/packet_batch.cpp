@@ -0,0 +1,106 @@
+#include "packet_batch.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+    // Bound the backlog kept while the server is too slow to receive everything
+    constexpr std::size_t maxPendingBytes = 4 * 1024 * 1024;
+    // Maximum number of messages accepted by a single sendmmsg call (UIO_MAXIOV)
+    constexpr std::size_t maxMessagesPerCall = 1024;
+} // namespace
+
+void CPacketBatch::Add(const void* data, std::size_t size) {
+    // Make room for the new packet by dropping the oldest ones
+    std::size_t droppedPacketCount = 0;
+    std::size_t pendingBytes = m_buffer.size();
+    while (droppedPacketCount < m_packets.size() && pendingBytes + size > maxPendingBytes) {
+        pendingBytes -= m_packets[droppedPacketCount].second;
+        droppedPacketCount++;
+    }
+    DropOldestPackets(droppedPacketCount);
+
+    const std::size_t offset = m_buffer.size();
+    m_buffer.resize(offset + size);
+    std::memcpy(m_buffer.data() + offset, data, size);
+    m_packets.emplace_back(offset, size);
+}
+
+bool CPacketBatch::Flush(int socket) {
+    std::size_t sentPacketCount = 0;
+    while (sentPacketCount < m_packets.size()) {
+        const std::size_t messageCount = std::min(m_packets.size() - sentPacketCount, maxMessagesPerCall);
+        m_messages.resize(messageCount);
+        m_iovecs.resize(messageCount);
+        for (std::size_t i = 0; i < messageCount; i++) {
+            const auto& [offset, size] = m_packets[sentPacketCount + i];
+            m_iovecs[i] = {m_buffer.data() + offset, size};
+            m_messages[i] = {};
+            m_messages[i].msg_hdr.msg_iov = &m_iovecs[i];
+            m_messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int count = sendmmsg(socket, m_messages.data(), static_cast<unsigned int>(messageCount), MSG_DONTWAIT);
+        if (count == -1) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                std::perror("Unix socket sendmmsg");
+                return false;
+            }
+            // Socket buffer is full, keep remaining packets for the next flush
+            m_statistics.BackpressureCount++;
+            break;
+        }
+
+        for (std::size_t i = 0; i < static_cast<std::size_t>(count); i++) {
+            m_statistics.SentByteCount += m_packets[sentPacketCount + i].second;
+        }
+        m_statistics.SentPacketCount += count;
+        sentPacketCount += count;
+
+        if (static_cast<std::size_t>(count) < messageCount) {
+            m_statistics.BackpressureCount++;
+            break;
+        }
+    }
+
+    EraseOldestPackets(sentPacketCount);
+    return true;
+}
+
+void CPacketBatch::Clear() {
+    m_buffer.clear();
+    m_packets.clear();
+}
+
+std::size_t CPacketBatch::GetPendingPacketCount() const {
+    return m_packets.size();
+}
+
+const CPacketBatch::SStatistics& CPacketBatch::GetStatistics() const {
+    return m_statistics;
+}
+
+void CPacketBatch::DropOldestPackets(std::size_t packetCount) {
+    if (packetCount == 0) {
+        return;
+    }
+
+    m_statistics.DroppedPacketCount += packetCount;
+    EraseOldestPackets(packetCount);
+}
+
+void CPacketBatch::EraseOldestPackets(std::size_t packetCount) {
+    if (packetCount == m_packets.size()) {
+        Clear();
+        return;
+    }
+
+    // Shift the remaining packets to the front of the buffer
+    const std::size_t erasedByteCount = m_packets[packetCount].first;
+    m_buffer.erase(m_buffer.begin(), m_buffer.begin() + erasedByteCount);
+    m_packets.erase(m_packets.begin(), m_packets.begin() + packetCount);
+    for (auto& packet : m_packets) {
+        packet.first -= erasedByteCount;
+    }
+}
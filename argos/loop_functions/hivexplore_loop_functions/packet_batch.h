@@ -0,0 +1,40 @@
+#ifndef PACKET_BATCH_H
+#define PACKET_BATCH_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <sys/socket.h>
+
+// Accumulates the packets of a tick in one contiguous buffer and sends them with as few sendmmsg calls as possible. Each packet
+// remains a separate message on the SOCK_SEQPACKET socket. Packets the socket cannot accept yet are kept for the next flush instead
+// of being dropped, and only the oldest packets are discarded once the backlog exceeds its capacity
+class CPacketBatch {
+public:
+    struct SStatistics {
+        std::uint64_t SentPacketCount = 0;
+        std::uint64_t SentByteCount = 0;
+        std::uint64_t BackpressureCount = 0; // Flushes that could not send every pending packet
+        std::uint64_t DroppedPacketCount = 0;
+    };
+
+    void Add(const void* data, std::size_t size);
+    // Returns false in case of socket error
+    bool Flush(int socket);
+    void Clear();
+
+    std::size_t GetPendingPacketCount() const;
+    const SStatistics& GetStatistics() const;
+
+private:
+    void DropOldestPackets(std::size_t packetCount);
+    void EraseOldestPackets(std::size_t packetCount);
+
+    std::vector<std::uint8_t> m_buffer;
+    std::vector<std::pair<std::size_t, std::size_t>> m_packets; // (offset, size) pairs into the buffer
+    std::vector<mmsghdr> m_messages;
+    std::vector<iovec> m_iovecs;
+    SStatistics m_statistics;
+};
+
+#endif
@@ -0,0 +1,107 @@
+#include "unix_socket_server.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+CUnixSocketServer::~CUnixSocketServer() {
+    Close();
+}
+
+void CUnixSocketServer::Open(const std::string& path) {
+    m_path = path;
+
+    // Remove socket if it already exists
+    if (unlink(m_path.c_str()) == -1 && errno != ENOENT) {
+        std::perror("Unix socket unlink");
+        std::exit(EXIT_FAILURE);
+    }
+
+    // Create Unix domain socket, non-blocking so that accept returns immediately when no peer is waiting
+    m_connectionSocket = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK, 0);
+    if (m_connectionSocket == -1) {
+        std::perror("Unix socket creation");
+        std::exit(EXIT_FAILURE);
+    }
+
+    // Bind socket to socket name
+    sockaddr_un socketName;
+    std::memset(&socketName, 0, sizeof(socketName));
+    socketName.sun_family = AF_UNIX;
+    std::strncpy(socketName.sun_path, m_path.c_str(), sizeof(socketName.sun_path) - 1);
+
+    int ret = bind(m_connectionSocket, reinterpret_cast<const struct sockaddr*>(&socketName), sizeof(socketName));
+    if (ret == -1) {
+        std::perror("Unix socket bind");
+        std::exit(EXIT_FAILURE);
+    }
+
+    // Prepare to listen for connections
+    ret = listen(m_connectionSocket, 1);
+    if (ret == -1) {
+        std::perror("Unix socket listen");
+        std::exit(EXIT_FAILURE);
+    }
+
+    std::cout << "Waiting for Unix socket connection\n";
+}
+
+void CUnixSocketServer::Close() {
+    if (!IsOpen()) {
+        return;
+    }
+
+    Disconnect();
+    if (close(m_connectionSocket) == -1) {
+        std::perror("Unix connection socket close");
+    }
+    m_connectionSocket = -1;
+    if (unlink(m_path.c_str()) == -1 && errno != ENOENT) {
+        std::perror("Unix socket unlink");
+    }
+}
+
+bool CUnixSocketServer::PollConnection() {
+    if (!IsOpen() || IsConnected()) {
+        return false;
+    }
+
+    m_dataSocket = accept(m_connectionSocket, nullptr, nullptr);
+    if (m_dataSocket == -1) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            std::perror("Unix socket accept");
+        }
+        return false;
+    }
+
+    std::cout << "Unix socket connection accepted\n";
+    return true;
+}
+
+void CUnixSocketServer::Disconnect() {
+    if (!IsConnected()) {
+        return;
+    }
+
+    if (close(m_dataSocket) == -1) {
+        std::perror("Unix data socket close");
+    }
+    m_dataSocket = -1;
+}
+
+bool CUnixSocketServer::IsOpen() const {
+    return m_connectionSocket != -1;
+}
+
+bool CUnixSocketServer::IsConnected() const {
+    return m_dataSocket != -1;
+}
+
+int CUnixSocketServer::GetDataSocket() const {
+    return m_dataSocket;
+}
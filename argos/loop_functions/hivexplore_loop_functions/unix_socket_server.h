@@ -0,0 +1,30 @@
+#ifndef UNIX_SOCKET_SERVER_H
+#define UNIX_SOCKET_SERVER_H
+
+#include <string>
+
+// Listens on a SOCK_SEQPACKET Unix socket for a single peer without ever blocking the simulation. The listening socket is polled for a
+// new connection each tick while no peer is connected, which lets the server restart without restarting the simulation
+class CUnixSocketServer {
+public:
+    ~CUnixSocketServer();
+
+    // Exits the process on failure, since the simulation is useless without the socket
+    void Open(const std::string& path);
+    void Close();
+
+    // Returns true if a new peer has just connected
+    bool PollConnection();
+    void Disconnect();
+
+    bool IsOpen() const;
+    bool IsConnected() const;
+    int GetDataSocket() const;
+
+private:
+    std::string m_path;
+    int m_connectionSocket = -1;
+    int m_dataSocket = -1;
+};
+
+#endif
@@ -0,0 +1,49 @@
+#include "battery_estimator.h"
+
+namespace {
+    // The sensor's noise is uniform over +-0.02, which this gain averages over about 50 ticks
+    constexpr float chargeCorrectionGain = 0.02f;
+    // Used until enough distance is flown to learn it, the experiments' battery model charges 0.1 per meter plus the time and rotations
+    constexpr float initialChargePerMeter = 0.12f;
+    constexpr float minimumLearningDistance = 2.0f; // In m
+    // Margin for the path back to be longer than the trail, and charge left once landed
+    constexpr float returnSafetyFactor = 1.3f;
+    constexpr float returnReserve = 0.05f;
+} // namespace
+
+void CBatteryEstimator::Reset() {
+    m_startCharge = m_charge;
+    m_distanceFlown = 0.0f;
+    m_chargePerMeter = initialChargePerMeter;
+}
+
+void CBatteryEstimator::Clear() {
+    m_isInitialized = false;
+    m_charge = 0.0f;
+    Reset();
+}
+
+void CBatteryEstimator::Update(float charge, float distance) {
+    if (!m_isInitialized) {
+        m_charge = charge;
+        m_startCharge = charge;
+        m_chargePerMeter = initialChargePerMeter;
+        m_isInitialized = true;
+        return;
+    }
+
+    m_charge -= m_chargePerMeter * distance;
+    m_charge += chargeCorrectionGain * (charge - m_charge);
+    m_distanceFlown += distance;
+    if (m_distanceFlown >= minimumLearningDistance && m_charge < m_startCharge) {
+        m_chargePerMeter = (m_startCharge - m_charge) / m_distanceFlown;
+    }
+}
+
+float CBatteryEstimator::GetCharge() const {
+    return m_charge;
+}
+
+float CBatteryEstimator::GetReturnCharge(float distance) const {
+    return returnSafetyFactor * m_chargePerMeter * distance + returnReserve;
+}
@@ -0,0 +1,27 @@
+#ifndef BATTERY_ESTIMATOR_H
+#define BATTERY_ESTIMATOR_H
+
+// Filtered battery charge, and the charge needed to return to the base, like the drone firmware's estimator. The simulated battery has
+// no voltage and no current to count, so the charge used per meter flown is learned from the noisy battery sensor instead, which also
+// accounts for the time and the rotations the battery model charges for
+class CBatteryEstimator {
+public:
+    // Restarts learning the charge used per meter from the current estimate, which is kept
+    void Reset();
+    // Forgets the estimate, which is initialized again from the next reading, for when the simulated battery is recharged
+    void Clear();
+    // Predicts the charge used over the distance flown since the previous update (in m), then corrects it with the sensor's reading
+    void Update(float charge, float distance);
+    float GetCharge() const;
+    // Charge needed to fly back the distance to the base (in m) and land with a reserve
+    float GetReturnCharge(float distance) const;
+
+private:
+    bool m_isInitialized = false;
+    float m_charge = 0.0f;
+    float m_startCharge = 0.0f;
+    float m_distanceFlown = 0.0f; // In m
+    float m_chargePerMeter = 0.0f;
+};
+
+#endif
@@ -0,0 +1,86 @@
+#include "breadcrumb_trail.h"
+#include <cmath>
+
+namespace {
+    constexpr std::size_t maxBreadcrumbCount = 64;
+    constexpr float breadcrumbSpacing = 0.5f;
+    // A breadcrumb closer than this to the drone has been reached
+    constexpr float breadcrumbReachedDistance = 0.3f;
+
+    float CalculateDistance(const CBreadcrumbTrail::SPosition& first, const CBreadcrumbTrail::SPosition& second) {
+        return std::hypot(first.X - second.X, first.Y - second.Y);
+    }
+} // namespace
+
+void CBreadcrumbTrail::Reset(const SPosition& base) {
+    m_breadcrumbs.clear();
+    m_breadcrumbs.reserve(maxBreadcrumbCount);
+    m_breadcrumbs.push_back(base);
+}
+
+void CBreadcrumbTrail::Add(const SPosition& position, const COccupancyGrid& occupancyGrid) {
+    if (m_breadcrumbs.empty() || CalculateDistance(m_breadcrumbs.back(), position) < breadcrumbSpacing) {
+        return;
+    }
+
+    // The oldest breadcrumb the drone came back to gives the shortest trail
+    for (std::size_t i = 0; i + 1 < m_breadcrumbs.size(); i++) {
+        if (CalculateDistance(m_breadcrumbs[i], position) < breadcrumbSpacing && occupancyGrid.IsSegmentFree(position, m_breadcrumbs[i])) {
+            m_breadcrumbs.resize(i + 1);
+            return;
+        }
+    }
+
+    if (m_breadcrumbs.size() == maxBreadcrumbCount) {
+        RemoveEveryOtherBreadcrumb();
+    }
+    m_breadcrumbs.push_back(position);
+}
+
+bool CBreadcrumbTrail::GetNextWaypoint(const SPosition& position, const COccupancyGrid& occupancyGrid, SPosition& waypoint) {
+    if (m_breadcrumbs.empty()) {
+        return false;
+    }
+
+    // Breadcrumbs which were reached are no longer needed, but the base is kept to return to it
+    while (m_breadcrumbs.size() > 1 && CalculateDistance(m_breadcrumbs.back(), position) < breadcrumbReachedDistance) {
+        m_breadcrumbs.pop_back();
+    }
+
+    for (std::size_t i = 0; i + 1 < m_breadcrumbs.size(); i++) {
+        if (occupancyGrid.IsSegmentFree(position, m_breadcrumbs[i])) {
+            m_breadcrumbs.resize(i + 1);
+            break;
+        }
+    }
+
+    waypoint = m_breadcrumbs.back();
+    return true;
+}
+
+float CBreadcrumbTrail::GetLength(const SPosition& position) const {
+    if (m_breadcrumbs.empty()) {
+        return 0.0f;
+    }
+
+    float length = CalculateDistance(m_breadcrumbs.back(), position);
+    for (std::size_t i = 1; i < m_breadcrumbs.size(); i++) {
+        length += CalculateDistance(m_breadcrumbs[i - 1], m_breadcrumbs[i]);
+    }
+    return length;
+}
+
+std::size_t CBreadcrumbTrail::GetSize() const {
+    return m_breadcrumbs.size();
+}
+
+void CBreadcrumbTrail::RemoveEveryOtherBreadcrumb() {
+    // Keep the base and the latest breadcrumb
+    const SPosition latestBreadcrumb = m_breadcrumbs.back();
+    std::size_t count = 1;
+    for (std::size_t i = 2; i + 1 < m_breadcrumbs.size(); i += 2) {
+        m_breadcrumbs[count++] = m_breadcrumbs[i];
+    }
+    m_breadcrumbs.resize(count);
+    m_breadcrumbs.push_back(latestBreadcrumb);
+}
@@ -0,0 +1,32 @@
+#ifndef BREADCRUMB_TRAIL_H
+#define BREADCRUMB_TRAIL_H
+
+#include <vector>
+#include "utils/occupancy_grid.h"
+
+// Trail of the positions a drone flew through, followed backwards to return to its base, like the drone firmware's. A breadcrumb is
+// dropped every 50 cm and at most 64 are kept: when the trail is full, every other breadcrumb is removed, so that it always leads back
+// to the base at the cost of a coarser path
+class CBreadcrumbTrail {
+public:
+    using SPosition = COccupancyGrid::SPosition;
+
+    // Empties the trail and drops its first breadcrumb at the base, which is never removed
+    void Reset(const SPosition& base);
+    // Drops a breadcrumb if the drone is far enough from the latest one. When the drone comes back to an older breadcrumb which it can
+    // fly to in a straight line, the loop flown since that breadcrumb is cut from the trail
+    void Add(const SPosition& position, const COccupancyGrid& occupancyGrid);
+    // Finds the breadcrumb closest to the base along the trail which the drone can fly to in a straight line through free cells, or
+    // the latest breadcrumb if there is none, and removes the breadcrumbs after it. Returns false if the trail is empty
+    bool GetNextWaypoint(const SPosition& position, const COccupancyGrid& occupancyGrid, SPosition& waypoint);
+    // Length of the path from the drone back to the base along the trail
+    float GetLength(const SPosition& position) const;
+    std::size_t GetSize() const;
+
+private:
+    void RemoveEveryOtherBreadcrumb();
+
+    std::vector<SPosition> m_breadcrumbs;
+};
+
+#endif
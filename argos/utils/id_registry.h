@@ -0,0 +1,57 @@
+#ifndef ID_REGISTRY_H
+#define ID_REGISTRY_H
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Indexes objects by ID for constant time lookup, while keeping them in insertion order (used as the drone index of telemetry frames)
+template<typename T>
+class CIdRegistry {
+public:
+    void Clear();
+    void Add(const std::string& id, T& item);
+
+    // Returns nullptr if no object has this ID
+    T* Find(const std::string& id) const;
+    const std::vector<std::reference_wrapper<T>>& GetItems() const;
+    std::size_t GetSize() const;
+
+private:
+    std::vector<std::reference_wrapper<T>> m_items;
+    std::unordered_map<std::string, std::size_t> m_indices;
+};
+
+template<typename T>
+void CIdRegistry<T>::Clear() {
+    m_items.clear();
+    m_indices.clear();
+}
+
+template<typename T>
+void CIdRegistry<T>::Add(const std::string& id, T& item) {
+    m_indices.emplace(id, m_items.size());
+    m_items.emplace_back(item);
+}
+
+template<typename T>
+T* CIdRegistry<T>::Find(const std::string& id) const {
+    auto it = m_indices.find(id);
+    if (it == m_indices.end()) {
+        return nullptr;
+    }
+    return &m_items[it->second].get();
+}
+
+template<typename T>
+const std::vector<std::reference_wrapper<T>>& CIdRegistry<T>::GetItems() const {
+    return m_items;
+}
+
+template<typename T>
+std::size_t CIdRegistry<T>::GetSize() const {
+    return m_items.size();
+}
+
+#endif
@@ -1,4 +1,5 @@
 #include "log_name.h"
+#include <algorithm>
 #include <unordered_map>
 
 namespace {
@@ -24,3 +25,14 @@ const std::string& logNameToString(LogName logName) {
     }
     return unknownLogNameString;
 }
+
+bool logNameFromString(const std::string& logNameString, LogName& logName) {
+    auto it = std::find_if(logNameStrings.begin(), logNameStrings.end(), [&logNameString](const auto& pair) {
+        return pair.second == logNameString;
+    });
+    if (it != logNameStrings.end()) {
+        logName = it->first;
+        return true;
+    }
+    return false;
+}
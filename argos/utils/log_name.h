@@ -16,5 +16,6 @@ enum class LogName {
 };
 
 const std::string& logNameToString(LogName logName);
+bool logNameFromString(const std::string& logNameString, LogName& logName);
 
 #endif
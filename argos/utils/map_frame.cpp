@@ -0,0 +1,48 @@
+#include "map_frame.h"
+#include <cstring>
+
+void CMapFrameWriter::Clear(float cellSize, float originX, float originY) {
+    m_buffer.clear();
+    m_frames.clear();
+    m_header = {MapFrame::magic, MapFrame::version, 0, cellSize, originX, originY};
+}
+
+void CMapFrameWriter::Append(std::uint16_t column, std::uint16_t row, MapCellState state, std::uint16_t height) {
+    if (m_frames.empty() || m_frames.back().second + MapFrame::recordSize > MapFrame::maxFrameSize) {
+        StartFrame();
+    }
+
+    auto& [frameOffset, frameSize] = m_frames.back();
+    m_buffer.resize(m_buffer.size() + MapFrame::recordSize);
+
+    std::uint8_t* record = m_buffer.data() + frameOffset + frameSize;
+    std::memcpy(record, &column, sizeof(column));
+    record += sizeof(column);
+    std::memcpy(record, &row, sizeof(row));
+    record += sizeof(row);
+    std::memcpy(record, &state, sizeof(state));
+    record += sizeof(state);
+    std::memcpy(record, &height, sizeof(height));
+    frameSize += MapFrame::recordSize;
+
+    // Update cell count in place since the header is written before the frame's cells are known
+    MapFrameHeader header;
+    std::memcpy(&header, m_buffer.data() + frameOffset, sizeof(header));
+    header.cellCount++;
+    std::memcpy(m_buffer.data() + frameOffset, &header, sizeof(header));
+}
+
+const std::uint8_t* CMapFrameWriter::GetBuffer() const {
+    return m_buffer.data();
+}
+
+const std::vector<std::pair<std::size_t, std::size_t>>& CMapFrameWriter::GetFrames() const {
+    return m_frames;
+}
+
+void CMapFrameWriter::StartFrame() {
+    const std::size_t frameOffset = m_buffer.size();
+    m_buffer.resize(frameOffset + sizeof(m_header));
+    std::memcpy(m_buffer.data() + frameOffset, &m_header, sizeof(m_header));
+    m_frames.emplace_back(frameOffset, sizeof(m_header));
+}
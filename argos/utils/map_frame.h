@@ -0,0 +1,58 @@
+#ifndef MAP_FRAME_H
+#define MAP_FRAME_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+enum class MapCellState : std::uint8_t {
+    Unknown,
+    Free,
+    Occupied,
+};
+
+namespace MapFrame {
+    // Distinct from the telemetry frame's magic byte, and never the first byte of a JSON packet either
+    constexpr std::uint8_t magic = 0xB8;
+    constexpr std::uint8_t version = 1;
+    // Frames must fit in the server's receive buffer since the socket preserves message boundaries
+    constexpr std::size_t maxFrameSize = 4096;
+    // Each record is the cell's column and row from the grid's origin, its state and the height of its last obstacle (in mm), in the
+    // host's byte order (little-endian on every supported platform)
+    constexpr std::size_t recordSize = 2 * sizeof(std::uint16_t) + sizeof(MapCellState) + sizeof(std::uint16_t);
+} // namespace MapFrame
+
+#pragma pack(push, 1)
+struct MapFrameHeader {
+    std::uint8_t magic;
+    std::uint8_t version;
+    std::uint16_t cellCount;
+    float cellSize; // In meters
+    float originX; // Position of the grid's first cell corner, in meters
+    float originY;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(MapFrameHeader) == 16, "Map frame header layout must match the server's decoder");
+static_assert(MapFrame::recordSize == 7, "Map cell record layout must match the server's decoder");
+
+// Packs changed map cells into as few frames as possible, in a single buffer which keeps its capacity between ticks like
+// CTelemetryFrameWriter
+class CMapFrameWriter {
+public:
+    void Clear(float cellSize, float originX, float originY);
+    void Append(std::uint16_t column, std::uint16_t row, MapCellState state, std::uint16_t height);
+
+    const std::uint8_t* GetBuffer() const;
+    // Each frame is an (offset, size) pair into the buffer
+    const std::vector<std::pair<std::size_t, std::size_t>>& GetFrames() const;
+
+private:
+    void StartFrame();
+
+    std::vector<std::uint8_t> m_buffer;
+    std::vector<std::pair<std::size_t, std::size_t>> m_frames;
+    MapFrameHeader m_header = {};
+};
+
+#endif
@@ -0,0 +1,268 @@
+#include "occupancy_grid.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace {
+    // Must match the sensor threshold of the server's map generator
+    constexpr float sensorThreshold = 2000.0f;
+    constexpr float millimeterToMeterFactor = 0.001f;
+    constexpr float meterToMillimeterFactor = 1000.0f;
+    constexpr float degreesToRadiansFactor = static_cast<float>(M_PI / 180.0);
+
+    // Log-odds of the inverse sensor model, a hit has a 0.7 probability of being an obstacle and a crossed cell has a 0.4 probability
+    constexpr float hitLogOdds = 0.85f;
+    constexpr float missLogOdds = -0.4f;
+    // Bounds keep cells able to change state again after many consistent readings, when obstacles or drones move
+    constexpr float minLogOdds = -2.0f;
+    constexpr float maxLogOdds = 3.5f;
+    // A single hit is enough to mark a cell as occupied, like the server's map points
+    constexpr float occupiedLogOdds = hitLogOdds;
+    constexpr float freeLogOdds = missLogOdds;
+} // namespace
+
+void COccupancyGrid::Reset(float minX, float minY, float maxX, float maxY, float cellSize) {
+    m_minX = minX;
+    m_minY = minY;
+    m_cellSize = cellSize;
+    // Cells are sent with 16-bit coordinates
+    constexpr std::size_t maxCellsPerSide = std::numeric_limits<std::uint16_t>::max();
+    m_width = std::min(static_cast<std::size_t>(std::ceil((maxX - minX) / cellSize)), maxCellsPerSide);
+    m_height = std::min(static_cast<std::size_t>(std::ceil((maxY - minY) / cellSize)), maxCellsPerSide);
+    m_logOdds.assign(m_width * m_height, 0.0f);
+    m_states.assign(m_width * m_height, MapCellState::Unknown);
+    m_cellHeights.assign(m_width * m_height, 0);
+    m_isCellChanged.assign(m_width * m_height, false);
+    m_changedCells.clear();
+    m_isCellVisited.assign(m_width * m_height, false);
+    m_frontierSearchQueue.clear();
+}
+
+void COccupancyGrid::AddRangeReadings(const TelemetrySnapshot& snapshot) {
+    // Angle of each horizontal sensor relative to the drone's yaw
+    const std::array<std::pair<std::uint16_t, float>, 4> readings = {{
+        {snapshot.rangeFront, 0.0f},
+        {snapshot.rangeLeft, 90.0f},
+        {snapshot.rangeBack, 180.0f},
+        {snapshot.rangeRight, -90.0f},
+    }};
+
+    const auto height = static_cast<std::uint16_t>(std::clamp(snapshot.z * meterToMillimeterFactor, 0.0f, 65535.0f));
+    for (const auto& [reading, angleOffset] : readings) {
+        // Readings above the threshold hit nothing, but the space up to the threshold is still free
+        const bool isObstacleHit = reading < sensorThreshold;
+        const float distance = std::min(static_cast<float>(reading), sensorThreshold) * millimeterToMeterFactor;
+        CastRay(snapshot.x, snapshot.y, (snapshot.yaw + angleOffset) * degreesToRadiansFactor, distance, isObstacleHit, height);
+    }
+}
+
+const std::vector<std::size_t>& COccupancyGrid::GetChangedCells() const {
+    return m_changedCells;
+}
+
+void COccupancyGrid::ClearChangedCells() {
+    for (std::size_t index : m_changedCells) {
+        m_isCellChanged[index] = false;
+    }
+    m_changedCells.clear();
+}
+
+void COccupancyGrid::MarkKnownCellsChanged() {
+    for (std::size_t index = 0; index < m_states.size(); index++) {
+        if (m_states[index] != MapCellState::Unknown && !m_isCellChanged[index]) {
+            m_isCellChanged[index] = true;
+            m_changedCells.push_back(index);
+        }
+    }
+}
+
+MapCellState COccupancyGrid::GetCellState(std::size_t index) const {
+    return m_states[index];
+}
+
+std::uint16_t COccupancyGrid::GetCellHeight(std::size_t index) const {
+    return m_cellHeights[index];
+}
+
+std::uint16_t COccupancyGrid::GetColumn(std::size_t index) const {
+    return static_cast<std::uint16_t>(index % m_width);
+}
+
+std::uint16_t COccupancyGrid::GetRow(std::size_t index) const {
+    return static_cast<std::uint16_t>(index / m_width);
+}
+
+float COccupancyGrid::GetMinX() const {
+    return m_minX;
+}
+
+float COccupancyGrid::GetMinY() const {
+    return m_minY;
+}
+
+float COccupancyGrid::GetCellSize() const {
+    return m_cellSize;
+}
+
+bool COccupancyGrid::FindNearestFrontier(const SPosition& position, const std::vector<SPosition>& claimedFrontiers, float claimRadius,
+                                         SPosition& frontier) {
+    const auto startColumn = static_cast<std::int64_t>(std::floor((position.X - m_minX) / m_cellSize));
+    const auto startRow = static_cast<std::int64_t>(std::floor((position.Y - m_minY) / m_cellSize));
+    if (startColumn < 0 || startRow < 0 || startColumn >= static_cast<std::int64_t>(m_width) ||
+        startRow >= static_cast<std::int64_t>(m_height)) {
+        return false;
+    }
+
+    constexpr std::array<std::pair<std::int64_t, std::int64_t>, 4> adjacentOffsets = {{{1, 0}, {-1, 0}, {0, 1}, {0, -1}}};
+    auto isInside = [this](std::int64_t cellColumn, std::int64_t cellRow) {
+        return cellColumn >= 0 && cellRow >= 0 && cellColumn < static_cast<std::int64_t>(m_width) &&
+               cellRow < static_cast<std::int64_t>(m_height);
+    };
+    auto isClaimed = [&](float x, float y) {
+        return std::any_of(claimedFrontiers.begin(), claimedFrontiers.end(), [&](const SPosition& claimedFrontier) {
+            return std::hypot(claimedFrontier.X - x, claimedFrontier.Y - y) < claimRadius;
+        });
+    };
+
+    const std::size_t startIndex = static_cast<std::size_t>(startRow) * m_width + startColumn;
+    m_frontierSearchQueue.clear();
+    m_frontierSearchQueue.push_back(startIndex);
+    m_isCellVisited[startIndex] = true;
+
+    bool isFrontierFound = false;
+    // Cells are visited in order of distance from the drone, so the first unclaimed frontier is the nearest one
+    for (std::size_t queueIndex = 0; queueIndex < m_frontierSearchQueue.size() && !isFrontierFound; queueIndex++) {
+        const std::size_t index = m_frontierSearchQueue[queueIndex];
+        const auto column = static_cast<std::int64_t>(index % m_width);
+        const auto row = static_cast<std::int64_t>(index / m_width);
+
+        // The drone's own cell is expanded even if it is not known to be free yet
+        if (index != startIndex && m_states[index] != MapCellState::Free) {
+            continue;
+        }
+
+        bool isNextToUnknownCell = false;
+        for (const auto& [columnOffset, rowOffset] : adjacentOffsets) {
+            const std::int64_t adjacentColumn = column + columnOffset;
+            const std::int64_t adjacentRow = row + rowOffset;
+            if (!isInside(adjacentColumn, adjacentRow)) {
+                continue;
+            }
+
+            const std::size_t adjacentIndex = static_cast<std::size_t>(adjacentRow) * m_width + adjacentColumn;
+            const MapCellState adjacentState = m_states[adjacentIndex];
+            isNextToUnknownCell = isNextToUnknownCell || adjacentState == MapCellState::Unknown;
+            if (adjacentState == MapCellState::Free && !m_isCellVisited[adjacentIndex]) {
+                m_isCellVisited[adjacentIndex] = true;
+                m_frontierSearchQueue.push_back(adjacentIndex);
+            }
+        }
+
+        if (isNextToUnknownCell && m_states[index] == MapCellState::Free) {
+            const float x = m_minX + (column + 0.5f) * m_cellSize;
+            const float y = m_minY + (row + 0.5f) * m_cellSize;
+            if (!isClaimed(x, y)) {
+                frontier = {x, y};
+                isFrontierFound = true;
+            }
+        }
+    }
+
+    for (std::size_t index : m_frontierSearchQueue) {
+        m_isCellVisited[index] = false;
+    }
+    return isFrontierFound;
+}
+
+bool COccupancyGrid::IsSegmentFree(const SPosition& from, const SPosition& to) const {
+    // Sampling every quarter of a cell can only miss the corners of cells which the segment barely clips
+    const float sampleSpacing = m_cellSize / 4.0f;
+    const float deltaX = to.X - from.X;
+    const float deltaY = to.Y - from.Y;
+    const auto sampleCount = static_cast<std::size_t>(std::ceil(std::hypot(deltaX, deltaY) / sampleSpacing));
+
+    for (std::size_t i = 0; i <= sampleCount; i++) {
+        const float ratio = sampleCount > 0 ? static_cast<float>(i) / sampleCount : 0.0f;
+        const auto column = static_cast<std::int64_t>(std::floor((from.X + deltaX * ratio - m_minX) / m_cellSize));
+        const auto row = static_cast<std::int64_t>(std::floor((from.Y + deltaY * ratio - m_minY) / m_cellSize));
+        if (column < 0 || row < 0 || column >= static_cast<std::int64_t>(m_width) || row >= static_cast<std::int64_t>(m_height) ||
+            m_states[static_cast<std::size_t>(row) * m_width + column] != MapCellState::Free) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void COccupancyGrid::CastRay(float originX, float originY, float angle, float distance, bool isObstacleHit, std::uint16_t height) {
+    // Visit every cell crossed by the ray exactly once by stepping to the nearest cell boundary on either axis (Amanatides and Woo)
+    const float directionX = std::cos(angle);
+    const float directionY = std::sin(angle);
+    const float startX = (originX - m_minX) / m_cellSize;
+    const float startY = (originY - m_minY) / m_cellSize;
+    const float cellDistance = distance / m_cellSize;
+
+    auto column = static_cast<std::int64_t>(std::floor(startX));
+    auto row = static_cast<std::int64_t>(std::floor(startY));
+    const auto endColumn = static_cast<std::int64_t>(std::floor(startX + directionX * cellDistance));
+    const auto endRow = static_cast<std::int64_t>(std::floor(startY + directionY * cellDistance));
+
+    const std::int64_t stepColumn = directionX >= 0.0f ? 1 : -1;
+    const std::int64_t stepRow = directionY >= 0.0f ? 1 : -1;
+    constexpr float infinity = std::numeric_limits<float>::infinity();
+    const float deltaX = directionX != 0.0f ? std::abs(1.0f / directionX) : infinity;
+    const float deltaY = directionY != 0.0f ? std::abs(1.0f / directionY) : infinity;
+    float nextX = directionX != 0.0f ? (directionX > 0.0f ? column + 1 - startX : startX - column) * deltaX : infinity;
+    float nextY = directionY != 0.0f ? (directionY > 0.0f ? row + 1 - startY : startY - row) * deltaY : infinity;
+
+    auto isInside = [this](std::int64_t cellColumn, std::int64_t cellRow) {
+        return cellColumn >= 0 && cellRow >= 0 && cellColumn < static_cast<std::int64_t>(m_width) &&
+               cellRow < static_cast<std::int64_t>(m_height);
+    };
+
+    while (column != endColumn || row != endRow) {
+        if (isInside(column, row)) {
+            UpdateCell(static_cast<std::size_t>(row) * m_width + column, missLogOdds, height);
+        }
+
+        if (nextX < nextY) {
+            if (nextX > cellDistance) {
+                break;
+            }
+            column += stepColumn;
+            nextX += deltaX;
+        } else {
+            if (nextY > cellDistance) {
+                break;
+            }
+            row += stepRow;
+            nextY += deltaY;
+        }
+    }
+
+    if (isInside(endColumn, endRow)) {
+        UpdateCell(static_cast<std::size_t>(endRow) * m_width + endColumn, isObstacleHit ? hitLogOdds : missLogOdds, height);
+    }
+}
+
+void COccupancyGrid::UpdateCell(std::size_t index, float logOddsChange, std::uint16_t height) {
+    float& logOdds = m_logOdds[index];
+    logOdds = std::clamp(logOdds + logOddsChange, minLogOdds, maxLogOdds);
+
+    MapCellState state = m_states[index];
+    if (logOdds >= occupiedLogOdds) {
+        state = MapCellState::Occupied;
+        m_cellHeights[index] = height;
+    } else if (logOdds <= freeLogOdds) {
+        state = MapCellState::Free;
+    }
+
+    if (state != m_states[index]) {
+        m_states[index] = state;
+        if (!m_isCellChanged[index]) {
+            m_isCellChanged[index] = true;
+            m_changedCells.push_back(index);
+        }
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef OCCUPANCY_GRID_H
+#define OCCUPANCY_GRID_H
+
+#include <cstdint>
+#include <vector>
+#include "utils/map_frame.h"
+#include "utils/telemetry_snapshot.h"
+
+// Log-odds occupancy grid of the arena's horizontal plane, built from the drones' horizontal range sensors. Each reading lowers the
+// occupancy of the cells crossed by its ray and raises the occupancy of the cell it hits. Cells whose state changes are collected
+// so that only they are sent to the server
+class COccupancyGrid {
+public:
+    struct SPosition {
+        float X;
+        float Y;
+    };
+
+    // The grid covers the rectangle from (minX, minY) to (maxX, maxY), in meters
+    void Reset(float minX, float minY, float maxX, float maxY, float cellSize);
+    void AddRangeReadings(const TelemetrySnapshot& snapshot);
+
+    // Indices of the cells whose state changed since the changed cells were last cleared, without duplicates
+    const std::vector<std::size_t>& GetChangedCells() const;
+    void ClearChangedCells();
+    // Marks every known cell as changed, to send the whole map to a new peer
+    void MarkKnownCellsChanged();
+
+    MapCellState GetCellState(std::size_t index) const;
+    std::uint16_t GetCellHeight(std::size_t index) const;
+    std::uint16_t GetColumn(std::size_t index) const;
+    std::uint16_t GetRow(std::size_t index) const;
+    float GetMinX() const;
+    float GetMinY() const;
+    float GetCellSize() const;
+
+    // Finds the center of the nearest free cell next to an unknown cell, reachable from the position through free cells. Frontiers
+    // closer than claimRadius to a frontier claimed by another drone are skipped so that drones do not explore the same area
+    bool FindNearestFrontier(const SPosition& position, const std::vector<SPosition>& claimedFrontiers, float claimRadius,
+                             SPosition& frontier);
+    // Returns true if every cell along the segment is known to be free, so that a drone can fly it in a straight line
+    bool IsSegmentFree(const SPosition& from, const SPosition& to) const;
+
+private:
+    void CastRay(float originX, float originY, float angle, float distance, bool isObstacleHit, std::uint16_t height);
+    void UpdateCell(std::size_t index, float logOddsChange, std::uint16_t height);
+
+    float m_minX = 0.0f;
+    float m_minY = 0.0f;
+    float m_cellSize = 1.0f;
+    std::size_t m_width = 0;
+    std::size_t m_height = 0;
+    std::vector<float> m_logOdds;
+    std::vector<MapCellState> m_states;
+    std::vector<std::uint16_t> m_cellHeights; // Height of the last obstacle seen in each cell, in millimeters
+    std::vector<bool> m_isCellChanged;
+    std::vector<std::size_t> m_changedCells;
+    // Breadth-first search state kept between searches to avoid allocating on each search
+    std::vector<bool> m_isCellVisited;
+    std::vector<std::size_t> m_frontierSearchQueue;
+};
+
+#endif
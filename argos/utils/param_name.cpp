@@ -5,6 +5,7 @@ namespace {
     const std::unordered_map<ParamName, std::string> paramNameStrings = {
         {ParamName::MissionState, "missionState"},
         {ParamName::IsLedEnabled, "isLedEnabled"},
+        {ParamName::ExplorationMode, "explorationMode"},
     };
 
     const std::string unknownParamNameString = "unknown";
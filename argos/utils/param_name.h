@@ -6,6 +6,7 @@
 enum class ParamName {
     MissionState,
     IsLedEnabled,
+    ExplorationMode,
 };
 
 const std::string& paramNameToString(ParamName paramName);
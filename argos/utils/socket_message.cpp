@@ -0,0 +1,15 @@
+#include "socket_message.h"
+#include <sys/socket.h>
+
+ssize_t receiveSocketMessage(int socket, std::vector<char>& buffer) {
+    // Peek at the size of the next message, MSG_TRUNC returns its full length even though nothing is copied
+    ssize_t messageSize = recv(socket, nullptr, 0, MSG_DONTWAIT | MSG_PEEK | MSG_TRUNC);
+    if (messageSize <= 0) {
+        return messageSize;
+    }
+
+    if (buffer.size() < static_cast<std::size_t>(messageSize)) {
+        buffer.resize(messageSize);
+    }
+    return recv(socket, buffer.data(), messageSize, MSG_DONTWAIT);
+}
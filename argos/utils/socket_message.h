@@ -0,0 +1,12 @@
+#ifndef SOCKET_MESSAGE_H
+#define SOCKET_MESSAGE_H
+
+#include <vector>
+#include <sys/types.h>
+
+// Receives the next message of a SOCK_SEQPACKET socket without blocking. The buffer grows to fit the message, so messages are never
+// truncated, and keeps its capacity between calls. Returns the message size, or the result of recv (0 or -1 with errno set) if no
+// message was received
+ssize_t receiveSocketMessage(int socket, std::vector<char>& buffer);
+
+#endif
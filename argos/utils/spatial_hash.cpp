@@ -0,0 +1,125 @@
+#include "spatial_hash.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Large primes used to spread neighbouring cells over the buckets
+    constexpr std::uint32_t columnHashFactor = 73856093;
+    constexpr std::uint32_t rowHashFactor = 19349663;
+
+    float squaredDistance(const CSpatialHash::SPoint& point, float x, float y) {
+        const float deltaX = point.X - x;
+        const float deltaY = point.Y - y;
+        return deltaX * deltaX + deltaY * deltaY;
+    }
+} // namespace
+
+void CSpatialHash::SetCellSize(float cellSize) {
+    m_cellSize = cellSize;
+}
+
+void CSpatialHash::Rebuild(const std::vector<SPoint>& points) {
+    m_points = points;
+
+    // Keep at least twice as many buckets as points (rounded to a power of two) to limit collisions between occupied cells
+    std::size_t bucketCount = 1;
+    while (bucketCount < 2 * m_points.size()) {
+        bucketCount *= 2;
+    }
+    m_bucketStarts.assign(bucketCount + 1, 0);
+    m_sortedIndices.resize(m_points.size());
+
+    // Count the points of each bucket, then turn the counts into the end offset of each bucket
+    float minX = std::numeric_limits<float>::max();
+    float minY = std::numeric_limits<float>::max();
+    float maxX = std::numeric_limits<float>::lowest();
+    float maxY = std::numeric_limits<float>::lowest();
+    for (const auto& point : m_points) {
+        m_bucketStarts[GetBucket(GetCellCoordinate(point.X), GetCellCoordinate(point.Y))]++;
+        minX = std::min(minX, point.X);
+        minY = std::min(minY, point.Y);
+        maxX = std::max(maxX, point.X);
+        maxY = std::max(maxY, point.Y);
+    }
+    for (std::size_t i = 1; i < bucketCount; i++) {
+        m_bucketStarts[i] += m_bucketStarts[i - 1];
+    }
+    m_bucketStarts[bucketCount] = m_points.size();
+    m_extent = m_points.empty() ? 0.0f : std::hypot(maxX - minX, maxY - minY);
+
+    // Fill each bucket from its end, which leaves its offset at its start. Going backwards keeps indices ascending within a bucket
+    for (std::size_t i = m_points.size(); i-- > 0;) {
+        const std::size_t bucket = GetBucket(GetCellCoordinate(m_points[i].X), GetCellCoordinate(m_points[i].Y));
+        m_sortedIndices[--m_bucketStarts[bucket]] = i;
+    }
+}
+
+void CSpatialHash::FindInRadius(float x, float y, float radius, std::vector<std::size_t>& neighbours, std::size_t excludedIndex) const {
+    neighbours.clear();
+    if (m_points.empty()) {
+        return;
+    }
+
+    const float squaredRadius = radius * radius;
+    const std::int32_t minColumn = GetCellCoordinate(x - radius);
+    const std::int32_t maxColumn = GetCellCoordinate(x + radius);
+    const std::int32_t minRow = GetCellCoordinate(y - radius);
+    const std::int32_t maxRow = GetCellCoordinate(y + radius);
+
+    for (std::int32_t column = minColumn; column <= maxColumn; column++) {
+        for (std::int32_t row = minRow; row <= maxRow; row++) {
+            const std::size_t bucket = GetBucket(column, row);
+            for (std::size_t i = m_bucketStarts[bucket]; i < m_bucketStarts[bucket + 1]; i++) {
+                const std::size_t index = m_sortedIndices[i];
+                // Buckets also hold points of other cells hashed to them, which the distance check filters out
+                if (index != excludedIndex && squaredDistance(m_points[index], x, y) <= squaredRadius) {
+                    neighbours.push_back(index);
+                }
+            }
+        }
+    }
+
+    // Two cells of the search area hashed to the same bucket report its points twice
+    std::sort(neighbours.begin(), neighbours.end());
+    neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+}
+
+void CSpatialHash::FindNearest(float x, float y, std::size_t count, std::vector<std::size_t>& neighbours, std::size_t excludedIndex) const {
+    neighbours.clear();
+    if (count == 0 || m_points.empty()) {
+        return;
+    }
+
+    // Widen the search until it holds enough points, which are then guaranteed to include the nearest ones, or every point
+    const float maxRadius = std::sqrt(squaredDistance(m_points.front(), x, y)) + m_extent;
+    float radius = m_cellSize;
+    FindInRadius(x, y, radius, neighbours, excludedIndex);
+    while (neighbours.size() < count && radius < maxRadius) {
+        radius *= 2.0f;
+        FindInRadius(x, y, radius, neighbours, excludedIndex);
+    }
+
+    const std::size_t nearestCount = std::min(count, neighbours.size());
+    std::partial_sort(neighbours.begin(), neighbours.begin() + nearestCount, neighbours.end(), [this, x, y](std::size_t a, std::size_t b) {
+        return squaredDistance(m_points[a], x, y) < squaredDistance(m_points[b], x, y);
+    });
+    neighbours.resize(nearestCount);
+}
+
+const CSpatialHash::SPoint& CSpatialHash::GetPoint(std::size_t index) const {
+    return m_points[index];
+}
+
+std::size_t CSpatialHash::GetSize() const {
+    return m_points.size();
+}
+
+std::int32_t CSpatialHash::GetCellCoordinate(float coordinate) const {
+    return static_cast<std::int32_t>(std::floor(coordinate / m_cellSize));
+}
+
+std::size_t CSpatialHash::GetBucket(std::int32_t column, std::int32_t row) const {
+    const std::uint32_t hash = static_cast<std::uint32_t>(column) * columnHashFactor ^ static_cast<std::uint32_t>(row) * rowHashFactor;
+    // The bucket count is a power of two
+    return hash & (m_bucketStarts.size() - 2);
+}
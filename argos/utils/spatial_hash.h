@@ -0,0 +1,44 @@
+#ifndef SPATIAL_HASH_H
+#define SPATIAL_HASH_H
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Uniform spatial hash of 2D points, rebuilt from scratch with a counting sort instead of being updated as points move. Queries only
+// visit the cells overlapping the search area, and are const so they can run concurrently between rebuilds
+class CSpatialHash {
+public:
+    struct SPoint {
+        float X;
+        float Y;
+    };
+
+    static constexpr std::size_t noExcludedIndex = std::numeric_limits<std::size_t>::max();
+
+    void SetCellSize(float cellSize);
+    // No allocation happens once the number of points has been reached before
+    void Rebuild(const std::vector<SPoint>& points);
+
+    // Indices of the points within the radius of (x, y) other than the excluded index, in ascending order
+    void FindInRadius(float x, float y, float radius, std::vector<std::size_t>& neighbours, std::size_t excludedIndex = noExcludedIndex)
+        const;
+    // Indices of the count nearest points to (x, y) other than the excluded index, from nearest to farthest
+    void FindNearest(float x, float y, std::size_t count, std::vector<std::size_t>& neighbours, std::size_t excludedIndex = noExcludedIndex)
+        const;
+
+    const SPoint& GetPoint(std::size_t index) const;
+    std::size_t GetSize() const;
+
+private:
+    std::int32_t GetCellCoordinate(float coordinate) const;
+    std::size_t GetBucket(std::int32_t column, std::int32_t row) const;
+
+    float m_cellSize = 1.0f;
+    std::vector<SPoint> m_points;
+    std::vector<std::size_t> m_bucketStarts; // Start of each bucket in the sorted indices, with a final end marker
+    std::vector<std::size_t> m_sortedIndices; // Point indices grouped by bucket
+    float m_extent = 0.0f; // Largest distance between two points, bounds the radius of nearest neighbour searches
+};
+
+#endif
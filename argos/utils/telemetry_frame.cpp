@@ -0,0 +1,116 @@
+#include "telemetry_frame.h"
+#include <cstring>
+#include <utility>
+
+namespace {
+    template<typename T>
+    T getTelemetryField(const TelemetrySnapshot& snapshot, const TelemetryField& field) {
+        T value;
+        std::memcpy(&value, reinterpret_cast<const std::uint8_t*>(&snapshot) + field.offset, sizeof(value));
+        return value;
+    }
+} // namespace
+
+void CTelemetryFrameWriter::Clear(std::uint32_t tick) {
+    m_buffer.clear();
+    m_frames.clear();
+    m_tick = tick;
+}
+
+void CTelemetryFrameWriter::Append(std::uint16_t droneIndex, const TelemetrySnapshot& snapshot, TelemetryGroupMask groupMask) {
+    std::size_t recordSize = TelemetryFrame::recordHeaderSize;
+    for (std::size_t i = 0; i < telemetryFields.size(); i++) {
+        if (groupMask & telemetryFieldGroupBits[i]) {
+            recordSize += telemetryFieldSize(telemetryFields[i].type);
+        }
+    }
+
+    if (m_frames.empty() || m_frames.back().second + recordSize > TelemetryFrame::maxFrameSize) {
+        StartFrame();
+    }
+
+    auto& [frameOffset, frameSize] = m_frames.back();
+    m_buffer.resize(m_buffer.size() + recordSize);
+
+    // Write the record field by field to drop the snapshot's padding and the groups which are not sent
+    std::uint8_t* record = m_buffer.data() + frameOffset + frameSize;
+    std::memcpy(record, &droneIndex, sizeof(droneIndex));
+    record += sizeof(droneIndex);
+    std::memcpy(record, &groupMask, sizeof(groupMask));
+    record += sizeof(groupMask);
+    for (std::size_t i = 0; i < telemetryFields.size(); i++) {
+        if (!(groupMask & telemetryFieldGroupBits[i])) {
+            continue;
+        }
+        const std::size_t fieldSize = telemetryFieldSize(telemetryFields[i].type);
+        std::memcpy(record, reinterpret_cast<const std::uint8_t*>(&snapshot) + telemetryFields[i].offset, fieldSize);
+        record += fieldSize;
+    }
+    frameSize += recordSize;
+
+    // Update record count in place since the header is written before the frame's records are known
+    TelemetryFrameHeader header;
+    std::memcpy(&header, m_buffer.data() + frameOffset, sizeof(header));
+    header.recordCount++;
+    std::memcpy(m_buffer.data() + frameOffset, &header, sizeof(header));
+}
+
+const std::uint8_t* CTelemetryFrameWriter::GetBuffer() const {
+    return m_buffer.data();
+}
+
+const std::vector<std::pair<std::size_t, std::size_t>>& CTelemetryFrameWriter::GetFrames() const {
+    return m_frames;
+}
+
+void CTelemetryFrameWriter::StartFrame() {
+    const TelemetryFrameHeader header = {TelemetryFrame::magic, TelemetryFrame::version, 0, m_tick};
+    const std::size_t frameOffset = m_buffer.size();
+    m_buffer.resize(frameOffset + sizeof(header));
+    std::memcpy(m_buffer.data() + frameOffset, &header, sizeof(header));
+    m_frames.emplace_back(frameOffset, sizeof(header));
+}
+
+bool telemetryFormatFromString(const std::string& formatString, TelemetryFormat& format) {
+    if (formatString == "json") {
+        format = TelemetryFormat::Json;
+        return true;
+    }
+    if (formatString == "binary") {
+        format = TelemetryFormat::Binary;
+        return true;
+    }
+    return false;
+}
+
+json telemetryGroupToJson(const TelemetrySnapshot& snapshot, LogName logName) {
+    json variablesJson;
+    for (const auto& field : telemetryFields) {
+        if (field.logName != logName) {
+            continue;
+        }
+
+        switch (field.type) {
+        case TelemetryFieldType::UInt8:
+            variablesJson.emplace(field.name, getTelemetryField<std::uint8_t>(snapshot, field));
+            break;
+        case TelemetryFieldType::UInt16:
+            variablesJson.emplace(field.name, getTelemetryField<std::uint16_t>(snapshot, field));
+            break;
+        case TelemetryFieldType::Float:
+            variablesJson.emplace(field.name, getTelemetryField<float>(snapshot, field));
+            break;
+        }
+    }
+    return variablesJson;
+}
+
+std::string serializeJsonPacket(LogName logName, const json& droneId, const json& variables) {
+    json packet = {
+        {"logName", logNameToString(logName)},
+        {"droneId", droneId},
+        {"variables", variables},
+    };
+
+    return packet.dump();
+}
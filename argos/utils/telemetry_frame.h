@@ -0,0 +1,69 @@
+#ifndef TELEMETRY_FRAME_H
+#define TELEMETRY_FRAME_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "libs/json.hpp"
+#include "utils/log_name.h"
+#include "utils/telemetry_snapshot.h"
+
+using json = nlohmann::json;
+
+enum class TelemetryFormat {
+    Json,
+    Binary,
+};
+
+namespace TelemetryFrame {
+    // The magic byte can never be the first byte of a JSON packet, which allows both formats to share the same socket
+    constexpr std::uint8_t magic = 0xB7;
+    constexpr std::uint8_t version = 2;
+    // Frames must fit in the server's receive buffer since the socket preserves message boundaries
+    constexpr std::size_t maxFrameSize = 4096;
+    // Each record is the drone index (in the drone IDs packet) and the mask of the groups it contains, followed by the fields of
+    // these groups in descriptor order, in the host's byte order (little-endian on every supported platform)
+    constexpr std::size_t recordHeaderSize = sizeof(std::uint16_t) + sizeof(TelemetryGroupMask);
+    constexpr std::size_t maxRecordSize = recordHeaderSize + telemetrySnapshotPackedSize();
+} // namespace TelemetryFrame
+
+#pragma pack(push, 1)
+struct TelemetryFrameHeader {
+    std::uint8_t magic;
+    std::uint8_t version;
+    std::uint16_t recordCount;
+    std::uint32_t tick;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(TelemetryFrameHeader) == 8, "Telemetry frame header layout must match the server's decoder");
+static_assert(TelemetryFrame::maxRecordSize == 54, "Telemetry record layout must match the server's decoder");
+
+// Packs records into as few frames as possible. Frames are stored back to back in a single buffer which keeps its capacity
+// between ticks, so no allocation happens once the buffer has grown to the size of the swarm
+class CTelemetryFrameWriter {
+public:
+    void Clear(std::uint32_t tick);
+    // Only the fields of the groups in the mask are written
+    void Append(std::uint16_t droneIndex, const TelemetrySnapshot& snapshot, TelemetryGroupMask groupMask = allTelemetryGroups);
+
+    const std::uint8_t* GetBuffer() const;
+    // Each frame is an (offset, size) pair into the buffer
+    const std::vector<std::pair<std::size_t, std::size_t>>& GetFrames() const;
+
+private:
+    void StartFrame();
+
+    std::vector<std::uint8_t> m_buffer;
+    std::vector<std::pair<std::size_t, std::size_t>> m_frames;
+    std::uint32_t m_tick = 0;
+};
+
+bool telemetryFormatFromString(const std::string& formatString, TelemetryFormat& format);
+
+// Serializes the fields of the snapshot's log group (JSON fallback)
+json telemetryGroupToJson(const TelemetrySnapshot& snapshot, LogName logName);
+std::string serializeJsonPacket(LogName logName, const json& droneId, const json& variables);
+
+#endif
@@ -0,0 +1,82 @@
+#include "telemetry_schedule.h"
+#include <algorithm>
+#include <cstring>
+#include "utils/constants.h"
+
+CTelemetrySchedule::CTelemetrySchedule() {
+    // Send every group once per second by default
+    m_groupConfigs.fill({Constants::ticksPerSecond, false});
+}
+
+void CTelemetrySchedule::SetGroupPeriod(LogName logName, std::uint32_t periodTicks) {
+    std::size_t groupIndex = 0;
+    if (telemetryGroupIndex(logName, groupIndex)) {
+        m_groupConfigs[groupIndex].PeriodTicks = std::max<std::uint32_t>(periodTicks, 1);
+    }
+}
+
+void CTelemetrySchedule::SetGroupSentOnChange(LogName logName, bool isSentOnChange) {
+    std::size_t groupIndex = 0;
+    if (telemetryGroupIndex(logName, groupIndex)) {
+        m_groupConfigs[groupIndex].IsSentOnChange = isSentOnChange;
+    }
+}
+
+void CTelemetrySchedule::Reset(std::size_t droneCount) {
+    m_sentSnapshots.assign(droneCount, {});
+    m_sentGroupMasks.assign(droneCount, 0);
+}
+
+TelemetryGroupMask
+CTelemetrySchedule::Update(std::size_t droneIndex, std::uint64_t tick, const TelemetrySnapshot& snapshot, TelemetryGroupMask forcedGroups) {
+    if (droneIndex >= m_sentSnapshots.size()) {
+        m_sentSnapshots.resize(droneIndex + 1, {});
+        m_sentGroupMasks.resize(droneIndex + 1, 0);
+    }
+
+    TelemetrySnapshot& sentSnapshot = m_sentSnapshots[droneIndex];
+    TelemetryGroupMask& sentGroupMask = m_sentGroupMasks[droneIndex];
+
+    TelemetryGroupMask groupMask = forcedGroups;
+    for (std::size_t i = 0; i < m_groupConfigs.size(); i++) {
+        const SGroupConfig& groupConfig = m_groupConfigs[i];
+        if (tick % groupConfig.PeriodTicks != 0) {
+            continue;
+        }
+
+        const TelemetryGroupMask groupBit = static_cast<TelemetryGroupMask>(1 << i);
+        if (groupConfig.IsSentOnChange && (sentGroupMask & groupBit) && !HasGroupChanged(i, sentSnapshot, snapshot)) {
+            continue;
+        }
+        groupMask |= groupBit;
+    }
+
+    // Only the fields of the groups sent are kept, to compare against what the server last received
+    for (std::size_t i = 0; i < telemetryFields.size(); i++) {
+        if (groupMask & telemetryFieldGroupBits[i]) {
+            std::memcpy(reinterpret_cast<std::uint8_t*>(&sentSnapshot) + telemetryFields[i].offset,
+                        reinterpret_cast<const std::uint8_t*>(&snapshot) + telemetryFields[i].offset,
+                        telemetryFieldSize(telemetryFields[i].type));
+        }
+    }
+    sentGroupMask |= groupMask;
+
+    return groupMask;
+}
+
+bool CTelemetrySchedule::HasGroupChanged(std::size_t groupIndex,
+                                         const TelemetrySnapshot& previousSnapshot,
+                                         const TelemetrySnapshot& snapshot) const {
+    for (const auto& field : telemetryFields) {
+        if (field.logName != telemetryLogNames[groupIndex]) {
+            continue;
+        }
+
+        if (std::memcmp(reinterpret_cast<const std::uint8_t*>(&previousSnapshot) + field.offset,
+                        reinterpret_cast<const std::uint8_t*>(&snapshot) + field.offset,
+                        telemetryFieldSize(field.type)) != 0) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,38 @@
+#ifndef TELEMETRY_SCHEDULE_H
+#define TELEMETRY_SCHEDULE_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "utils/log_name.h"
+#include "utils/telemetry_snapshot.h"
+
+// Decides which log groups of each drone are sent at a given tick. Each group is due once per period, and groups sent on change
+// are skipped while their fields are identical to the last values sent for the drone
+class CTelemetrySchedule {
+public:
+    CTelemetrySchedule();
+
+    void SetGroupPeriod(LogName logName, std::uint32_t periodTicks);
+    void SetGroupSentOnChange(LogName logName, bool isSentOnChange);
+
+    // Forgets the values sent previously so every group is sent again once due
+    void Reset(std::size_t droneCount);
+    // Returns the groups to send for the drone and records their values as sent. Forced groups are sent even if they are not due
+    TelemetryGroupMask
+    Update(std::size_t droneIndex, std::uint64_t tick, const TelemetrySnapshot& snapshot, TelemetryGroupMask forcedGroups = 0);
+
+private:
+    struct SGroupConfig {
+        std::uint32_t PeriodTicks;
+        bool IsSentOnChange;
+    };
+
+    bool HasGroupChanged(std::size_t groupIndex, const TelemetrySnapshot& previousSnapshot, const TelemetrySnapshot& snapshot) const;
+
+    std::array<SGroupConfig, telemetryLogNames.size()> m_groupConfigs;
+    std::vector<TelemetrySnapshot> m_sentSnapshots;
+    std::vector<TelemetryGroupMask> m_sentGroupMasks;
+};
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef TELEMETRY_SNAPSHOT_H
+#define TELEMETRY_SNAPSHOT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "utils/log_name.h"
+
+// Log data of a drone at a given tick. Filled by the controller without any heap allocation
+struct TelemetrySnapshot {
+    std::uint8_t batteryLevel;
+    float roll;
+    float pitch;
+    float yaw;
+    float x;
+    float y;
+    float z;
+    float vx;
+    float vy;
+    float vz;
+    std::uint16_t rangeFront;
+    std::uint16_t rangeLeft;
+    std::uint16_t rangeBack;
+    std::uint16_t rangeRight;
+    std::uint16_t rangeUp;
+    std::uint16_t rangeZrange;
+    std::uint8_t rssi;
+    std::uint8_t droneStatus;
+};
+
+static_assert(std::is_trivially_copyable_v<TelemetrySnapshot> && std::is_standard_layout_v<TelemetrySnapshot>,
+              "TelemetrySnapshot must remain a POD to be serialized through its field descriptors");
+
+enum class TelemetryFieldType {
+    UInt8,
+    UInt16,
+    Float,
+};
+
+struct TelemetryField {
+    LogName logName;
+    const char* name;
+    TelemetryFieldType type;
+    std::size_t offset;
+};
+
+constexpr std::size_t telemetryFieldSize(TelemetryFieldType type) {
+    switch (type) {
+    case TelemetryFieldType::UInt8:
+        return sizeof(std::uint8_t);
+    case TelemetryFieldType::UInt16:
+        return sizeof(std::uint16_t);
+    case TelemetryFieldType::Float:
+        return sizeof(float);
+    }
+    return 0;
+}
+
+// Log groups in the order they are sent (orientation and position must be received before range data for mapping)
+constexpr std::array<LogName, 7> telemetryLogNames = {
+    LogName::BatteryLevel,
+    LogName::Orientation,
+    LogName::Position,
+    LogName::Velocity,
+    LogName::Range,
+    LogName::Rssi,
+    LogName::DroneStatus,
+};
+
+// Bit i is set when the group telemetryLogNames[i] is included
+using TelemetryGroupMask = std::uint8_t;
+static_assert(telemetryLogNames.size() <= sizeof(TelemetryGroupMask) * 8, "TelemetryGroupMask is too small for every log group");
+
+constexpr TelemetryGroupMask allTelemetryGroups = (1 << telemetryLogNames.size()) - 1;
+
+// Returns false if the log name is not part of the telemetry snapshot (drone IDs or console)
+constexpr bool telemetryGroupIndex(LogName logName, std::size_t& index) {
+    for (std::size_t i = 0; i < telemetryLogNames.size(); i++) {
+        if (telemetryLogNames[i] == logName) {
+            index = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+constexpr TelemetryGroupMask telemetryGroupBit(LogName logName) {
+    std::size_t index = 0;
+    return telemetryGroupIndex(logName, index) ? static_cast<TelemetryGroupMask>(1 << index) : 0;
+}
+
+// Field descriptors, in the order of the binary telemetry record and grouped by log group
+constexpr std::array<TelemetryField, 18> telemetryFields = {{
+    {LogName::BatteryLevel, "hivexplore.batteryLevel", TelemetryFieldType::UInt8, offsetof(TelemetrySnapshot, batteryLevel)},
+    {LogName::Orientation, "stateEstimate.roll", TelemetryFieldType::Float, offsetof(TelemetrySnapshot, roll)},
+    {LogName::Orientation, "stateEstimate.pitch", TelemetryFieldType::Float, offsetof(TelemetrySnapshot, pitch)},
+    {LogName::Orientation, "stateEstimate.yaw", TelemetryFieldType::Float, offsetof(TelemetrySnapshot, yaw)},
+    {LogName::Position, "stateEstimate.x", TelemetryFieldType::Float, offsetof(TelemetrySnapshot, x)},
+    {LogName::Position, "stateEstimate.y", TelemetryFieldType::Float, offsetof(TelemetrySnapshot, y)},
+    {LogName::Position, "stateEstimate.z", TelemetryFieldType::Float, offsetof(TelemetrySnapshot, z)},
+    {LogName::Velocity, "stateEstimate.vx", TelemetryFieldType::Float, offsetof(TelemetrySnapshot, vx)},
+    {LogName::Velocity, "stateEstimate.vy", TelemetryFieldType::Float, offsetof(TelemetrySnapshot, vy)},
+    {LogName::Velocity, "stateEstimate.vz", TelemetryFieldType::Float, offsetof(TelemetrySnapshot, vz)},
+    {LogName::Range, "range.front", TelemetryFieldType::UInt16, offsetof(TelemetrySnapshot, rangeFront)},
+    {LogName::Range, "range.left", TelemetryFieldType::UInt16, offsetof(TelemetrySnapshot, rangeLeft)},
+    {LogName::Range, "range.back", TelemetryFieldType::UInt16, offsetof(TelemetrySnapshot, rangeBack)},
+    {LogName::Range, "range.right", TelemetryFieldType::UInt16, offsetof(TelemetrySnapshot, rangeRight)},
+    {LogName::Range, "range.up", TelemetryFieldType::UInt16, offsetof(TelemetrySnapshot, rangeUp)},
+    {LogName::Range, "range.zrange", TelemetryFieldType::UInt16, offsetof(TelemetrySnapshot, rangeZrange)},
+    {LogName::Rssi, "radio.rssi", TelemetryFieldType::UInt8, offsetof(TelemetrySnapshot, rssi)},
+    {LogName::DroneStatus, "hivexplore.droneStatus", TelemetryFieldType::UInt8, offsetof(TelemetrySnapshot, droneStatus)},
+}};
+
+// Group bit of each field descriptor, computed at compile time to keep the mask checks out of the serialization loops
+constexpr std::array<TelemetryGroupMask, telemetryFields.size()> telemetryFieldGroupBits = [] {
+    std::array<TelemetryGroupMask, telemetryFields.size()> groupBits = {};
+    for (std::size_t i = 0; i < telemetryFields.size(); i++) {
+        groupBits[i] = telemetryGroupBit(telemetryFields[i].logName);
+    }
+    return groupBits;
+}();
+
+// Size of the snapshot once serialized without padding
+constexpr std::size_t telemetrySnapshotPackedSize() {
+    std::size_t size = 0;
+    for (const auto& field : telemetryFields) {
+        size += telemetryFieldSize(field.type);
+    }
+    return size;
+}
+
+#endif
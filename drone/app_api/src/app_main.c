@@ -13,6 +13,14 @@
 #include "commander.h"
 #include "configblock.h"
 #include "sitaw.h"
+#include "sensor_snapshot.h"
+#include "occupancy_grid.h"
+#include "breadcrumb_trail.h"
+#include "battery_estimator.h"
+#include "motors.h"
+#include "p2p_neighbours.h"
+#include "p2p_packet.h"
+#include "mapping_stream.h"
 #include "app_main.h"
 
 #define DEBUG_MODULE "APPAPI"
@@ -20,25 +28,6 @@
 // Min helper macro
 #define MIN(a, b) ((a < b) ? a : b)
 
-// Structs
-typedef struct {
-    float x;
-    float y;
-    float z;
-    uint8_t sourceId;
-} P2PPacketContent;
-
-// Reference voltages - voltages for battery levels from 0% to 100% in 5% increment
-// Voltages for battery levels when idle, landed or crashed
-static const float IDLE_REFERENCE_VOLTAGES[] = {
-    3.27, 3.61, 3.69, 3.71, 3.73, 3.75, 3.77, 3.79, 3.80, 3.82, 3.84, 3.85, 3.87, 3.91, 3.95, 3.98, 4.02, 4.08, 4.11, 4.15, 4.20,
-};
-// Voltages for battery levels during flight
-static const float FLYING_REFERENCE_VOLTAGES[] = {
-    2.350, 3.113, 3.299, 3.324, 3.345, 3.360, 3.380, 3.416, 3.433, 3.452, 3.464,
-    3.481, 3.500, 3.539, 3.571, 3.599, 3.653, 3.716, 3.783, 3.844, 3.910,
-};
-
 // Constants
 static const uint16_t OBSTACLE_DETECTED_THRESHOLD = 300;
 static const uint16_t EDGE_DETECTED_THRESHOLD = 400;
@@ -47,12 +36,13 @@ static const float EXPLORATION_HEIGHT = 0.3f;
 static const float CRUISE_VELOCITY = 0.2f;
 static const float MAXIMUM_VELOCITY = 0.4f;
 static const uint16_t METER_TO_MILLIMETER_FACTOR = 1000;
-static const uint8_t INITIAL_LOW_BATTERY_IGNORED_TICKS = 40;
 static const uint64_t INITIAL_REORIENTATION_TICKS = 100;
 static const uint64_t MAXIMUM_REORIENTATION_TICKS = 600;
 static const uint16_t MAXIMUM_RETURN_TICKS = 800;
 static const uint64_t INITIAL_EXPLORE_TICKS = 600;
 static const uint16_t CLEAR_OBSTACLE_TICKS = 100;
+static const uint32_t LOOP_PERIOD_MS = 10; // Duration of the ticks counted by the timers
+static const uint16_t FRONTIER_REPLAN_TICKS = 100;
 
 // States
 static mission_state_t missionState = MISSION_STANDBY;
@@ -64,11 +54,13 @@ static emergency_state_t emergencyState = EMERGENCY_LAND;
 static point_t initialPosition;
 static setpoint_t setPoint;
 static uint8_t batteryLevel = 0;
-static bool isBatteryBelowMinimumThreshold = false;
+static bool isReturnChargeReached = false;
 static drone_status_t droneStatus = STATUS_STANDBY;
 static bool isLedEnabled = false;
 static bool shouldTurnLeft = true;
 static point_t baseOffset = {};
+static bool isLoopEventDriven = true; // Run when new data is notified instead of polling it at a fixed period
+static uint8_t explorationMode = EXPLORATION_WALL_BOUNCE;
 
 // Readings
 static float batteryVoltageReading;
@@ -76,6 +68,7 @@ static float rollReading;
 static float pitchReading;
 static float yawReading;
 static point_t positionReading;
+static velocity_t velocityReading;
 static uint16_t frontSensorReading;
 static uint16_t leftSensorReading;
 static uint16_t backSensorReading;
@@ -92,7 +85,6 @@ static float targetYawRate;
 static float targetYaw;
 
 // Timers (explore)
-static uint8_t lowBatteryIgnoredCounter = INITIAL_LOW_BATTERY_IGNORED_TICKS; // To protect from low voltage spikes triggering return
 static uint16_t reorientationWatchdog = INITIAL_REORIENTATION_TICKS; // To reorient away from the swarm's center of mass
 static uint8_t rotationChangeWatchdog; // To randomly change exploration rotation direction
 
@@ -102,30 +94,30 @@ static uint64_t maximumExploreTicks = INITIAL_EXPLORE_TICKS;
 static uint64_t exploreWatchdog = INITIAL_EXPLORE_TICKS; // Prevent staying stuck in forward state by attempting to beeline periodically
 static uint16_t clearObstacleCounter = CLEAR_OBSTACLE_TICKS; // Ensure obstacles are sufficiently cleared before resuming
 
-// Latest P2P packets
-#define MAX_DRONE_COUNT 256
-static P2PPacketContent latestP2PPackets[MAX_DRONE_COUNT];
-static uint8_t activeP2PIds[MAX_DRONE_COUNT] = {};
-static uint8_t activeP2PIdsCount = 0;
+// Return to base path, followed one breadcrumb at a time
+static bool isReturnWaypointPlanned = false;
+static point_t returnWaypoint; // In the state estimate's frame
+
+// Frontier exploration
+static bool hasFrontierTarget = false;
+static point_t frontierTarget; // In the state estimate's frame
+static uint16_t frontierReplanWatchdog = 0; // Only search for a frontier periodically, the search covers the whole grid
+
+// P2P
+static uint8_t droneId;
+static p2pNeighbour_t neighbours[P2P_NEIGHBOURS_MAX_COUNT]; // Neighbours which broadcast their position recently
+static uint8_t neighbourCount = 0;
+
+// Explored cells, the latest cells the drone flew over are shared with its neighbours
+#define RECENT_CELL_COUNT 32
+static int16_t recentCellColumns[RECENT_CELL_COUNT];
+static int16_t recentCellRows[RECENT_CELL_COUNT];
+static uint8_t recentCellCount = 0;
+static uint8_t latestRecentCellIndex = 0;
 
 void appMain(void) {
     vTaskDelay(M2T(3000));
 
-    const logVarId_t batteryVoltageId = logGetVarId("pm", "vbat");
-    const logVarId_t rollId = logGetVarId("stateEstimate", "roll");
-    const logVarId_t pitchId = logGetVarId("stateEstimate", "pitch");
-    const logVarId_t yawId = logGetVarId("stateEstimate", "yaw");
-    const logVarId_t positionXId = logGetVarId("stateEstimate", "x");
-    const logVarId_t positionYId = logGetVarId("stateEstimate", "y");
-    const logVarId_t positionZId = logGetVarId("stateEstimate", "z");
-    const logVarId_t frontSensorId = logGetVarId("range", "front");
-    const logVarId_t leftSensorId = logGetVarId("range", "left");
-    const logVarId_t backSensorId = logGetVarId("range", "back");
-    const logVarId_t rightSensorId = logGetVarId("range", "right");
-    const logVarId_t upSensorId = logGetVarId("range", "up");
-    const logVarId_t downSensorId = logGetVarId("range", "zrange");
-    const logVarId_t rssiId = logGetVarId("radio", "rssi");
-
     const paramVarId_t flowDeckModuleId = paramGetVarId("deck", "bcFlow2");
     const paramVarId_t multirangerModuleId = paramGetVarId("deck", "bcMultiranger");
 
@@ -139,40 +131,68 @@ void appMain(void) {
         DEBUG_PRINT("Multiranger is not connected\n");
     }
 
+    droneId = (uint8_t)(configblockGetRadioAddress() & 0x00000000ff);
+    p2pNeighboursInit();
+    mappingStreamInit();
     p2pRegisterCB(p2pReceivedCallback);
 
-    initialPosition.x = logGetFloat(positionXId);
-    initialPosition.y = logGetFloat(positionYId);
-    initialPosition.z = logGetFloat(positionZId);
+    // Every reading is copied from the same snapshot, so the position and the attitude always come from the same state estimate
+    sensorSnapshot_t snapshot;
+    sensorSnapshotGet(&snapshot);
+    initialPosition = snapshot.position;
 
     DEBUG_PRINT("Initial position: %f, %f\n", (double)initialPosition.x, (double)initialPosition.y);
 
     rotationChangeWatchdog = getRandomRotationChangeCount();
 
+    TickType_t lastWakeTime = xTaskGetTickCount();
+
     while (true) {
-        vTaskDelay(M2T(10));
+        const uint32_t events = waitForNewData(&lastWakeTime);
 
         ledSet(LED_GREEN_R, isLedEnabled);
 
-        batteryVoltageReading = logGetFloat(batteryVoltageId);
+        sensorSnapshotGet(&snapshot);
+
+        batteryVoltageReading = snapshot.batteryVoltage;
         updateBatteryLevel();
 
-        rollReading = logGetFloat(rollId);
-        pitchReading = logGetFloat(pitchId);
-        yawReading = logGetFloat(yawId);
+        rollReading = snapshot.attitude.roll;
+        pitchReading = snapshot.attitude.pitch;
+        yawReading = snapshot.attitude.yaw;
 
-        positionReading.x = logGetFloat(positionXId);
-        positionReading.y = logGetFloat(positionYId);
-        positionReading.z = logGetFloat(positionZId);
+        positionReading = snapshot.position;
+        velocityReading = snapshot.velocity;
 
-        frontSensorReading = logGetUint(frontSensorId);
-        leftSensorReading = logGetUint(leftSensorId);
-        backSensorReading = logGetUint(backSensorId);
-        rightSensorReading = logGetUint(rightSensorId);
-        upSensorReading = logGetUint(upSensorId);
-        downSensorReading = logGetUint(downSensorId);
+        if (events & APP_EVENT_RANGE_UPDATED) {
+            frontSensorReading = snapshot.ranges[rangeFront];
+            leftSensorReading = snapshot.ranges[rangeLeft];
+            backSensorReading = snapshot.ranges[rangeBack];
+            rightSensorReading = snapshot.ranges[rangeRight];
+            upSensorReading = snapshot.ranges[rangeUp];
 
-        rssiReading = logGetUint(rssiId);
+            // Readings on the ground or while taking off would map the drone's surroundings at the wrong height
+            if (droneStatus == STATUS_FLYING || droneStatus == STATUS_RETURNING) {
+                occupancyGridAddRangeReadings(&positionReading, yawReading, snapshot.ranges);
+            }
+        }
+        downSensorReading = snapshot.ranges[rangeDown];
+
+        // The trail is only recorded while exploring, the return pops its breadcrumbs instead so that it does not oscillate between the
+        // latest breadcrumb and the drone's position
+        if (droneStatus == STATUS_FLYING) {
+            breadcrumbTrailAdd(&positionReading);
+        }
+
+        rssiReading = snapshot.rssi;
+
+        // Every range update is streamed to the server with the pose it was measured at
+        if (events & APP_EVENT_RANGE_UPDATED) {
+            mappingStreamAddScan(&snapshot);
+        }
+        mappingStreamUpdate();
+
+        neighbourCount = p2pNeighboursGetFresh(neighbours);
 
         targetForwardVelocity = 0.0;
         targetLeftVelocity = 0.0;
@@ -191,9 +211,11 @@ void appMain(void) {
             (missionState == MISSION_RETURNING && returningState == RETURNING_IDLE) ||
             (missionState == MISSION_EMERGENCY && emergencyState == EMERGENCY_IDLE);
 
-        static const uint8_t broadcastProbabilityPercentage = 5;
-        if (!shouldNotBroadcastPosition && (rand() % 100) < broadcastProbabilityPercentage) {
-            broadcastPosition();
+        if (!shouldNotBroadcastPosition) {
+            updateRecentCells();
+            if (p2pIsBroadcastDue(droneId)) {
+                broadcastPosition();
+            }
         }
 
         switch (missionState) {
@@ -204,7 +226,7 @@ void appMain(void) {
         case MISSION_EXPLORING:
             avoidDrones();
             avoidObstacles();
-            if (isBatteryBelowMinimumThreshold) {
+            if (isReturnChargeReached) {
                 returnToBase();
             } else {
                 explore();
@@ -234,19 +256,56 @@ void appMain(void) {
     }
 }
 
+uint32_t waitForNewData(TickType_t* lastWakeTime) {
+    static const uint32_t allEvents = APP_EVENT_STATE_UPDATED | APP_EVENT_RANGE_UPDATED;
+    static bool isWaitingForEvents = true;
+    static bool isNextStateUpdateSkipped = false;
+
+    while (isLoopEventDriven && isWaitingForEvents) {
+        // The state estimate is notified every period, so missing notifications mean the firmware does not send them
+        const uint32_t events = appWaitForEvents(M2T(2 * LOOP_PERIOD_MS));
+        if (events == 0) {
+            DEBUG_PRINT("No data notified, running at a fixed period\n");
+            isWaitingForEvents = false;
+            *lastWakeTime = xTaskGetTickCount();
+            break;
+        }
+
+        // New ranges are handled right away and replace the next state update, so that the loop still runs once per period
+        // and the timers keep their durations
+        if (!(events & APP_EVENT_STATE_UPDATED)) {
+            isNextStateUpdateSkipped = true;
+            return events;
+        }
+        if (!isNextStateUpdateSkipped || (events & APP_EVENT_RANGE_UPDATED)) {
+            isNextStateUpdateSkipped = false;
+            return events;
+        }
+        isNextStateUpdateSkipped = false;
+    }
+
+    // Fallback without drift, every reading is refreshed since there is no way to know which ones are new
+    vTaskDelayUntil(lastWakeTime, M2T(LOOP_PERIOD_MS));
+    if (isLoopEventDriven && appWaitForEvents(0) != 0) {
+        isWaitingForEvents = true;
+        isNextStateUpdateSkipped = false;
+    }
+    return allEvents;
+}
+
 void avoidDrones(void) {
-    for (uint8_t i = 0; i < activeP2PIdsCount; i++) {
+    for (uint8_t i = 0; i < neighbourCount; i++) {
         vector_t vectorAwayFromDrone = {
-            .x = (positionReading.x + baseOffset.x) - latestP2PPackets[activeP2PIds[i]].x,
-            .y = (positionReading.y + baseOffset.y) - latestP2PPackets[activeP2PIds[i]].y,
-            .z = (positionReading.z + baseOffset.z) - latestP2PPackets[activeP2PIds[i]].z,
+            .x = (positionReading.x + baseOffset.x) - neighbours[i].predictedPosition.x,
+            .y = (positionReading.y + baseOffset.y) - neighbours[i].predictedPosition.y,
+            .z = (positionReading.z + baseOffset.z) - neighbours[i].predictedPosition.z,
         };
 
         const float vectorMagnitude = sqrtf(vectorAwayFromDrone.x * vectorAwayFromDrone.x + vectorAwayFromDrone.y * vectorAwayFromDrone.y +
                                             vectorAwayFromDrone.z * vectorAwayFromDrone.z);
         static const float DRONE_AVOIDANCE_THRESHOLD = 1.0f;
         if (vectorMagnitude > DRONE_AVOIDANCE_THRESHOLD) {
-            return;
+            continue;
         }
 
         const vector_t unitVectorAway = {
@@ -285,14 +344,11 @@ void avoidObstacles(void) {
 }
 
 void explore(void) {
-    static const uint8_t lowBatteryThreshold = 30;
-    if (batteryLevel < lowBatteryThreshold) {
-        if (lowBatteryIgnoredCounter == 0) {
-            isBatteryBelowMinimumThreshold = true;
-            DEBUG_PRINT("Low battery\n");
-        } else {
-            lowBatteryIgnoredCounter--;
-        }
+    // Return just in time to fly back along the breadcrumb trail, which is never shorter than the path taken
+    const float returnStateOfCharge = batteryEstimatorGetReturnStateOfCharge(breadcrumbTrailGetLength(&positionReading), CRUISE_VELOCITY);
+    if (droneStatus == STATUS_FLYING && batteryEstimatorGetStateOfCharge() < returnStateOfCharge) {
+        isReturnChargeReached = true;
+        DEBUG_PRINT("Low battery\n");
     }
 
     switch (exploringState) {
@@ -319,8 +375,14 @@ void explore(void) {
     case EXPLORING_EXPLORE: {
         droneStatus = STATUS_FLYING;
 
-        // Only reorient away from the center of mass when other drones are detected
-        if (activeP2PIdsCount > 0) {
+        // Frontier exploration spreads the drones with claimed frontiers instead of reorienting away from the center of mass,
+        // and bounces off walls like the default exploration when it has no frontier to go to
+        if (explorationMode == EXPLORATION_FRONTIER) {
+            if (exploreFrontier()) {
+                break;
+            }
+        } else if (neighbourCount > 0) {
+            // Only reorient away from the center of mass when other drones are detected
             if (reorientationWatchdog == 0) {
                 targetHeight = EXPLORATION_HEIGHT;
                 updateWaypoint();
@@ -333,6 +395,11 @@ void explore(void) {
         }
 
         if (!forward()) {
+            // Turn towards the least explored heading, the random rotation changes are only used while the map has no preference
+            float leastExploredHeading;
+            if (occupancyGridFindLeastExploredHeading(&positionReading, &leastExploredHeading)) {
+                shouldTurnLeft = normalizeAngle(leastExploredHeading - yawReading) >= 0.0f;
+            }
             exploringState = EXPLORING_ROTATE;
         }
     } break;
@@ -361,6 +428,60 @@ void explore(void) {
     }
 }
 
+// Returns false when there is no frontier to go to
+bool exploreFrontier(void) {
+    if (frontierReplanWatchdog > 0) {
+        frontierReplanWatchdog--;
+    } else {
+        // Neighbours' frontiers are in the swarm's shared frame. Drones which are returning, on low battery or otherwise, no longer
+        // hold the frontier they were heading to
+        point_t claimedFrontiers[P2P_NEIGHBOURS_MAX_COUNT];
+        uint8_t claimedFrontierCount = 0;
+        for (uint8_t i = 0; i < neighbourCount; i++) {
+            if (neighbours[i].content.hasClaimedFrontier && neighbours[i].content.droneStatus == STATUS_FLYING) {
+                claimedFrontiers[claimedFrontierCount].x = neighbours[i].content.claimedFrontierX - baseOffset.x;
+                claimedFrontiers[claimedFrontierCount].y = neighbours[i].content.claimedFrontierY - baseOffset.y;
+                claimedFrontierCount++;
+            }
+        }
+
+        hasFrontierTarget = occupancyGridFindNearestFrontier(&positionReading, claimedFrontiers, claimedFrontierCount,
+                                                             isExploredByNeighbours, &frontierTarget);
+        frontierReplanWatchdog = FRONTIER_REPLAN_TICKS;
+    }
+
+    if (!hasFrontierTarget) {
+        return false;
+    }
+
+    const float deltaX = frontierTarget.x - positionReading.x;
+    const float deltaY = frontierTarget.y - positionReading.y;
+    static const float frontierReachedDistance = 0.3f;
+    if (sqrtf(deltaX * deltaX + deltaY * deltaY) < frontierReachedDistance) {
+        hasFrontierTarget = false;
+        frontierReplanWatchdog = 0;
+        return false;
+    }
+
+    // Face the frontier before flying towards it, so that the front sensor watches the way
+    const float frontierHeading = atan2f(deltaY, deltaX) * 360.0f / (2.0f * (float)M_PI);
+    static const float headingTolerance = 20.0f;
+    if ((float)fabs(normalizeAngle(frontierHeading - yawReading)) < headingTolerance) {
+        // Bounce off the obstacle like the default exploration until the next search, which will find a way around it
+        if (frontSensorReading < EDGE_DETECTED_THRESHOLD) {
+            hasFrontierTarget = false;
+            return false;
+        }
+        targetForwardVelocity += CRUISE_VELOCITY;
+    }
+
+    targetHeight = EXPLORATION_HEIGHT;
+    updateWaypoint();
+    setPoint.mode.yaw = modeAbs;
+    setPoint.attitude.yaw = frontierHeading;
+    return true;
+}
+
 void returnToBase(void) {
     // If returned to base, land
     static const float distanceToReturnEpsilon = 0.3f;
@@ -378,9 +499,17 @@ void returnToBase(void) {
     case RETURNING_ROTATE_TOWARDS_BASE: {
         droneStatus = STATUS_RETURNING;
 
-        // Calculate rotation angle to turn towards base
+        // Only plan once per leg, the search checks the grid along the path to every breadcrumb
+        if (!isReturnWaypointPlanned) {
+            if (!breadcrumbTrailGetNextWaypoint(&positionReading, &returnWaypoint)) {
+                returnWaypoint = initialPosition;
+            }
+            isReturnWaypointPlanned = true;
+        }
+
+        // Calculate rotation angle to turn towards the next waypoint
         targetYaw =
-            (float)atan2(initialPosition.y - positionReading.y, initialPosition.x - positionReading.x) * 360.0f / (2.0f * (float)M_PI);
+            (float)atan2(returnWaypoint.y - positionReading.y, returnWaypoint.x - positionReading.x) * 360.0f / (2.0f * (float)M_PI);
 
         if (rotateToTargetYaw()) {
             returningState = RETURNING_RETURN;
@@ -389,6 +518,17 @@ void returnToBase(void) {
     case RETURNING_RETURN: {
         droneStatus = STATUS_RETURNING;
 
+        // Head to the next breadcrumb once this one is reached, the base is reached when the drone lands
+        const float deltaX = returnWaypoint.x - positionReading.x;
+        const float deltaY = returnWaypoint.y - positionReading.y;
+        static const float waypointReachedDistance = 0.3f;
+        if (breadcrumbTrailGetCount() > 1 && sqrtf(deltaX * deltaX + deltaY * deltaY) < waypointReachedDistance) {
+            returnWatchdog = MAXIMUM_RETURN_TICKS;
+            isReturnWaypointPlanned = false;
+            returningState = RETURNING_ROTATE_TOWARDS_BASE;
+            break;
+        }
+
         // Go to explore algorithm when a wall is detected in front or return watchdog is finished
         if (!forward() || returnWatchdog == 0) {
             if (returnWatchdog == 0) {
@@ -403,6 +543,10 @@ void returnToBase(void) {
             returningState = RETURNING_ROTATE;
         } else {
             returnWatchdog--;
+
+            // Keep facing the waypoint, since the velocity setpoints are in the body frame
+            setPoint.mode.yaw = modeAbs;
+            setPoint.attitude.yaw = atan2f(deltaY, deltaX) * 360.0f / (2.0f * (float)M_PI);
         }
     } break;
     case RETURNING_ROTATE: {
@@ -436,6 +580,7 @@ void returnToBase(void) {
             shouldTurnLeft = !shouldTurnLeft;
 
             DEBUG_PRINT("Explore: Rotating towards base\n");
+            isReturnWaypointPlanned = false;
             returningState = RETURNING_ROTATE_TOWARDS_BASE;
             break;
         }
@@ -580,8 +725,9 @@ void resetInternalStates(void) {
     returningState = RETURNING_ROTATE_TOWARDS_BASE;
     emergencyState = EMERGENCY_LAND;
 
-    isBatteryBelowMinimumThreshold = false;
-    lowBatteryIgnoredCounter = INITIAL_LOW_BATTERY_IGNORED_TICKS;
+    isReturnChargeReached = false;
+    // The voltage is only accurate at rest, which is when the drone waits for the mission
+    batteryEstimatorReset(batteryVoltageReading);
 
     reorientationWatchdog = INITIAL_REORIENTATION_TICKS;
 
@@ -592,79 +738,109 @@ void resetInternalStates(void) {
     maximumExploreTicks = INITIAL_EXPLORE_TICKS;
     exploreWatchdog = INITIAL_EXPLORE_TICKS;
     clearObstacleCounter = CLEAR_OBSTACLE_TICKS;
+    isReturnWaypointPlanned = false;
+    breadcrumbTrailReset(&initialPosition);
+
+    p2pNeighboursClear();
+    neighbourCount = 0;
+    recentCellCount = 0;
+    occupancyGridReset();
 
-    activeP2PIdsCount = 0;
+    hasFrontierTarget = false;
+    frontierReplanWatchdog = 0;
 }
 
-uint8_t calculateBatteryLevel(const float referenceVoltages[], size_t referenceVoltagesSize) {
-    if (batteryVoltageReading <= referenceVoltages[0]) {
-        return 0;
+void updateBatteryLevel(void) {
+    const bool isFlying = droneStatus != STATUS_STANDBY && droneStatus != STATUS_LANDED && droneStatus != STATUS_CRASHED;
+    uint16_t motorRatios[BATTERY_ESTIMATOR_MOTOR_COUNT];
+    for (uint8_t i = 0; i < BATTERY_ESTIMATOR_MOTOR_COUNT; i++) {
+        motorRatios[i] = (uint16_t)motorsGetRatio(MOTOR_M1 + i);
     }
 
-    if (batteryVoltageReading >= referenceVoltages[referenceVoltagesSize - 1]) {
-        return 100;
-    }
+    // The loop runs once per period, whether it is woken up by new data or not
+    batteryEstimatorUpdate(batteryVoltageReading, isFlying, motorRatios, LOOP_PERIOD_MS / 1000.0f);
+    batteryLevel = (uint8_t)roundf(batteryEstimatorGetStateOfCharge() * 100.0f);
+}
 
-    uint8_t referenceVoltageIndex = 0;
-    while (batteryVoltageReading > referenceVoltages[referenceVoltageIndex]) {
-        referenceVoltageIndex++;
+void updateRecentCells(void) {
+    const int16_t column = (int16_t)floorf((positionReading.x + baseOffset.x) / P2P_EXPLORED_CELL_SIZE);
+    const int16_t row = (int16_t)floorf((positionReading.y + baseOffset.y) / P2P_EXPLORED_CELL_SIZE);
+    if (recentCellCount > 0 && recentCellColumns[latestRecentCellIndex] == column && recentCellRows[latestRecentCellIndex] == row) {
+        return;
     }
 
-    static const uint8_t PERCENTAGE_DELTA = 5;
-    float voltageDelta = (referenceVoltages[referenceVoltageIndex] - referenceVoltages[referenceVoltageIndex - 1]) / PERCENTAGE_DELTA;
-    return referenceVoltageIndex * PERCENTAGE_DELTA - (referenceVoltages[referenceVoltageIndex] - batteryVoltageReading) / voltageDelta;
+    // Overwrite the oldest cell once the buffer is full
+    latestRecentCellIndex = recentCellCount > 0 ? (latestRecentCellIndex + 1) % RECENT_CELL_COUNT : 0;
+    recentCellColumns[latestRecentCellIndex] = column;
+    recentCellRows[latestRecentCellIndex] = row;
+    if (recentCellCount < RECENT_CELL_COUNT) {
+        recentCellCount++;
+    }
 }
 
-void updateBatteryLevel(void) {
-    if (droneStatus == STATUS_STANDBY || droneStatus == STATUS_LANDED || droneStatus == STATUS_CRASHED) {
-        batteryLevel = calculateBatteryLevel(IDLE_REFERENCE_VOLTAGES, sizeof(IDLE_REFERENCE_VOLTAGES) / sizeof(IDLE_REFERENCE_VOLTAGES[0]));
-    } else {
-        batteryLevel =
-            calculateBatteryLevel(FLYING_REFERENCE_VOLTAGES, sizeof(FLYING_REFERENCE_VOLTAGES) / sizeof(FLYING_REFERENCE_VOLTAGES[0]));
+bool isExploredByNeighbours(float x, float y) {
+    // The neighbours' explored cells are counted from the swarm's shared frame's origin
+    const int16_t column = (int16_t)floorf((x + baseOffset.x) / P2P_EXPLORED_CELL_SIZE);
+    const int16_t row = (int16_t)floorf((y + baseOffset.y) / P2P_EXPLORED_CELL_SIZE);
+    for (uint8_t i = 0; i < neighbourCount; i++) {
+        const p2pPacketContent_t* content = &neighbours[i].content;
+        const int16_t bitmapColumn = column - content->exploredCellsColumn;
+        const int16_t bitmapRow = row - content->exploredCellsRow;
+        if (bitmapColumn >= 0 && bitmapRow >= 0 && bitmapColumn < P2P_EXPLORED_CELLS_SIDE && bitmapRow < P2P_EXPLORED_CELLS_SIDE &&
+            (content->exploredCells & ((uint64_t)1 << (bitmapRow * P2P_EXPLORED_CELLS_SIDE + bitmapColumn)))) {
+            return true;
+        }
     }
+    return false;
 }
 
 void broadcastPosition(void) {
-    // Avoid causing drone reset due to the content size
-    if (sizeof(P2PPacketContent) > P2P_MAX_DATA_SIZE) {
-        DEBUG_PRINT("P2PPacketContent size too big\n");
+    if (!crtpIsConnected()) {
         return;
     }
 
-    uint64_t radioAddress = configblockGetRadioAddress();
-    uint8_t id = (uint8_t)(radioAddress & 0x00000000ff);
-
-    P2PPacketContent content = {
-        .x = positionReading.x + baseOffset.x,
-        .y = positionReading.y + baseOffset.y,
-        .z = positionReading.z + baseOffset.z,
-        .sourceId = id,
+    p2pPacketContent_t content = {
+        .sourceId = droneId,
+        .position =
+            {
+                .x = positionReading.x + baseOffset.x,
+                .y = positionReading.y + baseOffset.y,
+                .z = positionReading.z + baseOffset.z,
+            },
+        .velocity = velocityReading,
+        .yaw = yawReading,
+        .batteryLevel = batteryLevel,
+        .droneStatus = droneStatus,
+        .hasClaimedFrontier = explorationMode == EXPLORATION_FRONTIER && hasFrontierTarget,
+        .claimedFrontierX = frontierTarget.x + baseOffset.x,
+        .claimedFrontierY = frontierTarget.y + baseOffset.y,
     };
 
-    P2PPacket packet = {.port = 0x00, .size = sizeof(content)};
-
-    if (crtpIsConnected()) {
-        memcpy(&packet.data[0], &content, sizeof(content));
-        radiolinkSendP2PPacketBroadcast(&packet);
+    // Recent cells are sent relative to the bitmap's corner, which is centered on the drone's cell
+    if (recentCellCount > 0) {
+        content.exploredCellsColumn = recentCellColumns[latestRecentCellIndex] - P2P_EXPLORED_CELLS_SIDE / 2;
+        content.exploredCellsRow = recentCellRows[latestRecentCellIndex] - P2P_EXPLORED_CELLS_SIDE / 2;
     }
+    for (uint8_t i = 0; i < recentCellCount; i++) {
+        const int16_t column = recentCellColumns[i] - content.exploredCellsColumn;
+        const int16_t row = recentCellRows[i] - content.exploredCellsRow;
+        if (column >= 0 && row >= 0 && column < P2P_EXPLORED_CELLS_SIDE && row < P2P_EXPLORED_CELLS_SIDE) {
+            content.exploredCells |= (uint64_t)1 << (row * P2P_EXPLORED_CELLS_SIDE + column);
+        }
+    }
+
+    P2PPacket packet;
+    p2pPacketEncode(&content, &packet);
+    radiolinkSendP2PPacketBroadcast(&packet);
 }
 
 void p2pReceivedCallback(P2PPacket* packet) {
-    P2PPacketContent content;
-    memcpy(&content, packet->data, sizeof(P2PPacketContent));
-    latestP2PPackets[content.sourceId] = content;
-    bool isAlreadyInContactWithSource = false;
-    for (uint8_t i = 0; i < activeP2PIdsCount; i++) {
-        if (activeP2PIds[i] == content.sourceId) {
-            isAlreadyInContactWithSource = true;
-            break;
-        }
+    p2pPacketContent_t content;
+    if (!p2pPacketDecode(packet, &content) || content.sourceId == droneId) {
+        return;
     }
 
-    if (!isAlreadyInContactWithSource) {
-        activeP2PIds[activeP2PIdsCount] = content.sourceId;
-        activeP2PIdsCount++;
-    }
+    p2pNeighboursUpdate(&content);
 }
 
 float calculateAngleAwayFromCenterOfMass(void) {
@@ -676,14 +852,13 @@ float calculateAngleAwayFromCenterOfMass(void) {
     point_t centerOfMass = currentPosition;
 
     // Sum of other drones' received positions
-    for (uint8_t i = 0; i < activeP2PIdsCount; i++) {
-        P2PPacketContent content = latestP2PPackets[activeP2PIds[i]];
-        centerOfMass.x += content.x;
-        centerOfMass.y += content.y;
+    for (uint8_t i = 0; i < neighbourCount; i++) {
+        centerOfMass.x += neighbours[i].predictedPosition.x;
+        centerOfMass.y += neighbours[i].predictedPosition.y;
     }
 
-    centerOfMass.x /= (activeP2PIdsCount + 1);
-    centerOfMass.y /= (activeP2PIdsCount + 1);
+    centerOfMass.x /= (neighbourCount + 1);
+    centerOfMass.y /= (neighbourCount + 1);
 
     vector_t vectorAway = {
         .x = currentPosition.x - centerOfMass.x,
@@ -717,6 +892,15 @@ uint8_t getRandomRotationChangeCount(void) {
     return rand() % (maxRotationCount - minRotationCount + 1) + minRotationCount;
 }
 
+// Returns the equivalent angle in [-180, 180[ degrees
+float normalizeAngle(float angle) {
+    angle = fmodf(angle + 180.0f, 360.0f);
+    if (angle < 0.0f) {
+        angle += 360.0f;
+    }
+    return angle - 180.0f;
+}
+
 LOG_GROUP_START(hivexplore)
 LOG_ADD(LOG_UINT8, batteryLevel, &batteryLevel)
 LOG_ADD(LOG_UINT8, droneStatus, &droneStatus)
@@ -728,4 +912,6 @@ PARAM_ADD(PARAM_UINT8, isLedEnabled, &isLedEnabled)
 PARAM_ADD(PARAM_FLOAT, baseOffsetX, &baseOffset.x)
 PARAM_ADD(PARAM_FLOAT, baseOffsetY, &baseOffset.y)
 PARAM_ADD(PARAM_FLOAT, baseOffsetZ, &baseOffset.z)
+PARAM_ADD(PARAM_UINT8, isLoopEventDriven, &isLoopEventDriven)
+PARAM_ADD(PARAM_UINT8, explorationMode, &explorationMode)
 PARAM_GROUP_STOP(hivexplore)
@@ -2,6 +2,7 @@
 #define APP_MAIN_H
 
 #include <stdbool.h>
+#include "FreeRTOS.h"
 #include "radiolink.h"
 
 typedef enum {
@@ -44,9 +45,17 @@ typedef enum {
     STATUS_CRASHED,
 } drone_status_t;
 
+typedef enum {
+    EXPLORATION_WALL_BOUNCE,
+    EXPLORATION_FRONTIER,
+} exploration_mode_t;
+
+uint32_t waitForNewData(TickType_t* lastWakeTime);
+
 void avoidDrones(void);
 void avoidObstacles(void);
 void explore(void);
+bool exploreFrontier(void);
 void returnToBase(void);
 void emergencyLand(void);
 bool liftoff(void);
@@ -58,9 +67,10 @@ bool isCrashed(void);
 
 void resetInternalStates(void);
 
-uint8_t calculateBatteryLevel(const float referenceVoltages[], size_t referenceVoltagesSize);
 void updateBatteryLevel(void);
 
+void updateRecentCells(void);
+bool isExploredByNeighbours(float x, float y);
 void broadcastPosition(void);
 void p2pReceivedCallback(P2PPacket* packet);
 
@@ -70,5 +80,6 @@ void updateWaypoint(void);
 
 uint16_t calculateObstacleDistanceCorrection(uint16_t obstacleThreshold, uint16_t sensorReading);
 uint8_t getRandomRotationChangeCount(void);
+float normalizeAngle(float angle);
 
 #endif
@@ -0,0 +1,194 @@
+#include <math.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "app_channel.h"
+#include "crtp.h"
+#include "log.h"
+#include "mapping_stream.h"
+
+static const float METER_TO_MILLIMETER_FACTOR = 1000.0f;
+static const float DEGREE_TO_CENTIDEGREE_FACTOR = 100.0f;
+static const float DEGREE_TO_DECIDEGREE_FACTOR = 10.0f;
+static const float MILLIMETER_TO_CENTIMETER_FACTOR = 0.1f;
+// Sending a packet per record at 100 Hz is 20 times the multiranger's rate, which leaves room to catch up after retransmit requests
+static const uint8_t MAX_PACKETS_PER_UPDATE = 2;
+// Free packets left in the radio's queue for the other CRTP ports
+static const int TX_QUEUE_RESERVE = 30;
+
+_Static_assert(sizeof(mappingStreamScanRecord_t) <= APPCHANNEL_MTU, "Scan record must fit in an app channel packet");
+
+static bool isInit = false;
+static mappingStreamScanRecord_t records[MAPPING_STREAM_BUFFER_SIZE]; // Indexed by sequence modulo the buffer size
+static uint16_t nextSequence = 0; // Sequence of the next record added
+static uint16_t nextSentSequence = 0;
+static uint16_t storedRecordCount = 0;
+static uint32_t lastRangesTimestamp = 0;
+static mappingStreamScanRecord_t pendingRecord;
+static bool hasPendingScan = false;
+static float pendingYaw; // deg, as quantized in the pending record
+
+static uint16_t retransmitSequence = 0;
+static uint8_t retransmitCount = 0;
+
+// Statistics
+static uint32_t overrunCount = 0; // Records overwritten before they were sent
+static uint32_t retransmittedCount = 0;
+
+static int16_t quantizeInt16(float value, float factor) {
+    const float quantizedValue = roundf(value * factor);
+    if (quantizedValue > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (quantizedValue < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return (int16_t)quantizedValue;
+}
+
+static int8_t quantizeInt8(float value, float factor) {
+    const float quantizedValue = roundf(value * factor);
+    if (quantizedValue > INT8_MAX) {
+        return INT8_MAX;
+    }
+    if (quantizedValue < INT8_MIN) {
+        return INT8_MIN;
+    }
+    return (int8_t)quantizedValue;
+}
+
+static void quantizeRanges(const uint16_t ranges[RANGE_T_END], uint8_t quantizedRanges[RANGE_T_END]) {
+    for (uint8_t i = 0; i < RANGE_T_END; i++) {
+        const float quantizedRange = roundf(ranges[i] * MILLIMETER_TO_CENTIMETER_FACTOR);
+        quantizedRanges[i] = quantizedRange > UINT8_MAX ? UINT8_MAX : (uint8_t)quantizedRange;
+    }
+}
+
+static void setFirstScan(mappingStreamScanRecord_t* record, const sensorSnapshot_t* snapshot) {
+    record->timestamp = (uint16_t)T2M(snapshot->rangesTimestamp);
+    record->position[0] = quantizeInt16(snapshot->position.x, METER_TO_MILLIMETER_FACTOR);
+    record->position[1] = quantizeInt16(snapshot->position.y, METER_TO_MILLIMETER_FACTOR);
+    record->position[2] = quantizeInt16(snapshot->position.z, METER_TO_MILLIMETER_FACTOR);
+    record->yaw = quantizeInt16(snapshot->attitude.yaw, DEGREE_TO_CENTIDEGREE_FACTOR);
+    record->roll = quantizeInt8(snapshot->attitude.roll, 1.0f);
+    record->pitch = quantizeInt8(snapshot->attitude.pitch, 1.0f);
+    quantizeRanges(snapshot->ranges, record->ranges);
+    pendingYaw = record->yaw / DEGREE_TO_CENTIDEGREE_FACTOR;
+}
+
+static void setNextScan(mappingStreamScanRecord_t* record, const sensorSnapshot_t* snapshot) {
+    // Deltas from the quantized first scan, so that quantization errors do not add up
+    const uint16_t timestampDelta = (uint16_t)((uint16_t)T2M(snapshot->rangesTimestamp) - record->timestamp);
+    const float deltaX = snapshot->position.x - record->position[0] / METER_TO_MILLIMETER_FACTOR;
+    const float deltaY = snapshot->position.y - record->position[1] / METER_TO_MILLIMETER_FACTOR;
+    float deltaYaw = snapshot->attitude.yaw - pendingYaw;
+    if (deltaYaw >= 180.0f) {
+        deltaYaw -= 360.0f;
+    } else if (deltaYaw < -180.0f) {
+        deltaYaw += 360.0f;
+    }
+    record->nextTimestampDelta = timestampDelta > UINT8_MAX ? UINT8_MAX : (uint8_t)timestampDelta;
+    record->nextPositionDelta[0] = quantizeInt8(deltaX, METER_TO_MILLIMETER_FACTOR);
+    record->nextPositionDelta[1] = quantizeInt8(deltaY, METER_TO_MILLIMETER_FACTOR);
+    record->nextYawDelta = quantizeInt8(deltaYaw, DEGREE_TO_DECIDEGREE_FACTOR);
+    quantizeRanges(snapshot->ranges, record->nextRanges);
+}
+
+static bool isRecordStored(uint16_t sequence) {
+    // Sequences wrap around, so the age is only meaningful in 16 bits
+    const uint16_t age = (uint16_t)(nextSequence - sequence);
+    return age >= 1 && age <= storedRecordCount;
+}
+
+static void receiveRetransmitRequests(void) {
+    mappingStreamRetransmitRequest_t request;
+    while (appchannelReceivePacket(&request, sizeof(request), 0) == sizeof(request)) {
+        if (request.type != MAPPING_STREAM_RETRANSMIT_REQUEST) {
+            continue;
+        }
+
+        // A new request replaces the previous one, since the server asks again for the records it is still missing
+        retransmitSequence = request.firstSequence;
+        retransmitCount = request.count;
+    }
+}
+
+void mappingStreamInit(void) {
+    if (isInit) {
+        return;
+    }
+
+    memset(records, 0, sizeof(records));
+    nextSequence = 0;
+    nextSentSequence = 0;
+    storedRecordCount = 0;
+    hasPendingScan = false;
+    retransmitCount = 0;
+    isInit = true;
+}
+
+void mappingStreamAddScan(const sensorSnapshot_t* snapshot) {
+    if (!isInit || snapshot->rangesTimestamp == lastRangesTimestamp) {
+        return;
+    }
+    lastRangesTimestamp = snapshot->rangesTimestamp;
+
+    if (!hasPendingScan) {
+        setFirstScan(&pendingRecord, snapshot);
+        hasPendingScan = true;
+        return;
+    }
+    setNextScan(&pendingRecord, snapshot);
+    hasPendingScan = false;
+
+    pendingRecord.type = MAPPING_STREAM_SCAN_RECORD;
+    pendingRecord.sequence = nextSequence;
+    records[nextSequence % MAPPING_STREAM_BUFFER_SIZE] = pendingRecord;
+
+    nextSequence++;
+    if (storedRecordCount < MAPPING_STREAM_BUFFER_SIZE) {
+        storedRecordCount++;
+    }
+    if (!isRecordStored(nextSentSequence) && nextSentSequence != nextSequence) {
+        nextSentSequence = (uint16_t)(nextSequence - MAPPING_STREAM_BUFFER_SIZE);
+        overrunCount++;
+    }
+}
+
+void mappingStreamUpdate(void) {
+    if (!isInit) {
+        return;
+    }
+
+    receiveRetransmitRequests();
+    if (!crtpIsConnected()) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < MAX_PACKETS_PER_UPDATE && crtpGetFreeTxQueuePackets() > TX_QUEUE_RESERVE; i++) {
+        // New records first, since they are used to draw the drones' sensor lines, then the ones the server asked for again
+        if (nextSentSequence != nextSequence) {
+            appchannelSendPacket(&records[nextSentSequence % MAPPING_STREAM_BUFFER_SIZE], sizeof(mappingStreamScanRecord_t));
+            nextSentSequence++;
+            continue;
+        }
+
+        // Records which are no longer stored are skipped, the server gives up on them
+        while (retransmitCount > 0 && !isRecordStored(retransmitSequence)) {
+            retransmitSequence++;
+            retransmitCount--;
+        }
+        if (retransmitCount == 0) {
+            break;
+        }
+        appchannelSendPacket(&records[retransmitSequence % MAPPING_STREAM_BUFFER_SIZE], sizeof(mappingStreamScanRecord_t));
+        retransmitSequence++;
+        retransmitCount--;
+        retransmittedCount++;
+    }
+}
+
+LOG_GROUP_START(mapStream)
+LOG_ADD(LOG_UINT16, sequence, &nextSequence)
+LOG_ADD(LOG_UINT32, overruns, &overrunCount)
+LOG_ADD(LOG_UINT32, retransmits, &retransmittedCount)
+LOG_GROUP_STOP(mapStream)
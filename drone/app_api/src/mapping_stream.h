@@ -0,0 +1,49 @@
+#ifndef MAPPING_STREAM_H
+#define MAPPING_STREAM_H
+
+#include <stdint.h>
+#include "sensor_snapshot.h"
+
+// Scan records are kept after they are sent so that the server can ask for lost ones again, 6.4 s of history at the multiranger's
+// 10 Hz rate with two scans per record
+#define MAPPING_STREAM_BUFFER_SIZE 32
+
+typedef enum {
+    MAPPING_STREAM_SCAN_RECORD = 0, // Drone to server
+    MAPPING_STREAM_RETRANSMIT_REQUEST = 1, // Server to drone
+} mappingStreamPacketType_t;
+
+// Wire layouts over the app channel, little-endian like both ends. A scan record carries two consecutive scans, the second one
+// delta-encoded from the first one, whose altitude, roll and pitch it shares
+typedef struct {
+    uint8_t type;
+    uint16_t sequence; // Incremented for each record, so that the server can detect lost records
+    uint16_t timestamp; // ms since the drone started modulo 2^16, when the ranges of the first scan were updated
+    int16_t position[3]; // mm
+    int16_t yaw; // cdeg
+    int8_t roll; // deg
+    int8_t pitch; // deg (legacy CF2 body coordinate system, where pitch is inverted)
+    uint8_t ranges[RANGE_T_END]; // cm, saturated, indexed by rangeDirection_t
+    uint8_t nextTimestampDelta; // ms
+    int8_t nextPositionDelta[2]; // mm
+    int8_t nextYawDelta; // ddeg
+    uint8_t nextRanges[RANGE_T_END]; // cm, saturated, indexed by rangeDirection_t
+} __attribute__((packed)) mappingStreamScanRecord_t;
+
+typedef struct {
+    uint8_t type;
+    uint16_t firstSequence;
+    uint8_t count;
+} __attribute__((packed)) mappingStreamRetransmitRequest_t;
+
+void mappingStreamInit(void);
+
+// Adds the snapshot's pose and ranges to the pending record if the ranges were updated since the previous scan, the record is sent
+// once it holds two scans
+void mappingStreamAddScan(const sensorSnapshot_t* snapshot);
+
+// Handles the server's retransmit requests and sends the pending records, to be called at every tick of the app's loop. Records are
+// only sent while there is room in the radio's queue, so that they never delay the log and param packets
+void mappingStreamUpdate(void);
+
+#endif
@@ -0,0 +1,164 @@
+#include <math.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include "task.h"
+#include "p2p_neighbours.h"
+
+// Each drone broadcasts once per period, 5 times per second like the previous random broadcasts
+static const uint32_t BROADCAST_PERIOD_MS = 200;
+static const uint32_t BROADCAST_SLOT_COUNT = 20;
+// Neighbours which missed this many broadcasts are considered gone, or too far to be a collision risk
+static const uint32_t NEIGHBOUR_TIMEOUT_MS = 5 * BROADCAST_PERIOD_MS;
+// Neighbours are assumed to keep their velocity for at most this long, longer predictions drift more than the position is stale
+static const uint32_t MAXIMUM_PREDICTION_MS = 500;
+// Below this yaw rate, neighbours are assumed to fly straight, which also avoids dividing by a rate close to zero (deg/s)
+static const float MINIMUM_TURN_RATE = 1.0f;
+// Used as the neighbour index of IDs without an entry
+static const uint8_t NO_NEIGHBOUR_INDEX = UINT8_MAX;
+
+static p2pNeighbour_t neighbours[P2P_NEIGHBOURS_MAX_COUNT];
+static uint8_t neighbourCount = 0;
+// Index in the neighbours of each ID, so that every packet does not search the table
+static uint8_t neighbourIndices[UINT8_MAX + 1];
+
+static TickType_t lastBroadcastPeriod = portMAX_DELAY;
+
+// The table is written by the radio link's task and read by the app's task
+static SemaphoreHandle_t neighboursMutex;
+static StaticSemaphore_t neighboursMutexBuffer;
+
+static void removeNeighbour(uint8_t index) {
+    // Move the last neighbour into the hole so that the table stays contiguous
+    neighbourIndices[neighbours[index].content.sourceId] = NO_NEIGHBOUR_INDEX;
+    neighbourCount--;
+    if (index != neighbourCount) {
+        neighbours[index] = neighbours[neighbourCount];
+        neighbourIndices[neighbours[index].content.sourceId] = index;
+    }
+}
+
+static void predictPosition(p2pNeighbour_t* neighbour, TickType_t now) {
+    const TickType_t age = now - neighbour->timestamp;
+    const float predictionDuration = T2M(age < M2T(MAXIMUM_PREDICTION_MS) ? age : M2T(MAXIMUM_PREDICTION_MS)) / 1000.0f;
+    const float velocityX = neighbour->content.velocity.x;
+    const float velocityY = neighbour->content.velocity.y;
+    float deltaX = velocityX * predictionDuration;
+    float deltaY = velocityY * predictionDuration;
+    if (fabsf(neighbour->yawRate) >= MINIMUM_TURN_RATE) {
+        // Drones turn toward their targets while flying, so their velocities are assumed to turn with their yaws
+        const float turnRate = neighbour->yawRate * (float)M_PI / 180.0f;
+        const float turn = turnRate * predictionDuration;
+        deltaX = (velocityX * sinf(turn) - velocityY * (1.0f - cosf(turn))) / turnRate;
+        deltaY = (velocityY * sinf(turn) + velocityX * (1.0f - cosf(turn))) / turnRate;
+    }
+    neighbour->predictedPosition.x = neighbour->content.position.x + deltaX;
+    neighbour->predictedPosition.y = neighbour->content.position.y + deltaY;
+    neighbour->predictedPosition.z = neighbour->content.position.z + neighbour->content.velocity.z * predictionDuration;
+}
+
+static float getYawRate(const p2pNeighbour_t* neighbour, const p2pPacketContent_t* content, TickType_t now) {
+    const float duration = T2M(now - neighbour->timestamp) / 1000.0f;
+    if (duration <= 0.0f) {
+        return neighbour->yawRate;
+    }
+
+    // The yaws wrap around at +-180 deg
+    float yawDelta = content->yaw - neighbour->content.yaw;
+    if (yawDelta > 180.0f) {
+        yawDelta -= 360.0f;
+    } else if (yawDelta < -180.0f) {
+        yawDelta += 360.0f;
+    }
+    return yawDelta / duration;
+}
+
+static bool isNeighbourExpired(const p2pNeighbour_t* neighbour, TickType_t now) {
+    return now - neighbour->timestamp > M2T(NEIGHBOUR_TIMEOUT_MS);
+}
+
+void p2pNeighboursInit(void) {
+    neighboursMutex = xSemaphoreCreateMutexStatic(&neighboursMutexBuffer);
+    p2pNeighboursClear();
+}
+
+void p2pNeighboursClear(void) {
+    xSemaphoreTake(neighboursMutex, portMAX_DELAY);
+    neighbourCount = 0;
+    memset(neighbourIndices, NO_NEIGHBOUR_INDEX, sizeof(neighbourIndices));
+    xSemaphoreGive(neighboursMutex);
+}
+
+void p2pNeighboursUpdate(const p2pPacketContent_t* content) {
+    const TickType_t now = xTaskGetTickCount();
+    const uint8_t id = content->sourceId;
+
+    xSemaphoreTake(neighboursMutex, portMAX_DELAY);
+    uint8_t index = neighbourIndices[id];
+    if (index == NO_NEIGHBOUR_INDEX) {
+        if (neighbourCount == P2P_NEIGHBOURS_MAX_COUNT) {
+            // Replace the stalest neighbour only if it expired, fresh neighbours matter as much as the new one
+            uint8_t stalestIndex = 0;
+            for (uint8_t i = 1; i < neighbourCount; i++) {
+                if (now - neighbours[i].timestamp > now - neighbours[stalestIndex].timestamp) {
+                    stalestIndex = i;
+                }
+            }
+            if (!isNeighbourExpired(&neighbours[stalestIndex], now)) {
+                xSemaphoreGive(neighboursMutex);
+                return;
+            }
+            removeNeighbour(stalestIndex);
+        }
+
+        index = neighbourCount;
+        neighbourCount++;
+        neighbourIndices[id] = index;
+        neighbours[index].yawRate = 0.0f;
+    } else {
+        neighbours[index].yawRate = getYawRate(&neighbours[index], content, now);
+    }
+
+    neighbours[index].content = *content;
+    neighbours[index].timestamp = now;
+    xSemaphoreGive(neighboursMutex);
+}
+
+uint8_t p2pNeighboursGetFresh(p2pNeighbour_t freshNeighbours[P2P_NEIGHBOURS_MAX_COUNT]) {
+    const TickType_t now = xTaskGetTickCount();
+
+    xSemaphoreTake(neighboursMutex, portMAX_DELAY);
+    uint8_t index = 0;
+    while (index < neighbourCount) {
+        if (isNeighbourExpired(&neighbours[index], now)) {
+            removeNeighbour(index);
+        } else {
+            predictPosition(&neighbours[index], now);
+            index++;
+        }
+    }
+    memcpy(freshNeighbours, neighbours, neighbourCount * sizeof(p2pNeighbour_t));
+    const uint8_t freshNeighbourCount = neighbourCount;
+    xSemaphoreGive(neighboursMutex);
+
+    return freshNeighbourCount;
+}
+
+bool p2pIsBroadcastDue(uint8_t id) {
+    // Drones' clocks are not synchronized, so slots only spread the broadcasts of drones started together, but the rate of each
+    // drone stays fixed regardless of the swarm's size
+    static const uint32_t slotDuration = BROADCAST_PERIOD_MS / BROADCAST_SLOT_COUNT;
+    const TickType_t now = xTaskGetTickCount();
+    const TickType_t slotOffset = M2T((id % BROADCAST_SLOT_COUNT) * slotDuration);
+    if (now < slotOffset) {
+        return false;
+    }
+
+    const TickType_t period = (now - slotOffset) / M2T(BROADCAST_PERIOD_MS);
+    if (period == lastBroadcastPeriod) {
+        return false;
+    }
+
+    lastBroadcastPeriod = period;
+    return true;
+}
@@ -0,0 +1,34 @@
+#ifndef P2P_NEIGHBOURS_H
+#define P2P_NEIGHBOURS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "p2p_packet.h"
+#include "stabilizer_types.h"
+
+// Neighbours heard from over P2P, more are ignored until the stalest one expires
+#define P2P_NEIGHBOURS_MAX_COUNT 16
+
+typedef struct {
+    p2pPacketContent_t content; // Latest packet received from the neighbour
+    TickType_t timestamp; // When the latest packet was received
+    float yawRate; // Turn rate between the neighbour's two latest packets (deg/s)
+    point_t predictedPosition; // Dead reckoning of the neighbour's position when the neighbours were last read
+} p2pNeighbour_t;
+
+void p2pNeighboursInit(void);
+void p2pNeighboursClear(void);
+
+// Called from the P2P callback, in the radio link's task
+void p2pNeighboursUpdate(const p2pPacketContent_t* content);
+// Copies the neighbours heard from recently enough to be trusted and removes the others, returns the number of neighbours copied.
+// Their positions are predicted from their velocities, turned by their yaw rates, since neighbours only broadcast a few times per
+// second
+uint8_t p2pNeighboursGetFresh(p2pNeighbour_t neighbours[P2P_NEIGHBOURS_MAX_COUNT]);
+
+// Whether the drone's broadcast slot started since its last broadcast. Each drone gets one slot per broadcast period from its ID
+// so that the drones of a swarm spread their packets instead of sending them at random
+bool p2pIsBroadcastDue(uint8_t id);
+
+#endif
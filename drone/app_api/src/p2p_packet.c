@@ -0,0 +1,102 @@
+#include <math.h>
+#include <string.h>
+#include "p2p_packet.h"
+
+// Positions and velocities are sent in mm and mm/s, which covers +/- 32 m and is finer than the state estimate
+static const float METER_TO_MILLIMETER_FACTOR = 1000.0f;
+static const float DEGREE_TO_CENTIDEGREE_FACTOR = 100.0f;
+// Claimed frontier coordinates sent when no frontier is claimed
+static const int16_t NO_CLAIMED_FRONTIER = INT16_MIN;
+
+// Wire layout, little-endian like both ends
+typedef struct {
+    uint8_t version;
+    uint8_t sourceId;
+    int16_t position[3];
+    int16_t velocity[3];
+    int16_t yaw;
+    uint8_t batteryLevel;
+    uint8_t droneStatus;
+    uint64_t exploredCells;
+    int16_t exploredCellsColumn;
+    int16_t exploredCellsRow;
+    int16_t claimedFrontier[2];
+} __attribute__((packed)) p2pPayload_t;
+
+_Static_assert(sizeof(p2pPayload_t) <= P2P_MAX_DATA_SIZE, "P2P payload must fit in a P2P packet");
+
+static int16_t quantize(float value, float factor) {
+    const float quantizedValue = roundf(value * factor);
+    if (quantizedValue > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (quantizedValue < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return (int16_t)quantizedValue;
+}
+
+void p2pPacketEncode(const p2pPacketContent_t* content, P2PPacket* packet) {
+    p2pPayload_t payload = {
+        .version = P2P_PACKET_VERSION,
+        .sourceId = content->sourceId,
+        .position =
+            {
+                quantize(content->position.x, METER_TO_MILLIMETER_FACTOR),
+                quantize(content->position.y, METER_TO_MILLIMETER_FACTOR),
+                quantize(content->position.z, METER_TO_MILLIMETER_FACTOR),
+            },
+        .velocity =
+            {
+                quantize(content->velocity.x, METER_TO_MILLIMETER_FACTOR),
+                quantize(content->velocity.y, METER_TO_MILLIMETER_FACTOR),
+                quantize(content->velocity.z, METER_TO_MILLIMETER_FACTOR),
+            },
+        .yaw = quantize(content->yaw, DEGREE_TO_CENTIDEGREE_FACTOR),
+        .batteryLevel = content->batteryLevel,
+        .droneStatus = content->droneStatus,
+        .exploredCells = content->exploredCells,
+        .exploredCellsColumn = content->exploredCellsColumn,
+        .exploredCellsRow = content->exploredCellsRow,
+        .claimedFrontier = {NO_CLAIMED_FRONTIER, NO_CLAIMED_FRONTIER},
+    };
+
+    if (content->hasClaimedFrontier) {
+        payload.claimedFrontier[0] = quantize(content->claimedFrontierX, METER_TO_MILLIMETER_FACTOR);
+        payload.claimedFrontier[1] = quantize(content->claimedFrontierY, METER_TO_MILLIMETER_FACTOR);
+    }
+
+    packet->port = 0x00;
+    packet->size = sizeof(payload);
+    memcpy(packet->data, &payload, sizeof(payload));
+}
+
+bool p2pPacketDecode(const P2PPacket* packet, p2pPacketContent_t* content) {
+    p2pPayload_t payload;
+    if (packet->size < sizeof(payload)) {
+        return false;
+    }
+
+    memcpy(&payload, packet->data, sizeof(payload));
+    if (payload.version != P2P_PACKET_VERSION) {
+        return false;
+    }
+
+    content->sourceId = payload.sourceId;
+    content->position.x = payload.position[0] / METER_TO_MILLIMETER_FACTOR;
+    content->position.y = payload.position[1] / METER_TO_MILLIMETER_FACTOR;
+    content->position.z = payload.position[2] / METER_TO_MILLIMETER_FACTOR;
+    content->velocity.x = payload.velocity[0] / METER_TO_MILLIMETER_FACTOR;
+    content->velocity.y = payload.velocity[1] / METER_TO_MILLIMETER_FACTOR;
+    content->velocity.z = payload.velocity[2] / METER_TO_MILLIMETER_FACTOR;
+    content->yaw = payload.yaw / DEGREE_TO_CENTIDEGREE_FACTOR;
+    content->batteryLevel = payload.batteryLevel;
+    content->droneStatus = payload.droneStatus;
+    content->exploredCells = payload.exploredCells;
+    content->exploredCellsColumn = payload.exploredCellsColumn;
+    content->exploredCellsRow = payload.exploredCellsRow;
+    content->hasClaimedFrontier = payload.claimedFrontier[0] != NO_CLAIMED_FRONTIER;
+    content->claimedFrontierX = payload.claimedFrontier[0] / METER_TO_MILLIMETER_FACTOR;
+    content->claimedFrontierY = payload.claimedFrontier[1] / METER_TO_MILLIMETER_FACTOR;
+    return true;
+}
@@ -0,0 +1,38 @@
+#ifndef P2P_PACKET_H
+#define P2P_PACKET_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "radiolink.h"
+#include "stabilizer_types.h"
+
+// Incremented when the payload layout changes, packets of other versions are ignored
+#define P2P_PACKET_VERSION 5
+
+// Recently explored cells are sent as a bitmap of the cells around the sender
+#define P2P_EXPLORED_CELL_SIZE 0.5f
+#define P2P_EXPLORED_CELLS_SIDE 8
+
+typedef struct {
+    uint8_t sourceId;
+    point_t position; // m, in the swarm's shared frame
+    velocity_t velocity; // m/s
+    float yaw; // deg
+    uint8_t batteryLevel; // %
+    uint8_t droneStatus;
+    // Bit (row * P2P_EXPLORED_CELLS_SIDE + column) is set if the cell at (exploredCellsColumn + column, exploredCellsRow + row) was
+    // explored, cells are counted in P2P_EXPLORED_CELL_SIZE steps from the shared frame's origin
+    uint64_t exploredCells;
+    int16_t exploredCellsColumn;
+    int16_t exploredCellsRow;
+    // Frontier the sender is heading to in frontier exploration, in the swarm's shared frame
+    bool hasClaimedFrontier;
+    float claimedFrontierX; // m
+    float claimedFrontierY; // m
+} p2pPacketContent_t;
+
+void p2pPacketEncode(const p2pPacketContent_t* content, P2PPacket* packet);
+// Returns false if the packet is not a valid packet of this version
+bool p2pPacketDecode(const P2PPacket* packet, p2pPacketContent_t* content);
+
+#endif
@@ -35,6 +35,7 @@
 #include "vl53l1x.h"
 #include "range.h"
 #include "static_mem.h"
+#include "app.h"
 
 #include "i2cdev.h"
 
@@ -108,6 +109,9 @@ static void mrTask(void* param) {
         rangeSet(rangeUp, mrGetMeasurementAndRestart(&devUp) / 1000.0f);
         rangeSet(rangeLeft, mrGetMeasurementAndRestart(&devLeft) / 1000.0f);
         rangeSet(rangeRight, mrGetMeasurementAndRestart(&devRight) / 1000.0f);
+
+        // Let the app react to the new readings right away
+        appNotify(APP_EVENT_RANGE_UPDATED);
     }
 }
 
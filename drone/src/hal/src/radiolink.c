@@ -43,6 +43,7 @@
 #include "ledseq.h"
 #include "queuemonitor.h"
 #include "static_mem.h"
+#include "sensor_snapshot.h"
 
 #define RADIOLINK_TX_QUEUE_SIZE (1)
 #define RADIOLINK_CRTP_QUEUE_SIZE (5)
@@ -162,6 +163,7 @@ void radiolinkSyslinkDispatch(SyslinkPacket* slp) {
     } else if (slp->type == SYSLINK_RADIO_RSSI) {
         // Extract RSSI sample sent from radio
         memcpy(&rssi, slp->data, sizeof(uint8_t)); // rssi will not change on disconnect
+        sensorSnapshotSetRssi(rssi);
     } else if (slp->type == SYSLINK_RADIO_P2P_BROADCAST) {
         ledseqRun(&seq_linkUp);
         P2PPacket p2pp;
@@ -25,6 +25,14 @@
 /* app.h: App layer API */
 #pragma once
 
+#include <stdint.h>
+
+/**
+ * Events notified to the app task by the tasks producing its data, see appNotify()
+ */
+#define APP_EVENT_STATE_UPDATED (1 << 0) // New state estimate, notified at 100 Hz by the stabilizer
+#define APP_EVENT_RANGE_UPDATED (1 << 1) // New multiranger readings
+
 /**
  * App Inintialization
  *
@@ -39,4 +47,16 @@ void appInit();
  * app main function, called when the Crazyflie has started from within a task created
  * by appInit().
  */
-void appMain();
\ No newline at end of file
+void appMain();
+
+/**
+ * Wakes the app task up with the given events, which are accumulated until the app task waits for them.
+ * Does nothing if the app task was not created by the default appInit().
+ */
+void appNotify(uint32_t events);
+
+/**
+ * Blocks the app task until at least one event is notified or the timeout (in ticks) expires.
+ * Returns the events notified since the previous call, or 0 if the timeout expired.
+ */
+uint32_t appWaitForEvents(uint32_t timeout);
@@ -0,0 +1,49 @@
+/* battery_estimator.h: State of charge estimated from the motor commands and the battery voltage */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define BATTERY_ESTIMATOR_MOTOR_COUNT 4
+
+void batteryEstimatorInit(void);
+bool batteryEstimatorTest(void);
+
+/**
+ * Starts the estimate over from the voltage, which is only accurate when the battery is at rest.
+ *
+ * @param voltage The battery voltage (V)
+ */
+void batteryEstimatorReset(float voltage);
+
+/**
+ * Counts the charge drawn by the motors and the electronics since the last update (coulomb counting), then corrects the drift with
+ * the state of charge read from the voltage. The voltage sags under load, so it is trusted much less than the charge counted.
+ *
+ * @param voltage The battery voltage (V)
+ * @param isFlying Whether the motors are running, the voltage is read through the table measured in flight
+ * @param motorRatios The motor commands (0 to UINT16_MAX)
+ * @param deltaTime Time since the last update (s)
+ */
+void batteryEstimatorUpdate(float voltage, bool isFlying, const uint16_t motorRatios[BATTERY_ESTIMATOR_MOTOR_COUNT], float deltaTime);
+
+/**
+ * Returns the estimated state of charge, between 0 and 1.
+ */
+float batteryEstimatorGetStateOfCharge(void);
+
+/**
+ * Returns the state of charge needed to fly back to the base and land, with a safety margin and a reserve.
+ *
+ * @param distance The length of the path back to the base (m)
+ * @param velocity The velocity at which the drone flies back (m/s)
+ */
+float batteryEstimatorGetReturnStateOfCharge(float distance, float velocity);
+
+/**
+ * Returns the state of charge read from the battery voltage, between 0 and 1.
+ *
+ * @param voltage The battery voltage (V)
+ * @param isFlying Whether the motors are running, since they make the voltage sag
+ */
+float batteryEstimatorVoltageToStateOfCharge(float voltage, bool isFlying);
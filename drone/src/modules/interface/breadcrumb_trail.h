@@ -0,0 +1,51 @@
+/* breadcrumb_trail.h: Trail of the positions the drone flew through, followed backwards to return to the base */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "stabilizer_types.h"
+
+/**
+ * A breadcrumb is dropped every 50 cm and the trail keeps at most 64 of them. When the trail is full, every other breadcrumb is
+ * removed, so that it always leads back to the base at the cost of a coarser path.
+ */
+#define BREADCRUMB_TRAIL_MAX_COUNT 64
+#define BREADCRUMB_TRAIL_SPACING 0.5f
+
+void breadcrumbTrailInit(void);
+bool breadcrumbTrailTest(void);
+
+/**
+ * Empties the trail and drops its first breadcrumb at the base, which is never removed.
+ *
+ * @param base The base's position in the state estimate's frame (m)
+ */
+void breadcrumbTrailReset(const point_t* base);
+
+/**
+ * Drops a breadcrumb if the drone is far enough from the latest one. When the drone comes back to an older breadcrumb which it can
+ * fly to in a straight line, the loop flown since that breadcrumb is cut from the trail.
+ *
+ * @param position The drone's position in the state estimate's frame (m)
+ */
+void breadcrumbTrailAdd(const point_t* position);
+
+/**
+ * Finds the next position to fly to on the way back to the base: the breadcrumb closest to the base along the trail which the drone
+ * can fly to in a straight line through free cells of the occupancy grid, or the latest breadcrumb if there is none. Breadcrumbs
+ * after the one returned are removed from the trail.
+ *
+ * @param position The drone's position in the state estimate's frame (m)
+ * @param waypoint Set to the breadcrumb to fly to in the state estimate's frame (m)
+ * @return false if the trail is empty
+ */
+bool breadcrumbTrailGetNextWaypoint(const point_t* position, point_t* waypoint);
+
+/**
+ * Returns the length of the path from the drone back to the base along the trail.
+ *
+ * @param position The drone's position in the state estimate's frame (m)
+ */
+float breadcrumbTrailGetLength(const point_t* position);
+
+uint8_t breadcrumbTrailGetCount(void);
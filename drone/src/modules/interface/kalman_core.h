@@ -71,6 +71,20 @@ typedef enum {
     KC_STATE_DIM
 } kalmanCoreStateIdx_t;
 
+// The largest number of scalar measurements applied together, a full batch is applied before the next measurement is added
+#define KC_MAX_BATCH_SIZE 8
+
+// Scalar measurements linearized at the same state, to be applied in a single vector update
+typedef struct {
+    bool isCollecting;
+    uint8_t size;
+    float H[KC_MAX_BATCH_SIZE][KC_STATE_DIM];
+    float error[KC_MAX_BATCH_SIZE];
+    float variance[KC_MAX_BATCH_SIZE];
+    // Batches applied one measurement at a time because HPH' + R was not positive definite
+    uint32_t fallbackCount;
+} kalmanCoreMeasurementBatch_t;
+
 // The data used by the kalman core implementation.
 typedef struct {
     /**
@@ -101,12 +115,33 @@ typedef struct {
     bool resetEstimation;
 
     float baroReferenceHeight;
+
+    kalmanCoreMeasurementBatch_t batch;
 } kalmanCoreData_t;
 
 void kalmanCoreInit(kalmanCoreData_t* this);
 
+// Selects the covariance updates skipping the zeros of A and H (default), or the dense matrix products
+void kalmanCoreSetSparseCovarianceUpdate(bool isEnabled);
+
+#ifdef UNIT_TEST_MODE
+/**
+ * Counts the products of the covariance predictions and of the measurement updates, so that the host benchmarks compare the
+ * sparse, dense and batch paths by their work rather than only by the host's time.
+ */
+uint32_t kalmanCoreGetMultiplyAccumulateCount(void);
+void kalmanCoreResetMultiplyAccumulateCount(void);
+#endif
+
 /*  - Measurement updates based on sensors */
 
+/**
+ * Between these calls, the measurement updates below are collected instead of being applied one by one. They are then applied in a
+ * single Joseph form update, which computes P*H' and rewrites the covariance once for all of them.
+ */
+void kalmanCoreBeginBatchUpdate(kalmanCoreData_t* this);
+void kalmanCoreEndBatchUpdate(kalmanCoreData_t* this);
+
 // Barometer
 void kalmanCoreUpdateWithBaro(kalmanCoreData_t* this, float baroAsl, bool quadIsFlying);
 
@@ -0,0 +1,73 @@
+/* occupancy_grid.h: On-board occupancy grid built from the multiranger's horizontal sensors */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "range.h"
+#include "stabilizer_types.h"
+
+/**
+ * The grid is centered on the position where the state estimate started, which is where the drone took off.
+ * 64 x 64 cells of 20 cm cover 12.8 m x 12.8 m with 4 bits per cell.
+ */
+#define OCCUPANCY_GRID_SIDE 64
+#define OCCUPANCY_GRID_CELL_SIZE 0.2f
+#define OCCUPANCY_GRID_MEMORY_SIZE (OCCUPANCY_GRID_SIDE * OCCUPANCY_GRID_SIDE / 2)
+
+typedef enum {
+    OCCUPANCY_GRID_UNKNOWN,
+    OCCUPANCY_GRID_FREE,
+    OCCUPANCY_GRID_OCCUPIED,
+} occupancyGridCellState_t;
+
+void occupancyGridInit(void);
+bool occupancyGridTest(void);
+
+/**
+ * Marks every cell as unknown.
+ */
+void occupancyGridReset(void);
+
+/**
+ * Lowers the occupancy of the cells crossed by each horizontal sensor's ray and raises the occupancy of the cell it hits.
+ *
+ * @param position The drone's position in the state estimate's frame (m)
+ * @param yaw The drone's yaw (deg)
+ * @param ranges The ranges indexed by rangeDirection_t (mm)
+ */
+void occupancyGridAddRangeReadings(const point_t* position, float yaw, const uint16_t ranges[RANGE_T_END]);
+
+/**
+ * Returns the state of the cell containing a position, cells outside the grid are unknown.
+ */
+occupancyGridCellState_t occupancyGridGetCellState(float x, float y);
+
+/**
+ * Returns true if every cell along the segment is known to be free, so that the drone can fly it in a straight line.
+ */
+bool occupancyGridIsSegmentFree(const point_t* from, const point_t* to);
+
+/**
+ * Finds the heading whose nearby cells are the least explored, without looking past obstacles.
+ *
+ * @param position The drone's position in the state estimate's frame (m)
+ * @param heading Set to the heading in the state estimate's frame (deg, in [-180, 180[)
+ * @return false if every heading is as explored as the others
+ */
+bool occupancyGridFindLeastExploredHeading(const point_t* position, float* heading);
+
+typedef bool (*occupancyGridFrontierFilter_t)(float x, float y);
+
+/**
+ * Finds the nearest free cell next to an unknown cell, reachable from the drone through free cells. Frontiers close to the ones
+ * claimed by other drones, or rejected by the filter, are skipped so that drones do not explore the same area.
+ *
+ * @param position The drone's position in the state estimate's frame (m)
+ * @param claimedFrontiers The frontiers claimed by other drones, in the state estimate's frame (m)
+ * @param claimedFrontierCount The number of claimed frontiers
+ * @param isFrontierExplored Returns true for the frontiers to skip, given in the state estimate's frame (m). May be NULL
+ * @param frontier Set to the center of the frontier cell in the state estimate's frame (m)
+ * @return false if no unclaimed frontier is reachable
+ */
+bool occupancyGridFindNearestFrontier(const point_t* position, const point_t claimedFrontiers[], uint8_t claimedFrontierCount,
+                                      occupancyGridFrontierFilter_t isFrontierExplored, point_t* frontier);
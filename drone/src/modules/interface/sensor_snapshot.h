@@ -0,0 +1,44 @@
+/* sensor_snapshot.h: Consistent snapshot of the data used by the app layer */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "range.h"
+#include "stabilizer_types.h"
+
+/**
+ * Data updated at the source by the stabilizer, range and radio link modules, so that the app layer gets all of it in one call
+ * instead of going through the log TOC value by value.
+ */
+typedef struct {
+    attitude_t attitude; // deg (legacy CF2 body coordinate system, where pitch is inverted)
+    point_t position; // m
+    velocity_t velocity; // m/s
+    uint16_t ranges[RANGE_T_END]; // mm, indexed by rangeDirection_t
+    uint32_t rangesTimestamp; // Ticks when a range was last set
+    float batteryVoltage; // V
+    uint8_t rssi;
+} sensorSnapshot_t;
+
+void sensorSnapshotInit(void);
+bool sensorSnapshotTest(void);
+
+/**
+ * Updates the state estimate. Called by the stabilizer at 100 Hz, not at every state estimate.
+ */
+void sensorSnapshotSetState(const state_t* state);
+
+/**
+ * Updates the range of one direction, in mm.
+ */
+void sensorSnapshotSetRange(rangeDirection_t direction, uint16_t range);
+
+/**
+ * Updates the RSSI of the radio link.
+ */
+void sensorSnapshotSetRssi(uint8_t rssi);
+
+/**
+ * Copies the latest data. Every field of the state estimate comes from the same estimate.
+ */
+void sensorSnapshotGet(sensorSnapshot_t* snapshot);
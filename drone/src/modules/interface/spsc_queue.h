@@ -0,0 +1,85 @@
+/* spsc_queue.h: Lock-free single-producer single-consumer ring buffer */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * A ring buffer of fixed size items, written by one task or interrupt and read by one other task. Neither side takes a lock
+ * or enters a critical section: the producer only writes the write index and the consumer only writes the read index, each
+ * of them published with release semantics after the items it covers.
+ *
+ * The indices run freely and wrap around at 2^32, which requires the capacity to be a power of two.
+ *
+ * Items are read in place, so that the consumer can handle everything pending in one pass without copying it out:
+ *
+ *     uint32_t count = spscQueueGetPendingCount(&queue);
+ *     for (uint32_t i = 0; i < count; i++) {
+ *         handle(spscQueueGetPending(&queue, i));
+ *     }
+ *     spscQueueRelease(&queue, count);
+ */
+typedef struct {
+    uint8_t* buffer;
+    uint32_t itemSize;
+    uint32_t capacity;
+
+    // Written by the producer only
+    volatile uint32_t writeIndex;
+    // Items dropped because the queue was full
+    volatile uint32_t overrunCount;
+
+    // Written by the consumer only
+    volatile uint32_t readIndex;
+} spscQueue_t;
+
+/**
+ * Defines a static queue NAME, with a static buffer of CAPACITY items of type TYPE.
+ */
+#define SPSC_QUEUE_DEFINE(NAME, CAPACITY, TYPE)                                                                                  \
+    _Static_assert(((CAPACITY) & ((CAPACITY)-1)) == 0, "The capacity of " #NAME " must be a power of two");                     \
+    static TYPE NAME##Buffer[CAPACITY];                                                                                          \
+    static spscQueue_t NAME = {.buffer = (uint8_t*)NAME##Buffer, .itemSize = sizeof(TYPE), .capacity = (CAPACITY)}
+
+/**
+ * Initializes a queue over a buffer of capacity * itemSize bytes, the capacity must be a power of two.
+ */
+void spscQueueInit(spscQueue_t* queue, void* buffer, uint32_t itemSize, uint32_t capacity);
+
+/**
+ * Copies an item into the queue. Called by the producer.
+ *
+ * @return false if the queue is full, the item is dropped and counted as an overrun
+ */
+bool spscQueuePush(spscQueue_t* queue, const void* item);
+
+/**
+ * Returns the number of items written by the producer and not released yet. Called by the consumer.
+ */
+uint32_t spscQueueGetPendingCount(spscQueue_t* queue);
+
+/**
+ * Returns a pending item, which stays valid until it is released. Called by the consumer.
+ *
+ * @param index The index of the item from the oldest pending one, lower than the count returned by spscQueueGetPendingCount
+ */
+void* spscQueueGetPending(const spscQueue_t* queue, uint32_t index);
+
+/**
+ * Hands the oldest count pending items back to the producer. Called by the consumer.
+ */
+void spscQueueRelease(spscQueue_t* queue, uint32_t count);
+
+/**
+ * Copies the oldest pending item out of the queue and releases it. Called by the consumer.
+ *
+ * @return false if the queue is empty
+ */
+bool spscQueuePop(spscQueue_t* queue, void* item);
+
+/**
+ * Drops every pending item. Called by the consumer.
+ */
+void spscQueueReset(spscQueue_t* queue);
+
+uint32_t spscQueueGetOverrunCount(const spscQueue_t* queue);
@@ -0,0 +1,70 @@
+/* stage_timing.h: Execution time of the stabilizer loop stages, measured with the cycle counter */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * The durations are sorted into a histogram of STAGE_TIMING_BIN_COUNT bins of STAGE_TIMING_BIN_WIDTH us, which cover the loop's 1 ms
+ * budget, the last one holding everything longer. Every STAGE_TIMING_WINDOW samples of a stage, its statistics are published and its
+ * histogram is cleared.
+ */
+#define STAGE_TIMING_BIN_COUNT 64
+#define STAGE_TIMING_BIN_WIDTH 16
+#define STAGE_TIMING_WINDOW 1000
+
+typedef enum {
+    STAGE_TIMING_ESTIMATOR,
+    STAGE_TIMING_COMMANDER,
+    STAGE_TIMING_COLLISION_AVOIDANCE,
+    STAGE_TIMING_CONTROLLER,
+    STAGE_TIMING_POWER_DISTRIBUTION,
+    STAGE_TIMING_STAGE_COUNT,
+} stageTimingStage_t;
+
+// Statistics over the last window (us)
+typedef struct {
+    uint16_t min;
+    float average;
+    uint16_t max;
+    // The upper edge of the bin holding the 99th percentile, or the maximum if it is lower
+    uint16_t p99;
+} stageTimingStats_t;
+
+/**
+ * Starts the cycle counter.
+ *
+ * @param clockFrequency The core clock frequency (MHz)
+ */
+void stageTimingInit(uint32_t clockFrequency);
+bool stageTimingTest(void);
+
+/**
+ * Clears the histograms and the published statistics.
+ */
+void stageTimingReset(void);
+
+/**
+ * Returns the cycle counter, which wraps around every 2^32 cycles (25 s at 168 MHz).
+ */
+uint32_t stageTimingGetCycles(void);
+
+/**
+ * Marks the start and the end of a stage. The stages are timed from the stabilizer task only.
+ */
+void stageTimingStart(stageTimingStage_t stage);
+void stageTimingStop(stageTimingStage_t stage);
+
+/**
+ * Adds the duration of a stage to its histogram, and publishes its statistics at the end of a window.
+ */
+void stageTimingAddSample(stageTimingStage_t stage, uint32_t cycles);
+
+const stageTimingStats_t* stageTimingGetStats(stageTimingStage_t stage);
+
+#ifdef UNIT_TEST_MODE
+/**
+ * Sets the value returned by stageTimingGetCycles on the host, which has no cycle counter.
+ */
+void stageTimingSetHostCycles(uint32_t cycles);
+#endif
@@ -0,0 +1,52 @@
+/* toc_index.h: Constant time lookup of the log and param TOC variables */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * The log and param TOCs are arrays of groups and variables placed by the linker. The index gives each variable its TOC id in
+ * order, maps the ids to the variables' positions in the array (their entry indices), and hashes "group.name" into an open
+ * addressing table of ids. The TOC owns the names, the index only checks the candidates through a match function.
+ */
+typedef struct {
+    // Id + 1 of the variable hashed to each bucket, 0 for an empty bucket
+    uint16_t* buckets;
+    uint16_t bucketCount;
+    uint16_t* entryIndices;
+    uint16_t variableCapacity;
+    uint16_t variableCount;
+} tocIndex_t;
+
+/**
+ * Returns true if the variable at entryIndex in the TOC is group.name.
+ */
+typedef bool (*tocIndexMatchFunction_t)(uint16_t entryIndex, const char* group, const char* name);
+
+/**
+ * Initializes an empty index.
+ *
+ * @param buckets The hash table, bucketCount must be a power of two larger than the number of variables
+ * @param entryIndices The id to entry index map, of variableCapacity elements
+ */
+void tocIndexInit(tocIndex_t* index, uint16_t* buckets, uint16_t bucketCount, uint16_t* entryIndices,
+                  uint16_t variableCapacity);
+
+/**
+ * Gives the next id to the variable at entryIndex in the TOC. The variables must be added in the TOC order.
+ *
+ * @return false if the index is full
+ */
+bool tocIndexAddVariable(tocIndex_t* index, const char* group, const char* name, uint16_t entryIndex);
+
+/**
+ * Returns the id of the first variable added as group.name, or -1 if there is none.
+ */
+int tocIndexFind(const tocIndex_t* index, const char* group, const char* name, tocIndexMatchFunction_t matches);
+
+/**
+ * Returns the entry index of the variable with an id, or -1 if there is none.
+ */
+int tocIndexGetEntryIndex(const tocIndex_t* index, int id);
+
+uint16_t tocIndexGetVariableCount(const tocIndex_t* index);
@@ -43,6 +43,7 @@
 #endif
 
 static bool isInit = false;
+static TaskHandle_t appTaskHandle = NULL;
 
 STATIC_MEM_TASK_ALLOC(appTask, APP_STACKSIZE);
 
@@ -53,7 +54,7 @@ void __attribute__((weak)) appInit() {
         return;
     }
 
-    STATIC_MEM_TASK_CREATE(appTask, appTask, "app", NULL, APP_PRIORITY);
+    appTaskHandle = STATIC_MEM_TASK_CREATE(appTask, appTask, "app", NULL, APP_PRIORITY);
     isInit = true;
 }
 
@@ -66,3 +67,15 @@ static void appTask(void* param) {
         vTaskDelay(portMAX_DELAY);
     }
 }
+
+void appNotify(uint32_t events) {
+    if (appTaskHandle != NULL) {
+        xTaskNotify(appTaskHandle, events, eSetBits);
+    }
+}
+
+uint32_t appWaitForEvents(uint32_t timeout) {
+    uint32_t events = 0;
+    xTaskNotifyWait(0, UINT32_MAX, &events, timeout);
+    return events;
+}
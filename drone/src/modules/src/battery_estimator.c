@@ -0,0 +1,128 @@
+/* battery_estimator.c: State of charge estimated from the motor commands and the battery voltage */
+
+#include <math.h>
+#include "log.h"
+#include "battery_estimator.h"
+
+// Reference voltages - voltages for battery levels from 0% to 100% in 5% increment
+// Voltages for battery levels when idle, landed or crashed
+static const float IDLE_REFERENCE_VOLTAGES[] = {
+    3.27, 3.61, 3.69, 3.71, 3.73, 3.75, 3.77, 3.79, 3.80, 3.82, 3.84, 3.85, 3.87, 3.91, 3.95, 3.98, 4.02, 4.08, 4.11, 4.15, 4.20,
+};
+// Voltages for battery levels during flight
+static const float FLYING_REFERENCE_VOLTAGES[] = {
+    2.350, 3.113, 3.299, 3.324, 3.345, 3.360, 3.380, 3.416, 3.433, 3.452, 3.464,
+    3.481, 3.500, 3.539, 3.571, 3.599, 3.653, 3.716, 3.783, 3.844, 3.910,
+};
+#define REFERENCE_VOLTAGE_COUNT (sizeof(IDLE_REFERENCE_VOLTAGES) / sizeof(IDLE_REFERENCE_VOLTAGES[0]))
+
+// 250 mAh battery
+static const float BATTERY_CAPACITY = 0.25f * 3600.0f; // In A s
+// Current model, the thrust is proportional to the motor command and the power to the thrust to the power of 1.5. It is calibrated so
+// that hovering with the flow and multiranger decks (motor commands around 65%) draws about 2.1 A, which matches a 7 min flight
+static const float ELECTRONICS_CURRENT = 0.1f; // In A
+static const float FULL_THROTTLE_CURRENT = 3.8f; // In A, for the four motors
+static const float MOTOR_RATIO_MAX = 65535.0f;
+// Filter noises, the counted charge drifts slowly while the voltage reading is off by several percent under load
+static const float CHARGE_PROCESS_NOISE = 1e-6f; // In (state of charge)^2 / s
+static const float VOLTAGE_MEASUREMENT_NOISE = 1e-2f; // In (state of charge)^2
+static const float INITIAL_VARIANCE = 1e-3f; // In (state of charge)^2
+// The current drawn while returning is predicted from the current drawn recently, averaged over about 10 s at 100 Hz
+static const float CURRENT_SMOOTHING_FACTOR = 1e-3f;
+// Margin for the path and the current to be longer and higher than predicted, and charge left once landed
+static const float RETURN_SAFETY_FACTOR = 1.3f;
+static const float RETURN_RESERVE = 0.05f;
+static const float LANDING_DURATION = 5.0f; // In s
+
+static bool isInit = false;
+static float stateOfCharge = 0.0f;
+static float variance = INITIAL_VARIANCE;
+static float current = 0.0f; // In A
+static float averageFlyingCurrent = 0.0f; // In A
+
+void batteryEstimatorInit(void) {
+    if (isInit) {
+        return;
+    }
+
+    stateOfCharge = 0.0f;
+    variance = INITIAL_VARIANCE;
+    isInit = true;
+}
+
+bool batteryEstimatorTest(void) {
+    return isInit;
+}
+
+void batteryEstimatorReset(float voltage) {
+    stateOfCharge = batteryEstimatorVoltageToStateOfCharge(voltage, false);
+    variance = INITIAL_VARIANCE;
+    current = ELECTRONICS_CURRENT;
+    averageFlyingCurrent = 0.0f;
+}
+
+void batteryEstimatorUpdate(float voltage, bool isFlying, const uint16_t motorRatios[BATTERY_ESTIMATOR_MOTOR_COUNT], float deltaTime) {
+    float thrustPower = 0.0f;
+    for (uint8_t i = 0; i < BATTERY_ESTIMATOR_MOTOR_COUNT; i++) {
+        const float ratio = motorRatios[i] / MOTOR_RATIO_MAX;
+        thrustPower += ratio * sqrtf(ratio);
+    }
+    current = ELECTRONICS_CURRENT + FULL_THROTTLE_CURRENT * thrustPower / BATTERY_ESTIMATOR_MOTOR_COUNT;
+    if (isFlying) {
+        averageFlyingCurrent = averageFlyingCurrent == 0.0f
+                                   ? current
+                                   : averageFlyingCurrent + CURRENT_SMOOTHING_FACTOR * (current - averageFlyingCurrent);
+    }
+
+    // Predict
+    stateOfCharge -= current * deltaTime / BATTERY_CAPACITY;
+    variance += CHARGE_PROCESS_NOISE * deltaTime;
+
+    // Update
+    const float gain = variance / (variance + VOLTAGE_MEASUREMENT_NOISE);
+    stateOfCharge += gain * (batteryEstimatorVoltageToStateOfCharge(voltage, isFlying) - stateOfCharge);
+    variance *= 1.0f - gain;
+
+    if (stateOfCharge < 0.0f) {
+        stateOfCharge = 0.0f;
+    } else if (stateOfCharge > 1.0f) {
+        stateOfCharge = 1.0f;
+    }
+}
+
+float batteryEstimatorGetStateOfCharge(void) {
+    return stateOfCharge;
+}
+
+float batteryEstimatorGetReturnStateOfCharge(float distance, float velocity) {
+    // Before the first flight, the current is predicted from the current drawn at the moment
+    const float returnCurrent = averageFlyingCurrent > 0.0f ? averageFlyingCurrent : current;
+    const float returnDuration = distance / velocity + LANDING_DURATION;
+    return RETURN_SAFETY_FACTOR * returnCurrent * returnDuration / BATTERY_CAPACITY + RETURN_RESERVE;
+}
+
+float batteryEstimatorVoltageToStateOfCharge(float voltage, bool isFlying) {
+    const float* referenceVoltages = isFlying ? FLYING_REFERENCE_VOLTAGES : IDLE_REFERENCE_VOLTAGES;
+    if (voltage <= referenceVoltages[0]) {
+        return 0.0f;
+    }
+    if (voltage >= referenceVoltages[REFERENCE_VOLTAGE_COUNT - 1]) {
+        return 1.0f;
+    }
+
+    uint8_t referenceVoltageIndex = 0;
+    while (voltage > referenceVoltages[referenceVoltageIndex]) {
+        referenceVoltageIndex++;
+    }
+
+    // Interpolate between the reference voltages
+    const float ratio = (voltage - referenceVoltages[referenceVoltageIndex - 1]) /
+                        (referenceVoltages[referenceVoltageIndex] - referenceVoltages[referenceVoltageIndex - 1]);
+    return (referenceVoltageIndex - 1 + ratio) / (REFERENCE_VOLTAGE_COUNT - 1);
+}
+
+LOG_GROUP_START(battEst)
+LOG_ADD(LOG_FLOAT, stateOfCharge, &stateOfCharge)
+LOG_ADD(LOG_FLOAT, variance, &variance)
+LOG_ADD(LOG_FLOAT, current, &current)
+LOG_GROUP_STOP(battEst)
@@ -0,0 +1,126 @@
+/* breadcrumb_trail.c: Trail of the positions the drone flew through, followed backwards to return to the base */
+
+#include <math.h>
+#include "log.h"
+#include "occupancy_grid.h"
+#include "breadcrumb_trail.h"
+
+// A breadcrumb closer than this to the drone has been reached
+static const float BREADCRUMB_REACHED_DISTANCE = 0.3f;
+
+static bool isInit = false;
+// Only the horizontal position is kept, the drone returns at its exploration height
+static float breadcrumbXs[BREADCRUMB_TRAIL_MAX_COUNT];
+static float breadcrumbYs[BREADCRUMB_TRAIL_MAX_COUNT];
+static uint8_t breadcrumbCount = 0;
+
+static float getDistance(uint8_t index, const point_t* position) {
+    const float deltaX = breadcrumbXs[index] - position->x;
+    const float deltaY = breadcrumbYs[index] - position->y;
+    return sqrtf(deltaX * deltaX + deltaY * deltaY);
+}
+
+static point_t getBreadcrumb(uint8_t index, const point_t* position) {
+    const point_t breadcrumb = {.x = breadcrumbXs[index], .y = breadcrumbYs[index], .z = position->z};
+    return breadcrumb;
+}
+
+static void removeEveryOtherBreadcrumb(void) {
+    // Keep the base and the latest breadcrumb
+    uint8_t count = 1;
+    for (uint8_t i = 2; i < breadcrumbCount - 1; i += 2) {
+        breadcrumbXs[count] = breadcrumbXs[i];
+        breadcrumbYs[count] = breadcrumbYs[i];
+        count++;
+    }
+    breadcrumbXs[count] = breadcrumbXs[breadcrumbCount - 1];
+    breadcrumbYs[count] = breadcrumbYs[breadcrumbCount - 1];
+    breadcrumbCount = count + 1;
+}
+
+void breadcrumbTrailInit(void) {
+    if (isInit) {
+        return;
+    }
+
+    breadcrumbCount = 0;
+    isInit = true;
+}
+
+bool breadcrumbTrailTest(void) {
+    return isInit;
+}
+
+void breadcrumbTrailReset(const point_t* base) {
+    breadcrumbXs[0] = base->x;
+    breadcrumbYs[0] = base->y;
+    breadcrumbCount = 1;
+}
+
+void breadcrumbTrailAdd(const point_t* position) {
+    if (breadcrumbCount == 0 || getDistance(breadcrumbCount - 1, position) < BREADCRUMB_TRAIL_SPACING) {
+        return;
+    }
+
+    // The oldest breadcrumb the drone came back to gives the shortest trail
+    for (uint8_t i = 0; i < breadcrumbCount - 1; i++) {
+        if (getDistance(i, position) < BREADCRUMB_TRAIL_SPACING) {
+            const point_t breadcrumb = getBreadcrumb(i, position);
+            if (occupancyGridIsSegmentFree(position, &breadcrumb)) {
+                breadcrumbCount = i + 1;
+                return;
+            }
+        }
+    }
+
+    if (breadcrumbCount == BREADCRUMB_TRAIL_MAX_COUNT) {
+        removeEveryOtherBreadcrumb();
+    }
+    breadcrumbXs[breadcrumbCount] = position->x;
+    breadcrumbYs[breadcrumbCount] = position->y;
+    breadcrumbCount++;
+}
+
+bool breadcrumbTrailGetNextWaypoint(const point_t* position, point_t* waypoint) {
+    if (breadcrumbCount == 0) {
+        return false;
+    }
+
+    // Breadcrumbs which were reached are no longer needed, but the base is kept to return to it
+    while (breadcrumbCount > 1 && getDistance(breadcrumbCount - 1, position) < BREADCRUMB_REACHED_DISTANCE) {
+        breadcrumbCount--;
+    }
+
+    for (uint8_t i = 0; i < breadcrumbCount - 1; i++) {
+        const point_t breadcrumb = getBreadcrumb(i, position);
+        if (occupancyGridIsSegmentFree(position, &breadcrumb)) {
+            breadcrumbCount = i + 1;
+            break;
+        }
+    }
+
+    *waypoint = getBreadcrumb(breadcrumbCount - 1, position);
+    return true;
+}
+
+float breadcrumbTrailGetLength(const point_t* position) {
+    if (breadcrumbCount == 0) {
+        return 0.0f;
+    }
+
+    float length = getDistance(breadcrumbCount - 1, position);
+    for (uint8_t i = 1; i < breadcrumbCount; i++) {
+        const float deltaX = breadcrumbXs[i] - breadcrumbXs[i - 1];
+        const float deltaY = breadcrumbYs[i] - breadcrumbYs[i - 1];
+        length += sqrtf(deltaX * deltaX + deltaY * deltaY);
+    }
+    return length;
+}
+
+uint8_t breadcrumbTrailGetCount(void) {
+    return breadcrumbCount;
+}
+
+LOG_GROUP_START(breadcrumb)
+LOG_ADD(LOG_UINT8, count, &breadcrumbCount)
+LOG_GROUP_STOP(breadcrumb)
@@ -61,7 +61,6 @@
 #include "kalman_supervisor.h"
 
 #include "FreeRTOS.h"
-#include "queue.h"
 #include "task.h"
 #include "semphr.h"
 #include "sensors.h"
@@ -72,6 +71,7 @@
 #include "param.h"
 #include "physicalConstants.h"
 
+#include "spsc_queue.h"
 #include "statsCnt.h"
 #include "rateSupervisor.h"
 
@@ -80,6 +80,8 @@
 
 // #define KALMAN_USE_BARO_UPDATE
 
+// Define KALMAN_BATCH_UPDATE to apply the measurements of each loop in a single vector update, instead of one scalar update each
+
 /**
  * Additionally, the filter supports the incorporation of additional sensors into the state estimate
  *
@@ -91,75 +93,37 @@
  * As well as by the following internal functions and datatypes
  */
 
-// Distance-to-point measurements
-static xQueueHandle distDataQueue;
-STATIC_MEM_QUEUE_ALLOC(distDataQueue, 10, sizeof(distanceMeasurement_t));
+/**
+ * Each measurement source writes to its own lock-free queue, which the kalman task drains in one pass per loop.
+ * The queues assume a single producer: position measurements come from both the lighthouse and the CRTP localization
+ * tasks, so that queue alone serializes its producers with a critical section.
+ */
+#define MEASUREMENT_QUEUE_SIZE 16
 
-static inline bool stateEstimatorHasDistanceMeasurement(distanceMeasurement_t* dist) {
-    return (pdTRUE == xQueueReceive(distDataQueue, dist, 0));
-}
+// Distance-to-point measurements
+SPSC_QUEUE_DEFINE(distDataQueue, MEASUREMENT_QUEUE_SIZE, distanceMeasurement_t);
 
 // Direct measurements of Crazyflie position
-static xQueueHandle posDataQueue;
-STATIC_MEM_QUEUE_ALLOC(posDataQueue, 10, sizeof(positionMeasurement_t));
-
-static inline bool stateEstimatorHasPositionMeasurement(positionMeasurement_t* pos) {
-    return (pdTRUE == xQueueReceive(posDataQueue, pos, 0));
-}
+SPSC_QUEUE_DEFINE(posDataQueue, MEASUREMENT_QUEUE_SIZE, positionMeasurement_t);
 
 // Direct measurements of Crazyflie pose
-static xQueueHandle poseDataQueue;
-STATIC_MEM_QUEUE_ALLOC(poseDataQueue, 10, sizeof(poseMeasurement_t));
-
-static inline bool stateEstimatorHasPoseMeasurement(poseMeasurement_t* pose) {
-    return (pdTRUE == xQueueReceive(poseDataQueue, pose, 0));
-}
+SPSC_QUEUE_DEFINE(poseDataQueue, MEASUREMENT_QUEUE_SIZE, poseMeasurement_t);
 
 // Measurements of a UWB Tx/Rx
-static xQueueHandle tdoaDataQueue;
-STATIC_MEM_QUEUE_ALLOC(tdoaDataQueue, 10, sizeof(tdoaMeasurement_t));
-
-static inline bool stateEstimatorHasTDOAPacket(tdoaMeasurement_t* uwb) {
-    return (pdTRUE == xQueueReceive(tdoaDataQueue, uwb, 0));
-}
+SPSC_QUEUE_DEFINE(tdoaDataQueue, MEASUREMENT_QUEUE_SIZE, tdoaMeasurement_t);
 
 // Measurements of flow (dnx, dny)
-static xQueueHandle flowDataQueue;
-STATIC_MEM_QUEUE_ALLOC(flowDataQueue, 10, sizeof(flowMeasurement_t));
-
-static inline bool stateEstimatorHasFlowPacket(flowMeasurement_t* flow) {
-    return (pdTRUE == xQueueReceive(flowDataQueue, flow, 0));
-}
+SPSC_QUEUE_DEFINE(flowDataQueue, MEASUREMENT_QUEUE_SIZE, flowMeasurement_t);
 
 // Measurements of TOF from laser sensor
-static xQueueHandle tofDataQueue;
-STATIC_MEM_QUEUE_ALLOC(tofDataQueue, 10, sizeof(tofMeasurement_t));
-
-static inline bool stateEstimatorHasTOFPacket(tofMeasurement_t* tof) {
-    return (pdTRUE == xQueueReceive(tofDataQueue, tof, 0));
-}
+SPSC_QUEUE_DEFINE(tofDataQueue, MEASUREMENT_QUEUE_SIZE, tofMeasurement_t);
 
 // Absolute height measurement along the room Z
-static xQueueHandle heightDataQueue;
-STATIC_MEM_QUEUE_ALLOC(heightDataQueue, 10, sizeof(heightMeasurement_t));
-
-static inline bool stateEstimatorHasHeightPacket(heightMeasurement_t* height) {
-    return (pdTRUE == xQueueReceive(heightDataQueue, height, 0));
-}
-
-static xQueueHandle yawErrorDataQueue;
-STATIC_MEM_QUEUE_ALLOC(yawErrorDataQueue, 10, sizeof(yawErrorMeasurement_t));
+SPSC_QUEUE_DEFINE(heightDataQueue, MEASUREMENT_QUEUE_SIZE, heightMeasurement_t);
 
-static inline bool stateEstimatorHasYawErrorPacket(yawErrorMeasurement_t* error) {
-    return (pdTRUE == xQueueReceive(yawErrorDataQueue, error, 0));
-}
-
-static xQueueHandle sweepAnglesDataQueue;
-STATIC_MEM_QUEUE_ALLOC(sweepAnglesDataQueue, 10, sizeof(sweepAngleMeasurement_t));
+SPSC_QUEUE_DEFINE(yawErrorDataQueue, MEASUREMENT_QUEUE_SIZE, yawErrorMeasurement_t);
 
-static inline bool stateEstimatorHasSweepAnglesPacket(sweepAngleMeasurement_t* angles) {
-    return (pdTRUE == xQueueReceive(sweepAnglesDataQueue, angles, 0));
-}
+SPSC_QUEUE_DEFINE(sweepAnglesDataQueue, MEASUREMENT_QUEUE_SIZE, sweepAngleMeasurement_t);
 
 // Semaphore to signal that we got data from the stabilzer loop to process
 static SemaphoreHandle_t runTaskSemaphore;
@@ -218,6 +182,9 @@ static uint32_t thrustAccumulatorCount;
 static uint32_t gyroAccumulatorCount;
 static uint32_t baroAccumulatorCount;
 static bool quadIsFlying = false;
+// Set by estimatorKalmanInit, which can run in another task, for the kalman task to reset the queues before its next drain since only
+// the consumer may move their read index
+static bool resetQueuesRequested = false;
 static uint32_t lastFlightCmd;
 static uint32_t takeoffTime;
 
@@ -256,16 +223,6 @@ STATIC_MEM_TASK_ALLOC_STACK_NO_DMA_CCM_SAFE(kalmanTask, 3 * configMINIMAL_STACK_
 
 // Called one time during system startup
 void estimatorKalmanTaskInit() {
-    distDataQueue = STATIC_MEM_QUEUE_CREATE(distDataQueue);
-    posDataQueue = STATIC_MEM_QUEUE_CREATE(posDataQueue);
-    poseDataQueue = STATIC_MEM_QUEUE_CREATE(poseDataQueue);
-    tdoaDataQueue = STATIC_MEM_QUEUE_CREATE(tdoaDataQueue);
-    flowDataQueue = STATIC_MEM_QUEUE_CREATE(flowDataQueue);
-    tofDataQueue = STATIC_MEM_QUEUE_CREATE(tofDataQueue);
-    heightDataQueue = STATIC_MEM_QUEUE_CREATE(heightDataQueue);
-    yawErrorDataQueue = STATIC_MEM_QUEUE_CREATE(yawErrorDataQueue);
-    sweepAnglesDataQueue = STATIC_MEM_QUEUE_CREATE(sweepAnglesDataQueue);
-
     vSemaphoreCreateBinary(runTaskSemaphore);
 
     dataMutex = xSemaphoreCreateMutexStatic(&dataMutexBuffer);
@@ -334,6 +291,10 @@ static void kalmanTask(void* parameters) {
             }
         }
 
+#ifdef KALMAN_BATCH_UPDATE
+        kalmanCoreBeginBatchUpdate(&coreData);
+#endif
+
         /**
          * Update the state estimate with the barometer measurements
          */
@@ -367,6 +328,10 @@ static void kalmanTask(void* parameters) {
             }
         }
 
+#ifdef KALMAN_BATCH_UPDATE
+        kalmanCoreEndBatchUpdate(&coreData);
+#endif
+
         /**
          * If an update has been made, the state is finalized:
          * - the attitude error is moved into the body attitude quaternion,
@@ -497,71 +462,90 @@ static bool updateQueuedMeasurments(const Axis3f* gyro, const uint32_t tick) {
      * we therefore consume all measurements since the last loop, rather than accumulating
      */
 
-    tofMeasurement_t tof;
-    while (stateEstimatorHasTOFPacket(&tof)) {
-        kalmanCoreUpdateWithTof(&coreData, &tof);
-        doneUpdate = true;
+    if (__atomic_exchange_n(&resetQueuesRequested, false, __ATOMIC_ACQUIRE)) {
+        spscQueueReset(&distDataQueue);
+        spscQueueReset(&posDataQueue);
+        spscQueueReset(&poseDataQueue);
+        spscQueueReset(&tdoaDataQueue);
+        spscQueueReset(&flowDataQueue);
+        spscQueueReset(&tofDataQueue);
+        spscQueueReset(&heightDataQueue);
+        spscQueueReset(&yawErrorDataQueue);
+        spscQueueReset(&sweepAnglesDataQueue);
     }
 
-    yawErrorMeasurement_t yawError;
-    while (stateEstimatorHasYawErrorPacket(&yawError)) {
-        kalmanCoreUpdateWithYawError(&coreData, &yawError);
-        doneUpdate = true;
+    // The measurements are read in place and released once handled
+    uint32_t count;
+
+    count = spscQueueGetPendingCount(&tofDataQueue);
+    for (uint32_t i = 0; i < count; i++) {
+        kalmanCoreUpdateWithTof(&coreData, (tofMeasurement_t*)spscQueueGetPending(&tofDataQueue, i));
     }
+    spscQueueRelease(&tofDataQueue, count);
+    doneUpdate |= count > 0;
 
-    heightMeasurement_t height;
-    while (stateEstimatorHasHeightPacket(&height)) {
-        kalmanCoreUpdateWithAbsoluteHeight(&coreData, &height);
-        doneUpdate = true;
+    count = spscQueueGetPendingCount(&yawErrorDataQueue);
+    for (uint32_t i = 0; i < count; i++) {
+        kalmanCoreUpdateWithYawError(&coreData, (yawErrorMeasurement_t*)spscQueueGetPending(&yawErrorDataQueue, i));
     }
+    spscQueueRelease(&yawErrorDataQueue, count);
+    doneUpdate |= count > 0;
 
-    distanceMeasurement_t dist;
-    while (stateEstimatorHasDistanceMeasurement(&dist)) {
-        kalmanCoreUpdateWithDistance(&coreData, &dist);
-        doneUpdate = true;
+    count = spscQueueGetPendingCount(&heightDataQueue);
+    for (uint32_t i = 0; i < count; i++) {
+        kalmanCoreUpdateWithAbsoluteHeight(&coreData, (heightMeasurement_t*)spscQueueGetPending(&heightDataQueue, i));
     }
+    spscQueueRelease(&heightDataQueue, count);
+    doneUpdate |= count > 0;
 
-    positionMeasurement_t pos;
-    while (stateEstimatorHasPositionMeasurement(&pos)) {
-        kalmanCoreUpdateWithPosition(&coreData, &pos);
-        doneUpdate = true;
+    count = spscQueueGetPendingCount(&distDataQueue);
+    for (uint32_t i = 0; i < count; i++) {
+        kalmanCoreUpdateWithDistance(&coreData, (distanceMeasurement_t*)spscQueueGetPending(&distDataQueue, i));
     }
+    spscQueueRelease(&distDataQueue, count);
+    doneUpdate |= count > 0;
 
-    poseMeasurement_t pose;
-    while (stateEstimatorHasPoseMeasurement(&pose)) {
-        kalmanCoreUpdateWithPose(&coreData, &pose);
-        doneUpdate = true;
+    count = spscQueueGetPendingCount(&posDataQueue);
+    for (uint32_t i = 0; i < count; i++) {
+        kalmanCoreUpdateWithPosition(&coreData, (positionMeasurement_t*)spscQueueGetPending(&posDataQueue, i));
     }
+    spscQueueRelease(&posDataQueue, count);
+    doneUpdate |= count > 0;
 
-    tdoaMeasurement_t tdoa;
-    while (stateEstimatorHasTDOAPacket(&tdoa)) {
-        kalmanCoreUpdateWithTDOA(&coreData, &tdoa);
-        doneUpdate = true;
+    count = spscQueueGetPendingCount(&poseDataQueue);
+    for (uint32_t i = 0; i < count; i++) {
+        kalmanCoreUpdateWithPose(&coreData, (poseMeasurement_t*)spscQueueGetPending(&poseDataQueue, i));
     }
+    spscQueueRelease(&poseDataQueue, count);
+    doneUpdate |= count > 0;
 
-    flowMeasurement_t flow;
-    while (stateEstimatorHasFlowPacket(&flow)) {
-        kalmanCoreUpdateWithFlow(&coreData, &flow, gyro);
-        doneUpdate = true;
+    count = spscQueueGetPendingCount(&tdoaDataQueue);
+    for (uint32_t i = 0; i < count; i++) {
+        kalmanCoreUpdateWithTDOA(&coreData, (tdoaMeasurement_t*)spscQueueGetPending(&tdoaDataQueue, i));
     }
+    spscQueueRelease(&tdoaDataQueue, count);
+    doneUpdate |= count > 0;
 
-    sweepAngleMeasurement_t angles;
-    while (stateEstimatorHasSweepAnglesPacket(&angles)) {
-        kalmanCoreUpdateWithSweepAngles(&coreData, &angles, tick);
-        doneUpdate = true;
+    count = spscQueueGetPendingCount(&flowDataQueue);
+    for (uint32_t i = 0; i < count; i++) {
+        kalmanCoreUpdateWithFlow(&coreData, (flowMeasurement_t*)spscQueueGetPending(&flowDataQueue, i), gyro);
     }
+    spscQueueRelease(&flowDataQueue, count);
+    doneUpdate |= count > 0;
+
+    count = spscQueueGetPendingCount(&sweepAnglesDataQueue);
+    for (uint32_t i = 0; i < count; i++) {
+        kalmanCoreUpdateWithSweepAngles(&coreData, (sweepAngleMeasurement_t*)spscQueueGetPending(&sweepAnglesDataQueue, i), tick);
+    }
+    spscQueueRelease(&sweepAnglesDataQueue, count);
+    doneUpdate |= count > 0;
 
     return doneUpdate;
 }
 
 // Called when this estimator is activated
 void estimatorKalmanInit(void) {
-    xQueueReset(distDataQueue);
-    xQueueReset(posDataQueue);
-    xQueueReset(poseDataQueue);
-    xQueueReset(tdoaDataQueue);
-    xQueueReset(flowDataQueue);
-    xQueueReset(tofDataQueue);
+    __atomic_store_n(&resetQueuesRequested, true, __ATOMIC_RELEASE);
 
     xSemaphoreTake(dataMutex, portMAX_DELAY);
     accAccumulator = (Axis3f){.axis = {0}};
@@ -578,21 +562,8 @@ void estimatorKalmanInit(void) {
     kalmanCoreInit(&coreData);
 }
 
-static bool appendMeasurement(xQueueHandle queue, void* measurement) {
-    portBASE_TYPE result;
-    bool isInInterrupt = (SCB->ICSR & SCB_ICSR_VECTACTIVE_Msk) != 0;
-
-    if (isInInterrupt) {
-        portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE;
-        result = xQueueSendFromISR(queue, measurement, &xHigherPriorityTaskWoken);
-        if (xHigherPriorityTaskWoken == pdTRUE) {
-            portYIELD();
-        }
-    } else {
-        result = xQueueSend(queue, measurement, 0);
-    }
-
-    if (result == pdTRUE) {
+static bool appendMeasurement(spscQueue_t* queue, const void* measurement) {
+    if (spscQueuePush(queue, measurement)) {
         STATS_CNT_RATE_EVENT(&measurementAppendedCounter);
         return true;
     } else {
@@ -603,50 +574,54 @@ static bool appendMeasurement(xQueueHandle queue, void* measurement) {
 
 bool estimatorKalmanEnqueueTDOA(const tdoaMeasurement_t* uwb) {
     ASSERT(isInit);
-    return appendMeasurement(tdoaDataQueue, (void*)uwb);
+    return appendMeasurement(&tdoaDataQueue, uwb);
 }
 
 bool estimatorKalmanEnqueuePosition(const positionMeasurement_t* pos) {
     ASSERT(isInit);
-    return appendMeasurement(posDataQueue, (void*)pos);
+    // The only queue with several producers
+    taskENTER_CRITICAL();
+    bool result = appendMeasurement(&posDataQueue, pos);
+    taskEXIT_CRITICAL();
+    return result;
 }
 
 bool estimatorKalmanEnqueuePose(const poseMeasurement_t* pose) {
     ASSERT(isInit);
-    return appendMeasurement(poseDataQueue, (void*)pose);
+    return appendMeasurement(&poseDataQueue, pose);
 }
 
 bool estimatorKalmanEnqueueDistance(const distanceMeasurement_t* dist) {
     ASSERT(isInit);
-    return appendMeasurement(distDataQueue, (void*)dist);
+    return appendMeasurement(&distDataQueue, dist);
 }
 
 bool estimatorKalmanEnqueueFlow(const flowMeasurement_t* flow) {
     // A flow measurement (dnx,  dny) [accumulated pixels]
     ASSERT(isInit);
-    return appendMeasurement(flowDataQueue, (void*)flow);
+    return appendMeasurement(&flowDataQueue, flow);
 }
 
 bool estimatorKalmanEnqueueTOF(const tofMeasurement_t* tof) {
     // A distance (distance) [m] to the ground along the z_B axis.
     ASSERT(isInit);
-    return appendMeasurement(tofDataQueue, (void*)tof);
+    return appendMeasurement(&tofDataQueue, tof);
 }
 
 bool estimatorKalmanEnqueueAbsoluteHeight(const heightMeasurement_t* height) {
     // A distance (height) [m] to the ground along the z axis.
     ASSERT(isInit);
-    return appendMeasurement(heightDataQueue, (void*)height);
+    return appendMeasurement(&heightDataQueue, height);
 }
 
 bool estimatorKalmanEnqueueYawError(const yawErrorMeasurement_t* error) {
     ASSERT(isInit);
-    return appendMeasurement(yawErrorDataQueue, (void*)error);
+    return appendMeasurement(&yawErrorDataQueue, error);
 }
 
 bool estimatorKalmanEnqueueSweepAngles(const sweepAngleMeasurement_t* angles) {
     ASSERT(isInit);
-    return appendMeasurement(sweepAnglesDataQueue, (void*)angles);
+    return appendMeasurement(&sweepAnglesDataQueue, angles);
 }
 
 bool estimatorKalmanTest(void) {
@@ -703,8 +678,24 @@ STATS_CNT_RATE_LOG_ADD(rtBaro, &baroUpdateCounter)
 STATS_CNT_RATE_LOG_ADD(rtFinal, &finalizeCounter)
 STATS_CNT_RATE_LOG_ADD(rtApnd, &measurementAppendedCounter)
 STATS_CNT_RATE_LOG_ADD(rtRej, &measurementNotAppendedCounter)
+LOG_ADD(LOG_UINT32, batchFallbacks, &coreData.batch.fallbackCount)
 LOG_GROUP_STOP(kalman)
 
+/**
+ * Measurements dropped because the kalman task did not drain their queue in time
+ */
+LOG_GROUP_START(kalmanQueue)
+LOG_ADD(LOG_UINT32, ovDist, &distDataQueue.overrunCount)
+LOG_ADD(LOG_UINT32, ovPos, &posDataQueue.overrunCount)
+LOG_ADD(LOG_UINT32, ovPose, &poseDataQueue.overrunCount)
+LOG_ADD(LOG_UINT32, ovTdoa, &tdoaDataQueue.overrunCount)
+LOG_ADD(LOG_UINT32, ovFlow, &flowDataQueue.overrunCount)
+LOG_ADD(LOG_UINT32, ovTof, &tofDataQueue.overrunCount)
+LOG_ADD(LOG_UINT32, ovHeight, &heightDataQueue.overrunCount)
+LOG_ADD(LOG_UINT32, ovYawErr, &yawErrorDataQueue.overrunCount)
+LOG_ADD(LOG_UINT32, ovSweep, &sweepAnglesDataQueue.overrunCount)
+LOG_GROUP_STOP(kalmanQueue)
+
 PARAM_GROUP_START(kalman)
 PARAM_ADD(PARAM_UINT8, resetEstimation, &coreData.resetEstimation)
 PARAM_ADD(PARAM_UINT8, quadIsFlying, &quadIsFlying)
@@ -138,8 +138,42 @@ static float initialYaw = 0.0;
 // Quaternion used for initial yaw
 static float initialQuaternion[4] = {0.0, 0.0, 0.0, 0.0};
 
+// Skip the products with the zeros of A and H in the covariance updates, which gives the same result as the dense products
+static uint8_t isCovarianceUpdateSparse = 1;
+
+#ifdef UNIT_TEST_MODE
+static uint32_t multiplyAccumulateCount = 0;
+#define COUNT_MULTIPLY_ACCUMULATES(count) (multiplyAccumulateCount += (count))
+
+uint32_t kalmanCoreGetMultiplyAccumulateCount(void) {
+    return multiplyAccumulateCount;
+}
+
+void kalmanCoreResetMultiplyAccumulateCount(void) {
+    multiplyAccumulateCount = 0;
+}
+#else
+#define COUNT_MULTIPLY_ACCUMULATES(count)
+#endif
+
 static uint32_t tdoaCount;
 
+// Ensures the symmetry of the covariance matrix, and that its values stay bounded
+static void boundCovariance(kalmanCoreData_t* this) {
+    for (int i = 0; i < KC_STATE_DIM; i++) {
+        for (int j = i; j < KC_STATE_DIM; j++) {
+            float p = 0.5f * this->P[i][j] + 0.5f * this->P[j][i];
+            if (isnan(p) || p > MAX_COVARIANCE) {
+                this->P[i][j] = this->P[j][i] = MAX_COVARIANCE;
+            } else if (i == j && p < MIN_COVARIANCE) {
+                this->P[i][j] = this->P[j][i] = MIN_COVARIANCE;
+            } else {
+                this->P[i][j] = this->P[j][i] = p;
+            }
+        }
+    }
+}
+
 static OutlierFilterLhState_t sweepOutlierFilterState;
 
 void kalmanCoreInit(kalmanCoreData_t* this) {
@@ -204,6 +238,275 @@ void kalmanCoreInit(kalmanCoreData_t* this) {
     outlierFilterReset(&sweepOutlierFilterState, 0);
 }
 
+void kalmanCoreSetSparseCovarianceUpdate(bool isEnabled) {
+    isCovarianceUpdateSparse = isEnabled;
+}
+
+static float getJosephElement(const float K[KC_STATE_DIM], const float h[KC_STATE_DIM], int row, int column) {
+    float element = K[row] * h[column];
+    if (row == column) {
+        element -= 1;
+    }
+    return element;
+}
+
+// Lists the columns where h is nonzero and the diagonal column of a row of (KH - I), in increasing order
+static int getJosephColumns(const uint8_t hColumns[KC_STATE_DIM], int hColumnCount, int row, uint8_t columns[KC_STATE_DIM]) {
+    int count = 0;
+    bool isRowAdded = false;
+    for (int i = 0; i < hColumnCount; i++) {
+        if (!isRowAdded && row <= hColumns[i]) {
+            isRowAdded = true;
+            if (row < hColumns[i]) {
+                columns[count++] = row;
+            }
+        }
+        columns[count++] = hColumns[i];
+    }
+    if (!isRowAdded) {
+        columns[count++] = row;
+    }
+    return count;
+}
+
+/**
+ * Computes (KH - I)*P*(KH - I)'. (KH - I) is only nonzero in the columns where h is nonzero and on its diagonal, so its elements
+ * are computed when needed and only those columns are multiplied. They are added in increasing order like in the dense products.
+ */
+static void josephCovarianceUpdateSparse(kalmanCoreData_t* this, const float h[KC_STATE_DIM], const float K[KC_STATE_DIM]) {
+    NO_DMA_CCM_SAFE_ZERO_INIT static float KHIP[KC_STATE_DIM][KC_STATE_DIM];
+
+    uint8_t hColumns[KC_STATE_DIM];
+    int hColumnCount = 0;
+    for (int i = 0; i < KC_STATE_DIM; i++) {
+        if (h[i] != 0.0f) {
+            hColumns[hColumnCount++] = i;
+        }
+    }
+
+    uint8_t columns[KC_STATE_DIM];
+    for (int i = 0; i < KC_STATE_DIM; i++) {
+        int columnCount = getJosephColumns(hColumns, hColumnCount, i, columns);
+        for (int j = 0; j < KC_STATE_DIM; j++) {
+            float sum = 0;
+            for (int c = 0; c < columnCount; c++) {
+                sum += getJosephElement(K, h, i, columns[c]) * this->P[columns[c]][j];
+            }
+            KHIP[i][j] = sum; // (KH - I)*P
+        }
+        COUNT_MULTIPLY_ACCUMULATES(columnCount * KC_STATE_DIM);
+    }
+
+    for (int j = 0; j < KC_STATE_DIM; j++) {
+        int columnCount = getJosephColumns(hColumns, hColumnCount, j, columns);
+        for (int i = 0; i < KC_STATE_DIM; i++) {
+            float sum = 0;
+            for (int c = 0; c < columnCount; c++) {
+                sum += KHIP[i][columns[c]] * getJosephElement(K, h, j, columns[c]);
+            }
+            this->P[i][j] = sum; // (KH - I)*P*(KH - I)'
+        }
+        COUNT_MULTIPLY_ACCUMULATES(columnCount * KC_STATE_DIM);
+    }
+}
+
+// Decomposes a symmetric matrix into L*L' in place, L being stored in the lower triangle
+static bool choleskyDecompose(float A[KC_MAX_BATCH_SIZE][KC_MAX_BATCH_SIZE], int size) {
+    for (int j = 0; j < size; j++) {
+        float diagonal = A[j][j];
+        for (int k = 0; k < j; k++) {
+            diagonal -= A[j][k] * A[j][k];
+        }
+        COUNT_MULTIPLY_ACCUMULATES(j);
+        if (!(diagonal > 0.0f)) {
+            return false; // Not positive definite, or NaN
+        }
+        A[j][j] = arm_sqrt(diagonal);
+
+        for (int i = j + 1; i < size; i++) {
+            float sum = A[i][j];
+            for (int k = 0; k < j; k++) {
+                sum -= A[i][k] * A[j][k];
+            }
+            A[i][j] = sum / A[j][j];
+            COUNT_MULTIPLY_ACCUMULATES(j);
+        }
+    }
+    return true;
+}
+
+// Solves L*L'*x = b in place, b being given in x
+static void choleskySolve(float L[KC_MAX_BATCH_SIZE][KC_MAX_BATCH_SIZE], int size, float x[KC_MAX_BATCH_SIZE]) {
+    for (int i = 0; i < size; i++) {
+        float sum = x[i];
+        for (int k = 0; k < i; k++) {
+            sum -= L[i][k] * x[k];
+        }
+        x[i] = sum / L[i][i];
+    }
+    COUNT_MULTIPLY_ACCUMULATES(size * (size - 1) / 2);
+    for (int i = size - 1; i >= 0; i--) {
+        float sum = x[i];
+        for (int k = i + 1; k < size; k++) {
+            sum -= L[k][i] * x[k];
+        }
+        x[i] = sum / L[i][i];
+    }
+    COUNT_MULTIPLY_ACCUMULATES(size * (size - 1) / 2);
+}
+
+static void scalarUpdate(kalmanCoreData_t* this, arm_matrix_instance_f32* Hm, float error, float stdMeasNoise);
+
+// Applies the measurements of the batch one by one. Their errors were computed at the state before the batch, so they are corrected
+// by the state change of the previous measurements, as if each one was linearized at the state it is applied to
+static void applyBatchSequentially(kalmanCoreData_t* this, int size) {
+    kalmanCoreMeasurementBatch_t* batch = &this->batch;
+    float initialState[KC_STATE_DIM];
+    memcpy(initialState, this->S, sizeof(initialState));
+
+    const bool isCollecting = batch->isCollecting;
+    batch->isCollecting = false;
+    for (int r = 0; r < size; r++) {
+        float error = batch->error[r];
+        for (int k = 0; k < KC_STATE_DIM; k++) {
+            error -= batch->H[r][k] * (this->S[k] - initialState[k]);
+        }
+        COUNT_MULTIPLY_ACCUMULATES(KC_STATE_DIM);
+        arm_matrix_instance_f32 Hm = {1, KC_STATE_DIM, batch->H[r]};
+        scalarUpdate(this, &Hm, error, arm_sqrt(batch->variance[r]));
+    }
+    batch->isCollecting = isCollecting;
+}
+
+static void applyBatch(kalmanCoreData_t* this) {
+    kalmanCoreMeasurementBatch_t* batch = &this->batch;
+    const int size = batch->size;
+    batch->size = 0;
+    if (size == 0) {
+        return;
+    }
+
+    NO_DMA_CCM_SAFE_ZERO_INIT static float HP[KC_MAX_BATCH_SIZE][KC_STATE_DIM];
+    NO_DMA_CCM_SAFE_ZERO_INIT static float K[KC_STATE_DIM][KC_MAX_BATCH_SIZE];
+    NO_DMA_CCM_SAFE_ZERO_INIT static float KHIP[KC_STATE_DIM][KC_STATE_DIM];
+    NO_DMA_CCM_SAFE_ZERO_INIT static float KHIPHT[KC_STATE_DIM][KC_MAX_BATCH_SIZE];
+    float HPHR[KC_MAX_BATCH_SIZE][KC_MAX_BATCH_SIZE];
+
+    // ====== INNOVATION COVARIANCE ======
+    // The rows of H are sparse, so only their nonzero elements are multiplied
+    for (int r = 0; r < size; r++) {
+        for (int j = 0; j < KC_STATE_DIM; j++) {
+            float sum = 0;
+            for (int k = 0; k < KC_STATE_DIM; k++) {
+                if (batch->H[r][k] != 0.0f) {
+                    sum += batch->H[r][k] * this->P[k][j];
+                    COUNT_MULTIPLY_ACCUMULATES(1);
+                }
+            }
+            HP[r][j] = sum;
+        }
+    }
+
+    for (int r = 0; r < size; r++) {
+        for (int c = 0; c <= r; c++) {
+            float sum = r == c ? batch->variance[r] : 0;
+            for (int k = 0; k < KC_STATE_DIM; k++) {
+                if (batch->H[c][k] != 0.0f) {
+                    sum += HP[r][k] * batch->H[c][k];
+                    COUNT_MULTIPLY_ACCUMULATES(1);
+                }
+            }
+            HPHR[r][c] = HPHR[c][r] = sum; // HPH' + R
+        }
+    }
+    if (!choleskyDecompose(HPHR, size)) {
+        // Rather than halting the estimator, the batch is applied through the scalar updates, which bound a degenerate covariance
+        batch->fallbackCount++;
+        applyBatchSequentially(this, size);
+        return;
+    }
+
+    // ====== MEASUREMENT UPDATE ======
+    // P is symmetric so PH' = (HP)', each row of the Kalman gain K = PH' (HPH' + R)^-1 is solved from a column of HP
+    for (int i = 0; i < KC_STATE_DIM; i++) {
+        float gain[KC_MAX_BATCH_SIZE];
+        for (int r = 0; r < size; r++) {
+            gain[r] = HP[r][i];
+        }
+        choleskySolve(HPHR, size, gain);
+
+        for (int r = 0; r < size; r++) {
+            K[i][r] = gain[r];
+            this->S[i] += gain[r] * batch->error[r]; // state update
+        }
+        COUNT_MULTIPLY_ACCUMULATES(size);
+    }
+    assertStateNotNaN(this);
+
+    // ====== COVARIANCE UPDATE ======
+    for (int i = 0; i < KC_STATE_DIM; i++) {
+        for (int j = 0; j < KC_STATE_DIM; j++) {
+            float sum = -this->P[i][j];
+            for (int r = 0; r < size; r++) {
+                sum += K[i][r] * HP[r][j];
+            }
+            KHIP[i][j] = sum; // (KH - I)*P = K*HP - P
+        }
+        COUNT_MULTIPLY_ACCUMULATES(KC_STATE_DIM * size);
+    }
+
+    for (int i = 0; i < KC_STATE_DIM; i++) {
+        for (int r = 0; r < size; r++) {
+            float sum = 0;
+            for (int k = 0; k < KC_STATE_DIM; k++) {
+                if (batch->H[r][k] != 0.0f) {
+                    sum += KHIP[i][k] * batch->H[r][k];
+                    COUNT_MULTIPLY_ACCUMULATES(1);
+                }
+            }
+            KHIPHT[i][r] = sum; // (KH - I)*P*H'
+        }
+    }
+
+    // (KH - I)*P*(KH - I)' + KRK' = ((KH - I)*P*H' + KR)*K' - (KH - I)*P, which is symmetric
+    for (int i = 0; i < KC_STATE_DIM; i++) {
+        for (int j = i; j < KC_STATE_DIM; j++) {
+            float sum = -KHIP[i][j];
+            for (int r = 0; r < size; r++) {
+                sum += (KHIPHT[i][r] + K[i][r] * batch->variance[r]) * K[j][r];
+            }
+            COUNT_MULTIPLY_ACCUMULATES(2 * size);
+            this->P[i][j] = this->P[j][i] = sum;
+        }
+    }
+    boundCovariance(this);
+
+    assertStateNotNaN(this);
+}
+
+// The measurement is linearized at the state before the batch, so a full batch is applied before the next measurement is linearized
+static void addToBatch(kalmanCoreData_t* this, const float h[KC_STATE_DIM], float error, float variance) {
+    kalmanCoreMeasurementBatch_t* batch = &this->batch;
+    memcpy(batch->H[batch->size], h, sizeof(batch->H[batch->size]));
+    batch->error[batch->size] = error;
+    batch->variance[batch->size] = variance;
+    batch->size++;
+
+    if (batch->size == KC_MAX_BATCH_SIZE) {
+        applyBatch(this);
+    }
+}
+
+void kalmanCoreBeginBatchUpdate(kalmanCoreData_t* this) {
+    this->batch.isCollecting = true;
+    this->batch.size = 0;
+}
+
+void kalmanCoreEndBatchUpdate(kalmanCoreData_t* this) {
+    this->batch.isCollecting = false;
+    applyBatch(this);
+}
+
 static void scalarUpdate(kalmanCoreData_t* this, arm_matrix_instance_f32* Hm, float error, float stdMeasNoise) {
     // The Kalman gain as a column vector
     NO_DMA_CCM_SAFE_ZERO_INIT static float K[KC_STATE_DIM];
@@ -228,15 +531,35 @@ static void scalarUpdate(kalmanCoreData_t* this, arm_matrix_instance_f32* Hm, fl
     ASSERT(Hm->numRows == 1);
     ASSERT(Hm->numCols == KC_STATE_DIM);
 
+    if (this->batch.isCollecting) {
+        addToBatch(this, Hm->pData, error, stdMeasNoise * stdMeasNoise);
+        return;
+    }
+
     // ====== INNOVATION COVARIANCE ======
 
-    mat_trans(Hm, &HTm);
-    mat_mult(&this->Pm, &HTm, &PHTm); // PH'
+    if (isCovarianceUpdateSparse) {
+        for (int i = 0; i < KC_STATE_DIM; i++) { // PH'
+            float sum = 0;
+            for (int k = 0; k < KC_STATE_DIM; k++) {
+                if (Hm->pData[k] != 0.0f) {
+                    sum += this->P[i][k] * Hm->pData[k];
+                    COUNT_MULTIPLY_ACCUMULATES(1);
+                }
+            }
+            PHTd[i] = sum;
+        }
+    } else {
+        mat_trans(Hm, &HTm);
+        mat_mult(&this->Pm, &HTm, &PHTm); // PH'
+        COUNT_MULTIPLY_ACCUMULATES(KC_STATE_DIM * KC_STATE_DIM);
+    }
     float R = stdMeasNoise * stdMeasNoise;
     float HPHR = R; // HPH' + R
     for (int i = 0; i < KC_STATE_DIM; i++) { // Add the element of HPH' to the above
         HPHR += Hm->pData[i] * PHTd[i]; // this obviously only works if the update is scalar (as in this function)
     }
+    COUNT_MULTIPLY_ACCUMULATES(KC_STATE_DIM);
     ASSERT(!isnan(HPHR));
 
     // ====== MEASUREMENT UPDATE ======
@@ -245,16 +568,22 @@ static void scalarUpdate(kalmanCoreData_t* this, arm_matrix_instance_f32* Hm, fl
         K[i] = PHTd[i] / HPHR; // kalman gain = (PH' (HPH' + R )^-1)
         this->S[i] = this->S[i] + K[i] * error; // state update
     }
+    COUNT_MULTIPLY_ACCUMULATES(KC_STATE_DIM);
     assertStateNotNaN(this);
 
     // ====== COVARIANCE UPDATE ======
-    mat_mult(&Km, Hm, &tmpNN1m); // KH
-    for (int i = 0; i < KC_STATE_DIM; i++) {
-        tmpNN1d[KC_STATE_DIM * i + i] -= 1;
-    } // KH - I
-    mat_trans(&tmpNN1m, &tmpNN2m); // (KH - I)'
-    mat_mult(&tmpNN1m, &this->Pm, &tmpNN3m); // (KH - I)*P
-    mat_mult(&tmpNN3m, &tmpNN2m, &this->Pm); // (KH - I)*P*(KH - I)'
+    if (isCovarianceUpdateSparse) {
+        josephCovarianceUpdateSparse(this, Hm->pData, K);
+    } else {
+        mat_mult(&Km, Hm, &tmpNN1m); // KH
+        for (int i = 0; i < KC_STATE_DIM; i++) {
+            tmpNN1d[KC_STATE_DIM * i + i] -= 1;
+        } // KH - I
+        mat_trans(&tmpNN1m, &tmpNN2m); // (KH - I)'
+        mat_mult(&tmpNN1m, &this->Pm, &tmpNN3m); // (KH - I)*P
+        mat_mult(&tmpNN3m, &tmpNN2m, &this->Pm); // (KH - I)*P*(KH - I)'
+        COUNT_MULTIPLY_ACCUMULATES(KC_STATE_DIM * KC_STATE_DIM + 2 * KC_STATE_DIM * KC_STATE_DIM * KC_STATE_DIM);
+    }
     assertStateNotNaN(this);
     // add the measurement variance and ensure boundedness and symmetry
     // TODO: Why would it hit these bounds? Needs to be investigated.
@@ -262,6 +591,7 @@ static void scalarUpdate(kalmanCoreData_t* this, arm_matrix_instance_f32* Hm, fl
         for (int j = i; j < KC_STATE_DIM; j++) {
             float v = K[i] * R * K[j];
             float p = 0.5f * this->P[i][j] + 0.5f * this->P[j][i] + v; // add measurement noise
+            COUNT_MULTIPLY_ACCUMULATES(2);
             if (isnan(p) || p > MAX_COVARIANCE) {
                 this->P[i][j] = this->P[j][i] = MAX_COVARIANCE;
             } else if (i == j && p < MIN_COVARIANCE) {
@@ -601,6 +931,54 @@ void kalmanCoreUpdateWithSweepAngles(kalmanCoreData_t* this, sweepAngleMeasureme
     }
 }
 
+// Lists the columns of a row of the linearized dynamics which can be nonzero, in increasing order
+static int getDynamicsColumns(int row, uint8_t columns[KC_STATE_DIM]) {
+    int count = 0;
+    int firstColumn = KC_STATE_PX;
+    if (row < KC_STATE_PX) {
+        columns[count++] = row; // The position rows are the identity on the position block
+    } else if (row >= KC_STATE_D0) {
+        firstColumn = KC_STATE_D0; // The attitude error rows are zero on the position and velocity blocks
+    }
+    for (int column = firstColumn; column < KC_STATE_DIM; column++) {
+        columns[count++] = column;
+    }
+    return count;
+}
+
+/**
+ * Computes A*P*A'. A is block upper triangular, so only the columns which can be nonzero are multiplied. They are added in
+ * increasing order like in the dense products.
+ */
+static void predictCovarianceSparse(kalmanCoreData_t* this, float A[KC_STATE_DIM][KC_STATE_DIM]) {
+    NO_DMA_CCM_SAFE_ZERO_INIT static float AP[KC_STATE_DIM][KC_STATE_DIM];
+
+    uint8_t columns[KC_STATE_DIM];
+    for (int i = 0; i < KC_STATE_DIM; i++) {
+        int columnCount = getDynamicsColumns(i, columns);
+        for (int j = 0; j < KC_STATE_DIM; j++) {
+            float sum = 0;
+            for (int c = 0; c < columnCount; c++) {
+                sum += A[i][columns[c]] * this->P[columns[c]][j];
+            }
+            AP[i][j] = sum; // A P
+        }
+        COUNT_MULTIPLY_ACCUMULATES(columnCount * KC_STATE_DIM);
+    }
+
+    for (int j = 0; j < KC_STATE_DIM; j++) {
+        int columnCount = getDynamicsColumns(j, columns);
+        for (int i = 0; i < KC_STATE_DIM; i++) {
+            float sum = 0;
+            for (int c = 0; c < columnCount; c++) {
+                sum += AP[i][columns[c]] * A[j][columns[c]];
+            }
+            this->P[i][j] = sum; // A P A'
+        }
+        COUNT_MULTIPLY_ACCUMULATES(columnCount * KC_STATE_DIM);
+    }
+}
+
 void kalmanCorePredict(kalmanCoreData_t* this, float cmdThrust, Axis3f* acc, Axis3f* gyro, float dt, bool quadIsFlying) {
     /* Here we discretize (euler forward) and linearise the quadrocopter dynamics in order
      * to push the covariance forward.
@@ -736,9 +1114,14 @@ void kalmanCorePredict(kalmanCoreData_t* this, float cmdThrust, Axis3f* acc, Axi
     A[KC_STATE_D2][KC_STATE_D2] = 1 - d0 * d0 / 2 - d1 * d1 / 2;
 
     // ====== COVARIANCE UPDATE ======
-    mat_mult(&Am, &this->Pm, &tmpNN1m); // A P
-    mat_trans(&Am, &tmpNN2m); // A'
-    mat_mult(&tmpNN1m, &tmpNN2m, &this->Pm); // A P A'
+    if (isCovarianceUpdateSparse) {
+        predictCovarianceSparse(this, A);
+    } else {
+        mat_mult(&Am, &this->Pm, &tmpNN1m); // A P
+        mat_trans(&Am, &tmpNN2m); // A'
+        mat_mult(&tmpNN1m, &tmpNN2m, &this->Pm); // A P A'
+        COUNT_MULTIPLY_ACCUMULATES(2 * KC_STATE_DIM * KC_STATE_DIM * KC_STATE_DIM);
+    }
     // Process noise is added after the return from the prediction step
 
     // ====== PREDICTION STEP ======
@@ -858,19 +1241,7 @@ void kalmanCoreAddProcessNoise(kalmanCoreData_t* this, float dt) {
         this->P[KC_STATE_D2][KC_STATE_D2] += powf(measNoiseGyro_yaw * dt + procNoiseAtt, 2);
     }
 
-    for (int i = 0; i < KC_STATE_DIM; i++) {
-        for (int j = i; j < KC_STATE_DIM; j++) {
-            float p = 0.5f * this->P[i][j] + 0.5f * this->P[j][i];
-            if (isnan(p) || p > MAX_COVARIANCE) {
-                this->P[i][j] = this->P[j][i] = MAX_COVARIANCE;
-            } else if (i == j && p < MIN_COVARIANCE) {
-                this->P[i][j] = this->P[j][i] = MIN_COVARIANCE;
-            } else {
-                this->P[i][j] = this->P[j][i] = p;
-            }
-        }
-    }
-
+    boundCovariance(this);
     assertStateNotNaN(this);
 }
 
@@ -970,18 +1341,7 @@ void kalmanCoreFinalize(kalmanCoreData_t* this, uint32_t tick) {
     this->S[KC_STATE_D2] = 0;
 
     // enforce symmetry of the covariance matrix, and ensure the values stay bounded
-    for (int i = 0; i < KC_STATE_DIM; i++) {
-        for (int j = i; j < KC_STATE_DIM; j++) {
-            float p = 0.5f * this->P[i][j] + 0.5f * this->P[j][i];
-            if (isnan(p) || p > MAX_COVARIANCE) {
-                this->P[i][j] = this->P[j][i] = MAX_COVARIANCE;
-            } else if (i == j && p < MIN_COVARIANCE) {
-                this->P[i][j] = this->P[j][i] = MIN_COVARIANCE;
-            } else {
-                this->P[i][j] = this->P[j][i] = p;
-            }
-        }
-    }
+    boundCovariance(this);
 
     assertStateNotNaN(this);
 }
@@ -1070,4 +1430,5 @@ PARAM_ADD(PARAM_FLOAT, initialX, &initialX)
 PARAM_ADD(PARAM_FLOAT, initialY, &initialY)
 PARAM_ADD(PARAM_FLOAT, initialZ, &initialZ)
 PARAM_ADD(PARAM_FLOAT, initialYaw, &initialYaw)
+PARAM_ADD(PARAM_UINT8, sparseCov, &isCovarianceUpdateSparse)
 PARAM_GROUP_STOP(kalman)
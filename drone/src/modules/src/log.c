@@ -49,6 +49,7 @@
 #include "cfassert.h"
 #include "debug.h"
 #include "static_mem.h"
+#include "toc_index.h"
 
 #if 0
 #define LOG_DEBUG(fmt, ...) DEBUG_PRINT("D/log " fmt, ##__VA_ARGS__)
@@ -152,6 +153,13 @@ static uint16_t logsCount = 0;
 
 static CRTPPacket p;
 
+// Constant time lookup of the variables by id and by name, the bucket count must be a power of two
+#define LOG_INDEX_BUCKET_COUNT 1024
+#define LOG_INDEX_MAX_VARIABLES 768
+NO_DMA_CCM_SAFE_ZERO_INIT static uint16_t logIndexBuckets[LOG_INDEX_BUCKET_COUNT];
+NO_DMA_CCM_SAFE_ZERO_INIT static uint16_t logIndexEntries[LOG_INDEX_MAX_VARIABLES];
+static tocIndex_t logIndex;
+
 static bool isInit = false;
 
 /* Log management functions */
@@ -207,9 +215,19 @@ void logInit(void) {
     // Big lock that protects the log datastructures
     logLock = xSemaphoreCreateMutexStatic(&logLockBuffer);
 
+    tocIndexInit(&logIndex, logIndexBuckets, LOG_INDEX_BUCKET_COUNT, logIndexEntries, LOG_INDEX_MAX_VARIABLES);
+    group = "";
     for (i = 0; i < logsLen; i++) {
-        if (!(logs[i].type & LOG_GROUP))
+        if (logs[i].type & LOG_GROUP) {
+            if (logs[i].type & LOG_START)
+                group = logs[i].name;
+        } else {
+            if (!tocIndexAddVariable(&logIndex, group, logs[i].name, i)) {
+                LOG_ERROR("Too many log variables, increase LOG_INDEX_MAX_VARIABLES\n");
+                ASSERT_FAILED();
+            }
             logsCount++;
+        }
     }
 
     // Manually free all log blocks
@@ -821,21 +839,21 @@ void logRunBlock(void* arg) {
 }
 
 static int variableGetIndex(int id) {
-    int i;
-    int n = 0;
+    return tocIndexGetEntryIndex(&logIndex, id);
+}
 
-    for (i = 0; i < logsLen; i++) {
-        if (!(logs[i].type & LOG_GROUP)) {
-            if (n == id)
-                break;
-            n++;
-        }
+// The group of an entry starts at the closest group start before it
+static char* getGroupName(int index) {
+    for (int i = index; i >= 0; i--) {
+        if ((logs[i].type & LOG_GROUP) && (logs[i].type & LOG_START))
+            return logs[i].name;
     }
 
-    if (i >= logsLen)
-        return -1;
+    return "";
+}
 
-    return i;
+static bool variableMatches(uint16_t index, const char* group, const char* name) {
+    return !strcmp(name, logs[index].name) && !strcmp(group, getGroupName(index));
 }
 
 static struct log_ops* opsMalloc() {
@@ -905,22 +923,11 @@ static void logReset(void) {
 static logVarId_t invalidVarId = 0xffffu;
 
 logVarId_t logGetVarId(char* group, char* name) {
-    int i;
-    logVarId_t varId = invalidVarId;
-    char* currgroup = "";
+    int id = tocIndexFind(&logIndex, group, name, variableMatches);
+    if (id < 0)
+        return invalidVarId;
 
-    for (i = 0; i < logsLen; i++) {
-        if (logs[i].type & LOG_GROUP) {
-            if (logs[i].type & LOG_START)
-                currgroup = logs[i].name;
-        }
-        if ((!strcmp(group, currgroup)) && (!strcmp(name, logs[i].name))) {
-            varId = (logVarId_t)i;
-            return varId;
-        }
-    }
-
-    return invalidVarId;
+    return (logVarId_t)variableGetIndex(id);
 }
 
 int logGetType(logVarId_t varid) {
@@ -928,22 +935,12 @@ int logGetType(logVarId_t varid) {
 }
 
 void logGetGroupAndName(logVarId_t varid, char** group, char** name) {
-    char* currgroup = "";
     *group = 0;
     *name = 0;
 
-    for (int i = 0; i < logsLen; i++) {
-        if (logs[i].type & LOG_GROUP) {
-            if (logs[i].type & LOG_START) {
-                currgroup = logs[i].name;
-            }
-        }
-
-        if (i == varid) {
-            *group = currgroup;
-            *name = logs[i].name;
-            break;
-        }
+    if (varid < logsLen) {
+        *group = getGroupName(varid);
+        *name = logs[varid].name;
     }
 }
 
@@ -0,0 +1,329 @@
+/* occupancy_grid.c: On-board occupancy grid built from the multiranger's horizontal sensors */
+
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+#include "log.h"
+#include "physicalConstants.h"
+#include "static_mem.h"
+#include "occupancy_grid.h"
+
+// Log-odds are stored as 4-bit signed integers, so that zero-initialized memory is an unknown grid
+static const int8_t MIN_LOG_ODDS = -8;
+static const int8_t MAX_LOG_ODDS = 7;
+// A hit is stronger evidence than a miss since a reading only hits one cell but crosses many
+static const int8_t HIT_LOG_ODDS = 2;
+static const int8_t MISS_LOG_ODDS = -1;
+static const int8_t OCCUPIED_LOG_ODDS = 2;
+static const int8_t FREE_LOG_ODDS = -1;
+
+// Readings above the threshold hit nothing, like the server's map generator
+static const uint16_t SENSOR_THRESHOLD = 2000;
+static const float MILLIMETER_TO_METER_FACTOR = 0.001f;
+static const float DEGREE_TO_RADIAN_FACTOR = M_PI_F / 180.0f;
+
+// Headings compared when looking for the least explored one, and how far each of them is looked at
+#define HEADING_COUNT 8
+static const uint8_t LOOKAHEAD_CELLS = 8;
+
+// Frontiers closer than this to a claimed frontier are left to the drone which claimed it
+static const float FRONTIER_CLAIM_RADIUS = 1.0f;
+// The breadth-first search only keeps its wavefront, which is much smaller than the grid, and stops growing it once the queue is full
+#define FRONTIER_QUEUE_SIZE 512
+static const int8_t ADJACENT_OFFSETS[][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+#define ADJACENT_CELL_COUNT (sizeof(ADJACENT_OFFSETS) / sizeof(ADJACENT_OFFSETS[0]))
+
+static bool isInit = false;
+static bool isEmpty = true;
+// Two cells per byte, the low nibble is the cell with the even column
+NO_DMA_CCM_SAFE_ZERO_INIT static uint8_t cells[OCCUPANCY_GRID_MEMORY_SIZE];
+// Frontier search state, static to keep it off the app task's small stack
+static uint8_t visitedCells[OCCUPANCY_GRID_SIDE * OCCUPANCY_GRID_SIDE / 8];
+static uint16_t frontierQueue[FRONTIER_QUEUE_SIZE];
+
+static bool isInside(int32_t column, int32_t row) {
+    return column >= 0 && row >= 0 && column < OCCUPANCY_GRID_SIDE && row < OCCUPANCY_GRID_SIDE;
+}
+
+static int32_t toCellCoordinate(float coordinate) {
+    return (int32_t)floorf(coordinate / OCCUPANCY_GRID_CELL_SIZE) + OCCUPANCY_GRID_SIDE / 2;
+}
+
+static int8_t getLogOdds(int32_t column, int32_t row) {
+    const uint8_t byte = cells[(row * OCCUPANCY_GRID_SIDE + column) / 2];
+    const uint8_t nibble = (column % 2 == 0) ? (byte & 0x0F) : (byte >> 4);
+    // Sign extend the nibble
+    return (int8_t)((nibble ^ 0x08) - 0x08);
+}
+
+static void setLogOdds(int32_t column, int32_t row, int8_t logOdds) {
+    uint8_t* byte = &cells[(row * OCCUPANCY_GRID_SIDE + column) / 2];
+    const uint8_t nibble = (uint8_t)logOdds & 0x0F;
+    if (column % 2 == 0) {
+        *byte = (*byte & 0xF0) | nibble;
+    } else {
+        *byte = (*byte & 0x0F) | (uint8_t)(nibble << 4);
+    }
+}
+
+static void updateCell(int32_t column, int32_t row, int8_t logOddsChange) {
+    if (!isInside(column, row)) {
+        return;
+    }
+
+    int8_t logOdds = getLogOdds(column, row) + logOddsChange;
+    if (logOdds < MIN_LOG_ODDS) {
+        logOdds = MIN_LOG_ODDS;
+    } else if (logOdds > MAX_LOG_ODDS) {
+        logOdds = MAX_LOG_ODDS;
+    }
+    setLogOdds(column, row, logOdds);
+}
+
+static occupancyGridCellState_t getCellState(int32_t column, int32_t row) {
+    if (!isInside(column, row)) {
+        return OCCUPANCY_GRID_UNKNOWN;
+    }
+
+    const int8_t logOdds = getLogOdds(column, row);
+    if (logOdds >= OCCUPIED_LOG_ODDS) {
+        return OCCUPANCY_GRID_OCCUPIED;
+    }
+    if (logOdds <= FREE_LOG_ODDS) {
+        return OCCUPANCY_GRID_FREE;
+    }
+    return OCCUPANCY_GRID_UNKNOWN;
+}
+
+// Visits every cell crossed by the ray exactly once by stepping to the nearest cell boundary on either axis (Amanatides and Woo)
+static void castRay(float originX, float originY, float angle, float distance, bool isObstacleHit) {
+    const float directionX = cosf(angle);
+    const float directionY = sinf(angle);
+    const float startX = originX / OCCUPANCY_GRID_CELL_SIZE + OCCUPANCY_GRID_SIDE / 2;
+    const float startY = originY / OCCUPANCY_GRID_CELL_SIZE + OCCUPANCY_GRID_SIDE / 2;
+    const float cellDistance = distance / OCCUPANCY_GRID_CELL_SIZE;
+
+    int32_t column = (int32_t)floorf(startX);
+    int32_t row = (int32_t)floorf(startY);
+    const int32_t endColumn = (int32_t)floorf(startX + directionX * cellDistance);
+    const int32_t endRow = (int32_t)floorf(startY + directionY * cellDistance);
+
+    const int32_t stepColumn = directionX >= 0.0f ? 1 : -1;
+    const int32_t stepRow = directionY >= 0.0f ? 1 : -1;
+    const float deltaX = directionX != 0.0f ? fabsf(1.0f / directionX) : INFINITY;
+    const float deltaY = directionY != 0.0f ? fabsf(1.0f / directionY) : INFINITY;
+    float nextX = directionX != 0.0f ? (directionX > 0.0f ? column + 1 - startX : startX - column) * deltaX : INFINITY;
+    float nextY = directionY != 0.0f ? (directionY > 0.0f ? row + 1 - startY : startY - row) * deltaY : INFINITY;
+
+    while (column != endColumn || row != endRow) {
+        updateCell(column, row, MISS_LOG_ODDS);
+
+        if (nextX < nextY) {
+            if (nextX > cellDistance) {
+                break;
+            }
+            column += stepColumn;
+            nextX += deltaX;
+        } else {
+            if (nextY > cellDistance) {
+                break;
+            }
+            row += stepRow;
+            nextY += deltaY;
+        }
+    }
+
+    updateCell(endColumn, endRow, isObstacleHit ? HIT_LOG_ODDS : MISS_LOG_ODDS);
+}
+
+void occupancyGridInit(void) {
+    if (isInit) {
+        return;
+    }
+
+    occupancyGridReset();
+    isInit = true;
+}
+
+bool occupancyGridTest(void) {
+    return isInit;
+}
+
+void occupancyGridReset(void) {
+    // Called every tick while the drone is in standby, so only clear the grid once
+    if (isEmpty) {
+        return;
+    }
+
+    memset(cells, 0, sizeof(cells));
+    isEmpty = true;
+}
+
+void occupancyGridAddRangeReadings(const point_t* position, float yaw, const uint16_t ranges[RANGE_T_END]) {
+    // Angle of each horizontal sensor relative to the drone's yaw
+    static const rangeDirection_t directions[] = {rangeFront, rangeLeft, rangeBack, rangeRight};
+    static const float angleOffsets[] = {0.0f, 90.0f, 180.0f, -90.0f};
+
+    for (uint8_t i = 0; i < sizeof(directions) / sizeof(directions[0]); i++) {
+        const uint16_t range = ranges[directions[i]];
+        // The sensors report 0 when a measurement failed
+        if (range == 0) {
+            continue;
+        }
+
+        const bool isObstacleHit = range < SENSOR_THRESHOLD;
+        const float distance = (isObstacleHit ? range : SENSOR_THRESHOLD) * MILLIMETER_TO_METER_FACTOR;
+        castRay(position->x, position->y, (yaw + angleOffsets[i]) * DEGREE_TO_RADIAN_FACTOR, distance, isObstacleHit);
+    }
+    isEmpty = false;
+}
+
+occupancyGridCellState_t occupancyGridGetCellState(float x, float y) {
+    return getCellState(toCellCoordinate(x), toCellCoordinate(y));
+}
+
+bool occupancyGridIsSegmentFree(const point_t* from, const point_t* to) {
+    // Sampling every quarter of a cell can only miss the corners of cells which the segment barely clips
+    static const float SAMPLE_SPACING = OCCUPANCY_GRID_CELL_SIZE / 4.0f;
+    const float deltaX = to->x - from->x;
+    const float deltaY = to->y - from->y;
+    const uint16_t sampleCount = (uint16_t)ceilf(sqrtf(deltaX * deltaX + deltaY * deltaY) / SAMPLE_SPACING);
+
+    for (uint16_t i = 0; i <= sampleCount; i++) {
+        const float ratio = sampleCount > 0 ? (float)i / sampleCount : 0.0f;
+        if (occupancyGridGetCellState(from->x + deltaX * ratio, from->y + deltaY * ratio) != OCCUPANCY_GRID_FREE) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool occupancyGridFindLeastExploredHeading(const point_t* position, float* heading) {
+    const int32_t startColumn = toCellCoordinate(position->x);
+    const int32_t startRow = toCellCoordinate(position->y);
+
+    // Count the unknown cells along each heading until an obstacle, since the drone cannot explore past it
+    uint8_t unknownCellCounts[HEADING_COUNT];
+    for (uint8_t i = 0; i < HEADING_COUNT; i++) {
+        const float angle = i * 2.0f * M_PI_F / HEADING_COUNT;
+        const float directionX = cosf(angle);
+        const float directionY = sinf(angle);
+
+        unknownCellCounts[i] = 0;
+        for (uint8_t distance = 1; distance <= LOOKAHEAD_CELLS; distance++) {
+            const int32_t column = startColumn + (int32_t)roundf(directionX * distance);
+            const int32_t row = startRow + (int32_t)roundf(directionY * distance);
+            const occupancyGridCellState_t state = getCellState(column, row);
+            if (state == OCCUPANCY_GRID_OCCUPIED) {
+                break;
+            }
+            if (state == OCCUPANCY_GRID_UNKNOWN) {
+                unknownCellCounts[i]++;
+            }
+        }
+    }
+
+    uint8_t bestIndex = 0;
+    bool isAnyHeadingBetter = false;
+    for (uint8_t i = 1; i < HEADING_COUNT; i++) {
+        if (unknownCellCounts[i] != unknownCellCounts[bestIndex]) {
+            isAnyHeadingBetter = true;
+        }
+        if (unknownCellCounts[i] > unknownCellCounts[bestIndex]) {
+            bestIndex = i;
+        }
+    }
+
+    *heading = bestIndex * 360.0f / HEADING_COUNT;
+    if (*heading >= 180.0f) {
+        *heading -= 360.0f;
+    }
+    return isAnyHeadingBetter;
+}
+
+static bool isUnknownCellAdjacent(int32_t column, int32_t row) {
+    for (uint8_t i = 0; i < ADJACENT_CELL_COUNT; i++) {
+        const int32_t adjacentColumn = column + ADJACENT_OFFSETS[i][0];
+        const int32_t adjacentRow = row + ADJACENT_OFFSETS[i][1];
+        // The drone cannot explore past the grid's edges
+        if (isInside(adjacentColumn, adjacentRow) && getCellState(adjacentColumn, adjacentRow) == OCCUPANCY_GRID_UNKNOWN) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool isFrontierClaimed(float x, float y, const point_t claimedFrontiers[], uint8_t claimedFrontierCount) {
+    for (uint8_t i = 0; i < claimedFrontierCount; i++) {
+        const float deltaX = claimedFrontiers[i].x - x;
+        const float deltaY = claimedFrontiers[i].y - y;
+        if (deltaX * deltaX + deltaY * deltaY < FRONTIER_CLAIM_RADIUS * FRONTIER_CLAIM_RADIUS) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool occupancyGridFindNearestFrontier(const point_t* position, const point_t claimedFrontiers[], uint8_t claimedFrontierCount,
+                                      occupancyGridFrontierFilter_t isFrontierExplored, point_t* frontier) {
+    const int32_t startColumn = toCellCoordinate(position->x);
+    const int32_t startRow = toCellCoordinate(position->y);
+    if (!isInside(startColumn, startRow)) {
+        return false;
+    }
+
+    const uint16_t startIndex = (uint16_t)(startRow * OCCUPANCY_GRID_SIDE + startColumn);
+    memset(visitedCells, 0, sizeof(visitedCells));
+    visitedCells[startIndex / 8] |= 1 << (startIndex % 8);
+    frontierQueue[0] = startIndex;
+    uint16_t queueStart = 0;
+    uint16_t queueCount = 1;
+
+    while (queueCount > 0) {
+        const uint16_t index = frontierQueue[queueStart];
+        queueStart = (queueStart + 1) % FRONTIER_QUEUE_SIZE;
+        queueCount--;
+
+        const int32_t column = index % OCCUPANCY_GRID_SIDE;
+        const int32_t row = index / OCCUPANCY_GRID_SIDE;
+        const float x = (column - OCCUPANCY_GRID_SIDE / 2 + 0.5f) * OCCUPANCY_GRID_CELL_SIZE;
+        const float y = (row - OCCUPANCY_GRID_SIDE / 2 + 0.5f) * OCCUPANCY_GRID_CELL_SIZE;
+        // The drone's own cell is expanded even if it was never observed, but is not a frontier
+        if (index != startIndex || getCellState(column, row) == OCCUPANCY_GRID_FREE) {
+            if (isUnknownCellAdjacent(column, row) && !isFrontierClaimed(x, y, claimedFrontiers, claimedFrontierCount) &&
+                (isFrontierExplored == NULL || !isFrontierExplored(x, y))) {
+                frontier->x = x;
+                frontier->y = y;
+                frontier->z = position->z;
+                return true;
+            }
+        }
+
+        for (uint8_t i = 0; i < ADJACENT_CELL_COUNT; i++) {
+            const int32_t adjacentColumn = column + ADJACENT_OFFSETS[i][0];
+            const int32_t adjacentRow = row + ADJACENT_OFFSETS[i][1];
+            if (!isInside(adjacentColumn, adjacentRow) || getCellState(adjacentColumn, adjacentRow) != OCCUPANCY_GRID_FREE) {
+                continue;
+            }
+
+            const uint16_t adjacentIndex = (uint16_t)(adjacentRow * OCCUPANCY_GRID_SIDE + adjacentColumn);
+            if ((visitedCells[adjacentIndex / 8] & (1 << (adjacentIndex % 8))) || queueCount == FRONTIER_QUEUE_SIZE) {
+                continue;
+            }
+            visitedCells[adjacentIndex / 8] |= 1 << (adjacentIndex % 8);
+            frontierQueue[(queueStart + queueCount) % FRONTIER_QUEUE_SIZE] = adjacentIndex;
+            queueCount++;
+        }
+    }
+
+    return false;
+}
+
+#ifndef UNIT_TEST_MODE
+// Reported so that the footprint can be checked against the memory left, which the linker only reports at build time
+static uint16_t memorySize = sizeof(cells) + sizeof(visitedCells) + sizeof(frontierQueue);
+#endif
+
+LOG_GROUP_START(occGrid)
+LOG_ADD(LOG_UINT16, memorySize, &memorySize)
+LOG_GROUP_STOP(occGrid)
@@ -37,6 +37,7 @@
 #include "console.h"
 #include "debug.h"
 #include "static_mem.h"
+#include "toc_index.h"
 
 #if 0
 #define PARAM_DEBUG(fmt, ...) DEBUG_PRINT("D/param " fmt, ##__VA_ARGS__)
@@ -85,6 +86,7 @@ extern struct param_s _param_stop;
 static void paramWriteProcess();
 static void paramReadProcess();
 static int variableGetIndex(int id);
+static bool variableMatches(uint16_t index, const char* group, const char* name);
 static char paramWriteByNameProcess(char* group, char* name, int type, void* valptr);
 
 // Pointer to the parameters list and length of it
@@ -98,6 +100,13 @@ static bool useV2 = false;
 
 static CRTPPacket p;
 
+// Constant time lookup of the variables by id and by name, the bucket count must be a power of two
+#define PARAM_INDEX_BUCKET_COUNT 512
+#define PARAM_INDEX_MAX_VARIABLES 384
+NO_DMA_CCM_SAFE_ZERO_INIT static uint16_t paramIndexBuckets[PARAM_INDEX_BUCKET_COUNT];
+NO_DMA_CCM_SAFE_ZERO_INIT static uint16_t paramIndexEntries[PARAM_INDEX_MAX_VARIABLES];
+static tocIndex_t paramIndex;
+
 static bool isInit = false;
 
 STATIC_MEM_TASK_ALLOC_STACK_NO_DMA_CCM_SAFE(paramTask, PARAM_TASK_STACKSIZE);
@@ -140,9 +149,19 @@ void paramInit(void) {
         paramsCrc = crcSlow(p.data, len);
     }
 
+    tocIndexInit(&paramIndex, paramIndexBuckets, PARAM_INDEX_BUCKET_COUNT, paramIndexEntries, PARAM_INDEX_MAX_VARIABLES);
+    group = "";
     for (i = 0; i < paramsLen; i++) {
-        if (!(params[i].type & PARAM_GROUP))
+        if (params[i].type & PARAM_GROUP) {
+            if (params[i].type & PARAM_START)
+                group = params[i].name;
+        } else {
+            if (!tocIndexAddVariable(&paramIndex, group, params[i].name, i)) {
+                PARAM_ERROR("Too many parameters, increase PARAM_INDEX_MAX_VARIABLES\n");
+                ASSERT_FAILED();
+            }
             paramsCount++;
+        }
     }
 
     // Start the param task
@@ -383,24 +402,9 @@ static void paramWriteProcess() {
 }
 
 static char paramWriteByNameProcess(char* group, char* name, int type, void* valptr) {
-    int ptr;
-    char* pgroup = "";
-
-    for (ptr = 0; ptr < paramsLen; ptr++) // Ptr points a group
-    {
-        if (params[ptr].type & PARAM_GROUP) {
-            if (params[ptr].type & PARAM_START)
-                pgroup = params[ptr].name;
-            else
-                pgroup = "";
-        } else // Ptr points a variable
-        {
-            if (!strcmp(params[ptr].name, name) && !strcmp(pgroup, group))
-                break;
-        }
-    }
+    int ptr = variableGetIndex(tocIndexFind(&paramIndex, group, name, variableMatches));
 
-    if (ptr >= paramsLen) {
+    if (ptr < 0) {
         return ENOENT;
     }
 
@@ -503,49 +507,36 @@ static void paramReadProcess() {
 }
 
 static int variableGetIndex(int id) {
-    int i;
-    int n = 0;
+    return tocIndexGetEntryIndex(&paramIndex, id);
+}
 
-    for (i = 0; i < paramsLen; i++) {
-        if (!(params[i].type & PARAM_GROUP)) {
-            if (n == id)
-                break;
-            n++;
-        }
+// The group of an entry starts at the closest group start before it
+static char* getGroupName(int index) {
+    for (int i = index; i >= 0; i--) {
+        if ((params[i].type & PARAM_GROUP) && (params[i].type & PARAM_START))
+            return params[i].name;
     }
 
-    if (i >= paramsLen)
-        return -1;
+    return "";
+}
 
-    return i;
+static bool variableMatches(uint16_t index, const char* group, const char* name) {
+    return !strcmp(name, params[index].name) && !strcmp(group, getGroupName(index));
 }
 
 /* Public API to access param TOC from within the copter */
 static paramVarId_t invalidVarId = {0xffffu, 0xffffu};
 
 paramVarId_t paramGetVarId(char* group, char* name) {
-    int ptr;
-    int id = 0;
     paramVarId_t varId = invalidVarId;
-    char* currgroup = "";
 
-    for (ptr = 0; ptr < paramsLen; ptr++) {
-        if (params[ptr].type & PARAM_GROUP) {
-            if (params[ptr].type & PARAM_START) {
-                currgroup = params[ptr].name;
-            }
-        } else {
-            id += 1;
-        }
-
-        if ((!strcmp(group, currgroup)) && (!strcmp(name, params[ptr].name))) {
-            varId.ptr = ptr;
-            varId.id = id - 1;
-            return varId;
-        }
+    int id = tocIndexFind(&paramIndex, group, name, variableMatches);
+    if (id >= 0) {
+        varId.ptr = variableGetIndex(id);
+        varId.id = id;
     }
 
-    return invalidVarId;
+    return varId;
 }
 
 int paramGetType(paramVarId_t varid) {
@@ -553,22 +544,12 @@ int paramGetType(paramVarId_t varid) {
 }
 
 void paramGetGroupAndName(paramVarId_t varid, char** group, char** name) {
-    char* currgroup = "";
     *group = 0;
     *name = 0;
 
-    for (int i = 0; i < paramsLen; i++) {
-        if (params[i].type & PARAM_GROUP) {
-            if (params[i].type & PARAM_START) {
-                currgroup = params[i].name;
-            }
-        }
-
-        if (i == varid.ptr) {
-            *group = currgroup;
-            *name = params[i].name;
-            break;
-        }
+    if (varid.ptr < paramsLen) {
+        *group = getGroupName(varid.ptr);
+        *name = params[varid.ptr].name;
     }
 }
 
@@ -29,6 +29,7 @@
 #include "log.h"
 
 #include "range.h"
+#include "sensor_snapshot.h"
 #include "stabilizer_types.h"
 #include "estimator.h"
 
@@ -41,6 +42,7 @@ void rangeSet(rangeDirection_t direction, float range_m) {
         return;
 
     ranges[direction] = range_m * 1000;
+    sensorSnapshotSetRange(direction, ranges[direction]);
 }
 
 float rangeGet(rangeDirection_t direction) {
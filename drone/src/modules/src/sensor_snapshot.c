@@ -0,0 +1,71 @@
+/* sensor_snapshot.c: Consistent snapshot of the data used by the app layer */
+
+#include <string.h>
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include "task.h"
+#include "pm.h"
+#include "sensor_snapshot.h"
+
+static bool isInit = false;
+static sensorSnapshot_t latestSnapshot;
+
+// Only locked to copy the snapshot, so the stabilizer is never blocked for long by lower priority tasks
+static SemaphoreHandle_t snapshotMutex;
+static StaticSemaphore_t snapshotMutexBuffer;
+
+void sensorSnapshotInit(void) {
+    if (isInit) {
+        return;
+    }
+
+    memset(&latestSnapshot, 0, sizeof(latestSnapshot));
+    snapshotMutex = xSemaphoreCreateMutexStatic(&snapshotMutexBuffer);
+    isInit = true;
+}
+
+bool sensorSnapshotTest(void) {
+    return isInit;
+}
+
+void sensorSnapshotSetState(const state_t* state) {
+    if (!isInit) {
+        return;
+    }
+
+    xSemaphoreTake(snapshotMutex, portMAX_DELAY);
+    latestSnapshot.attitude = state->attitude;
+    latestSnapshot.position = state->position;
+    latestSnapshot.velocity = state->velocity;
+    xSemaphoreGive(snapshotMutex);
+}
+
+void sensorSnapshotSetRange(rangeDirection_t direction, uint16_t range) {
+    if (!isInit || direction >= RANGE_T_END) {
+        return;
+    }
+
+    xSemaphoreTake(snapshotMutex, portMAX_DELAY);
+    latestSnapshot.ranges[direction] = range;
+    latestSnapshot.rangesTimestamp = xTaskGetTickCount();
+    xSemaphoreGive(snapshotMutex);
+}
+
+void sensorSnapshotSetRssi(uint8_t rssi) {
+    if (!isInit) {
+        return;
+    }
+
+    xSemaphoreTake(snapshotMutex, portMAX_DELAY);
+    latestSnapshot.rssi = rssi;
+    xSemaphoreGive(snapshotMutex);
+}
+
+void sensorSnapshotGet(sensorSnapshot_t* snapshot) {
+    xSemaphoreTake(snapshotMutex, portMAX_DELAY);
+    memcpy(snapshot, &latestSnapshot, sizeof(sensorSnapshot_t));
+    xSemaphoreGive(snapshotMutex);
+
+    // The power management module already keeps the latest filtered voltage
+    snapshot->batteryVoltage = pmGetBatteryVoltage();
+}
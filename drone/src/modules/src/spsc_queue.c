@@ -0,0 +1,76 @@
+/* spsc_queue.c: Lock-free single-producer single-consumer ring buffer */
+#include "spsc_queue.h"
+
+#include <string.h>
+#include "cfassert.h"
+
+// The indices are loaded with acquire and stored with release semantics, so that the items they cover are visible to the other
+// side before the indices are. On the Cortex-M4 this compiles to plain loads and stores with memory barriers.
+static inline uint32_t loadIndex(const volatile uint32_t* index) {
+    return __atomic_load_n(index, __ATOMIC_ACQUIRE);
+}
+
+static inline void storeIndex(volatile uint32_t* index, uint32_t value) {
+    __atomic_store_n(index, value, __ATOMIC_RELEASE);
+}
+
+static inline uint8_t* getSlot(const spscQueue_t* queue, uint32_t index) {
+    return &queue->buffer[(index & (queue->capacity - 1)) * queue->itemSize];
+}
+
+void spscQueueInit(spscQueue_t* queue, void* buffer, uint32_t itemSize, uint32_t capacity) {
+    ASSERT(capacity > 0 && (capacity & (capacity - 1)) == 0);
+
+    queue->buffer = buffer;
+    queue->itemSize = itemSize;
+    queue->capacity = capacity;
+    queue->writeIndex = 0;
+    queue->overrunCount = 0;
+    queue->readIndex = 0;
+}
+
+bool spscQueuePush(spscQueue_t* queue, const void* item) {
+    // The producer owns the write index, only the read index can change under its feet
+    const uint32_t writeIndex = queue->writeIndex;
+    if (writeIndex - loadIndex(&queue->readIndex) >= queue->capacity) {
+        queue->overrunCount++;
+        return false;
+    }
+
+    memcpy(getSlot(queue, writeIndex), item, queue->itemSize);
+    storeIndex(&queue->writeIndex, writeIndex + 1);
+
+    return true;
+}
+
+uint32_t spscQueueGetPendingCount(spscQueue_t* queue) {
+    return loadIndex(&queue->writeIndex) - queue->readIndex;
+}
+
+void* spscQueueGetPending(const spscQueue_t* queue, uint32_t index) {
+    return getSlot(queue, queue->readIndex + index);
+}
+
+void spscQueueRelease(spscQueue_t* queue, uint32_t count) {
+    storeIndex(&queue->readIndex, queue->readIndex + count);
+}
+
+bool spscQueuePop(spscQueue_t* queue, void* item) {
+    if (spscQueueGetPendingCount(queue) == 0) {
+        return false;
+    }
+
+    memcpy(item, spscQueueGetPending(queue, 0), queue->itemSize);
+    spscQueueRelease(queue, 1);
+
+    return true;
+}
+
+void spscQueueReset(spscQueue_t* queue) {
+    // Releasing up to the write index keeps the producer's view consistent, it may be pushing at the same time
+    storeIndex(&queue->readIndex, loadIndex(&queue->writeIndex));
+}
+
+uint32_t spscQueueGetOverrunCount(const spscQueue_t* queue) {
+    return queue->overrunCount;
+}
@@ -53,6 +53,9 @@
 #include "statsCnt.h"
 #include "static_mem.h"
 #include "rateSupervisor.h"
+#include "app.h"
+#include "sensor_snapshot.h"
+#include "stage_timing.h"
 
 static bool isInit;
 static bool emergencyStop = false;
@@ -188,6 +191,7 @@ void stabilizerInit(StateEstimatorType estimator) {
     powerDistributionInit();
     sitAwInit();
     collisionAvoidanceInit();
+    stageTimingInit(configCPU_CLOCK_HZ / 1000000);
     estimatorType = getStateEstimator();
     controllerType = getControllerType();
 
@@ -204,6 +208,7 @@ bool stabilizerTest(void) {
     pass &= controllerTest();
     pass &= powerDistributionTest();
     pass &= collisionAvoidanceTest();
+    pass &= stageTimingTest();
 
     return pass;
 }
@@ -270,25 +275,41 @@ static void stabilizerTask(void* param) {
                 controllerType = getControllerType();
             }
 
+            stageTimingStart(STAGE_TIMING_ESTIMATOR);
             stateEstimator(&state, &sensorData, &control, tick);
+            stageTimingStop(STAGE_TIMING_ESTIMATOR);
             compressState();
 
+            // Wake the app up at its own rate instead of letting it poll the state estimate
+            if (RATE_DO_EXECUTE(RATE_100_HZ, tick)) {
+                sensorSnapshotSetState(&state);
+                appNotify(APP_EVENT_STATE_UPDATED);
+            }
+
+            stageTimingStart(STAGE_TIMING_COMMANDER);
             commanderGetSetpoint(&setpoint, &state);
+            stageTimingStop(STAGE_TIMING_COMMANDER);
             compressSetpoint();
 
             sitAwUpdateSetpoint(&setpoint, &sensorData, &state);
+            stageTimingStart(STAGE_TIMING_COLLISION_AVOIDANCE);
             collisionAvoidanceUpdateSetpoint(&setpoint, &sensorData, &state, tick);
+            stageTimingStop(STAGE_TIMING_COLLISION_AVOIDANCE);
 
+            stageTimingStart(STAGE_TIMING_CONTROLLER);
             controller(&control, &setpoint, &sensorData, &state, tick);
+            stageTimingStop(STAGE_TIMING_CONTROLLER);
 
             checkEmergencyStopTimeout();
 
             checkStops = systemIsArmed();
+            stageTimingStart(STAGE_TIMING_POWER_DISTRIBUTION);
             if (emergencyStop || (systemIsArmed() == false)) {
                 powerStop();
             } else {
                 powerDistribution(&control);
             }
+            stageTimingStop(STAGE_TIMING_POWER_DISTRIBUTION);
 
             // Log data to uSD card if configured
             if (usddeckLoggingEnabled() && usddeckLoggingMode() == usddeckLoggingMode_SynchronousStabilizer &&
@@ -0,0 +1,163 @@
+/* stage_timing.c: Execution time of the stabilizer loop stages, measured with the cycle counter */
+
+#include <string.h>
+#include "log.h"
+#include "stage_timing.h"
+
+#ifndef UNIT_TEST_MODE
+#include "stm32f4xx.h"
+#endif
+
+typedef struct {
+    uint32_t startCycles;
+    uint16_t bins[STAGE_TIMING_BIN_COUNT];
+    uint16_t sampleCount;
+    uint32_t min;
+    uint32_t max;
+    uint32_t sum;
+} stageHistogram_t;
+
+static bool isInit = false;
+static uint32_t cyclesPerMicrosecond = 1;
+static stageHistogram_t histograms[STAGE_TIMING_STAGE_COUNT];
+static stageTimingStats_t stats[STAGE_TIMING_STAGE_COUNT];
+
+#ifdef UNIT_TEST_MODE
+static uint32_t hostCycles = 0;
+
+void stageTimingSetHostCycles(uint32_t cycles) {
+    hostCycles = cycles;
+}
+#endif
+
+static void clearHistogram(stageHistogram_t* histogram) {
+    memset(histogram->bins, 0, sizeof(histogram->bins));
+    histogram->sampleCount = 0;
+    histogram->min = UINT32_MAX;
+    histogram->max = 0;
+    histogram->sum = 0;
+}
+
+static uint16_t clampToUint16(uint32_t value) {
+    return value > UINT16_MAX ? UINT16_MAX : value;
+}
+
+static void publishStats(const stageHistogram_t* histogram, stageTimingStats_t* stageStats) {
+    stageStats->min = clampToUint16(histogram->min);
+    stageStats->max = clampToUint16(histogram->max);
+    stageStats->average = (float)histogram->sum / histogram->sampleCount;
+
+    // The smallest bin below which at least 99 % of the samples fall
+    const uint32_t rank = (histogram->sampleCount * 99 + 99) / 100;
+    uint32_t cumulatedCount = 0;
+    int bin = 0;
+    for (; bin < STAGE_TIMING_BIN_COUNT - 1; bin++) {
+        cumulatedCount += histogram->bins[bin];
+        if (cumulatedCount >= rank) {
+            break;
+        }
+    }
+
+    const uint32_t binUpperEdge = (bin + 1) * STAGE_TIMING_BIN_WIDTH;
+    stageStats->p99 = bin < STAGE_TIMING_BIN_COUNT - 1 && binUpperEdge < histogram->max ? binUpperEdge : stageStats->max;
+}
+
+void stageTimingInit(uint32_t clockFrequency) {
+    if (isInit) {
+        return;
+    }
+
+    cyclesPerMicrosecond = clockFrequency;
+    stageTimingReset();
+
+#ifndef UNIT_TEST_MODE
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+
+    isInit = true;
+}
+
+bool stageTimingTest(void) {
+    return isInit;
+}
+
+void stageTimingReset(void) {
+    for (int stage = 0; stage < STAGE_TIMING_STAGE_COUNT; stage++) {
+        clearHistogram(&histograms[stage]);
+    }
+    memset(stats, 0, sizeof(stats));
+}
+
+uint32_t stageTimingGetCycles(void) {
+#ifdef UNIT_TEST_MODE
+    return hostCycles;
+#else
+    return DWT->CYCCNT;
+#endif
+}
+
+void stageTimingStart(stageTimingStage_t stage) {
+    histograms[stage].startCycles = stageTimingGetCycles();
+}
+
+void stageTimingStop(stageTimingStage_t stage) {
+    // The unsigned difference is right across a wrap around of the counter
+    stageTimingAddSample(stage, stageTimingGetCycles() - histograms[stage].startCycles);
+}
+
+void stageTimingAddSample(stageTimingStage_t stage, uint32_t cycles) {
+    stageHistogram_t* histogram = &histograms[stage];
+    const uint32_t duration = cycles / cyclesPerMicrosecond;
+
+    uint32_t bin = duration / STAGE_TIMING_BIN_WIDTH;
+    if (bin >= STAGE_TIMING_BIN_COUNT) {
+        bin = STAGE_TIMING_BIN_COUNT - 1;
+    }
+    histogram->bins[bin]++;
+
+    if (duration < histogram->min) {
+        histogram->min = duration;
+    }
+    if (duration > histogram->max) {
+        histogram->max = duration;
+    }
+    histogram->sum += duration;
+    histogram->sampleCount++;
+
+    if (histogram->sampleCount >= STAGE_TIMING_WINDOW) {
+        publishStats(histogram, &stats[stage]);
+        clearHistogram(histogram);
+    }
+}
+
+const stageTimingStats_t* stageTimingGetStats(stageTimingStage_t stage) {
+    return &stats[stage];
+}
+
+/**
+ * Execution time of the stabilizer loop stages over the last 1000 loops (us)
+ */
+LOG_GROUP_START(stabTiming)
+LOG_ADD(LOG_UINT16, estMin, &stats[STAGE_TIMING_ESTIMATOR].min)
+LOG_ADD(LOG_FLOAT, estAvg, &stats[STAGE_TIMING_ESTIMATOR].average)
+LOG_ADD(LOG_UINT16, estMax, &stats[STAGE_TIMING_ESTIMATOR].max)
+LOG_ADD(LOG_UINT16, estP99, &stats[STAGE_TIMING_ESTIMATOR].p99)
+LOG_ADD(LOG_UINT16, cmdMin, &stats[STAGE_TIMING_COMMANDER].min)
+LOG_ADD(LOG_FLOAT, cmdAvg, &stats[STAGE_TIMING_COMMANDER].average)
+LOG_ADD(LOG_UINT16, cmdMax, &stats[STAGE_TIMING_COMMANDER].max)
+LOG_ADD(LOG_UINT16, cmdP99, &stats[STAGE_TIMING_COMMANDER].p99)
+LOG_ADD(LOG_UINT16, colMin, &stats[STAGE_TIMING_COLLISION_AVOIDANCE].min)
+LOG_ADD(LOG_FLOAT, colAvg, &stats[STAGE_TIMING_COLLISION_AVOIDANCE].average)
+LOG_ADD(LOG_UINT16, colMax, &stats[STAGE_TIMING_COLLISION_AVOIDANCE].max)
+LOG_ADD(LOG_UINT16, colP99, &stats[STAGE_TIMING_COLLISION_AVOIDANCE].p99)
+LOG_ADD(LOG_UINT16, ctrlMin, &stats[STAGE_TIMING_CONTROLLER].min)
+LOG_ADD(LOG_FLOAT, ctrlAvg, &stats[STAGE_TIMING_CONTROLLER].average)
+LOG_ADD(LOG_UINT16, ctrlMax, &stats[STAGE_TIMING_CONTROLLER].max)
+LOG_ADD(LOG_UINT16, ctrlP99, &stats[STAGE_TIMING_CONTROLLER].p99)
+LOG_ADD(LOG_UINT16, pwrMin, &stats[STAGE_TIMING_POWER_DISTRIBUTION].min)
+LOG_ADD(LOG_FLOAT, pwrAvg, &stats[STAGE_TIMING_POWER_DISTRIBUTION].average)
+LOG_ADD(LOG_UINT16, pwrMax, &stats[STAGE_TIMING_POWER_DISTRIBUTION].max)
+LOG_ADD(LOG_UINT16, pwrP99, &stats[STAGE_TIMING_POWER_DISTRIBUTION].p99)
+LOG_GROUP_STOP(stabTiming)
@@ -68,6 +68,10 @@
 #include "app.h"
 #include "static_mem.h"
 #include "peer_localization.h"
+#include "sensor_snapshot.h"
+#include "occupancy_grid.h"
+#include "breadcrumb_trail.h"
+#include "battery_estimator.h"
 #include "cfassert.h"
 
 #ifndef START_DISARMED
@@ -135,6 +139,10 @@ void systemInit(void) {
     pmInit();
     buzzerInit();
     peerLocalizationInit();
+    sensorSnapshotInit();
+    occupancyGridInit();
+    breadcrumbTrailInit();
+    batteryEstimatorInit();
 
 #ifdef APP_ENABLED
     appInit();
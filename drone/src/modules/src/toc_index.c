@@ -0,0 +1,81 @@
+/* toc_index.c: Constant time lookup of the log and param TOC variables */
+
+#include <string.h>
+#include "cfassert.h"
+#include "toc_index.h"
+
+#define EMPTY_BUCKET 0
+
+// FNV-1a over "group.name"
+static uint32_t hashString(uint32_t hash, const char* string) {
+    for (; *string != '\0'; string++) {
+        hash ^= (uint8_t)*string;
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+static uint32_t hashVariable(const char* group, const char* name) {
+    uint32_t hash = hashString(2166136261u, group);
+    hash = hashString(hash, ".");
+    return hashString(hash, name);
+}
+
+void tocIndexInit(tocIndex_t* index, uint16_t* buckets, uint16_t bucketCount, uint16_t* entryIndices,
+                  uint16_t variableCapacity) {
+    ASSERT(bucketCount > 0 && (bucketCount & (bucketCount - 1)) == 0);
+
+    index->buckets = buckets;
+    index->bucketCount = bucketCount;
+    index->entryIndices = entryIndices;
+    index->variableCapacity = variableCapacity;
+    index->variableCount = 0;
+    memset(buckets, EMPTY_BUCKET, bucketCount * sizeof(buckets[0]));
+}
+
+bool tocIndexAddVariable(tocIndex_t* index, const char* group, const char* name, uint16_t entryIndex) {
+    // At least one bucket stays empty, so that the lookups of missing variables end
+    if (index->variableCount >= index->variableCapacity || index->variableCount >= index->bucketCount - 1) {
+        return false;
+    }
+
+    const uint16_t id = index->variableCount;
+    index->entryIndices[id] = entryIndex;
+    index->variableCount++;
+
+    // Linear probing, a duplicated name goes after the first one so that lookups find the first one
+    const uint16_t mask = index->bucketCount - 1;
+    uint16_t bucket = hashVariable(group, name) & mask;
+    while (index->buckets[bucket] != EMPTY_BUCKET) {
+        bucket = (bucket + 1) & mask;
+    }
+    index->buckets[bucket] = id + 1;
+
+    return true;
+}
+
+int tocIndexFind(const tocIndex_t* index, const char* group, const char* name, tocIndexMatchFunction_t matches) {
+    const uint16_t mask = index->bucketCount - 1;
+    for (uint16_t bucket = hashVariable(group, name) & mask; index->buckets[bucket] != EMPTY_BUCKET;
+         bucket = (bucket + 1) & mask) {
+        const uint16_t id = index->buckets[bucket] - 1;
+        if (matches(index->entryIndices[id], group, name)) {
+            return id;
+        }
+    }
+
+    return -1;
+}
+
+int tocIndexGetEntryIndex(const tocIndex_t* index, int id) {
+    if (id < 0 || id >= index->variableCount) {
+        return -1;
+    }
+
+    return index->entryIndices[id];
+}
+
+uint16_t tocIndexGetVariableCount(const tocIndex_t* index) {
+    return index->variableCount;
+}
@@ -0,0 +1,106 @@
+// File under test battery_estimator.c
+#include "battery_estimator.h"
+
+#include "unity.h"
+
+#include "mock_cfassert.h"
+
+static const float deltaTime = 0.01f;
+static const uint16_t idleMotorRatios[BATTERY_ESTIMATOR_MOTOR_COUNT] = {0, 0, 0, 0};
+static const uint16_t hoverMotorRatios[BATTERY_ESTIMATOR_MOTOR_COUNT] = {42000, 42000, 42000, 42000};
+
+void setUp(void) {
+    batteryEstimatorInit();
+}
+
+void tearDown(void) {
+    // Empty
+}
+
+void testThatVoltagesOutsideTheReferencesAreClamped() {
+    // Fixture
+    // Test
+    // Assert
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, batteryEstimatorVoltageToStateOfCharge(3.0f, false));
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, batteryEstimatorVoltageToStateOfCharge(4.3f, false));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, batteryEstimatorVoltageToStateOfCharge(2.0f, true));
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, batteryEstimatorVoltageToStateOfCharge(4.0f, true));
+}
+
+void testThatVoltagesBetweenTheReferencesAreInterpolated() {
+    // Fixture
+    // Test
+    float actual = batteryEstimatorVoltageToStateOfCharge(3.81f, false);
+
+    // Assert
+    // Halfway between 40 % (3.80 V) and 45 % (3.82 V)
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.425f, actual);
+}
+
+void testThatTheFlyingReferencesAreUsedInFlight() {
+    // Fixture
+    // Test
+    float actual = batteryEstimatorVoltageToStateOfCharge(3.5f, true);
+
+    // Assert
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.6f, actual);
+}
+
+void testThatTheStateOfChargeStartsFromTheVoltageAtRest() {
+    // Fixture
+    // Test
+    batteryEstimatorReset(3.95f);
+
+    // Assert
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.7f, batteryEstimatorGetStateOfCharge());
+}
+
+void testThatTheStateOfChargeDecreasesUnderThrust() {
+    // Fixture
+    batteryEstimatorReset(3.95f);
+    const float initialStateOfCharge = batteryEstimatorGetStateOfCharge();
+
+    // Test
+    // The voltage sags in flight, but reads the same state of charge as at rest
+    for (int i = 0; i < 6000; i++) {
+        batteryEstimatorUpdate(3.571f, true, hoverMotorRatios, deltaTime);
+    }
+
+    // Assert
+    // About 2 A for 1 min drains a 250 mAh battery by 13 %, the voltage pulls the estimate back up part of the way
+    const float actual = batteryEstimatorGetStateOfCharge();
+    TEST_ASSERT_TRUE(actual < initialStateOfCharge - 0.02f);
+    TEST_ASSERT_TRUE(actual > initialStateOfCharge - 0.14f);
+}
+
+void testThatTheVoltageCorrectsTheCountedCharge() {
+    // Fixture
+    batteryEstimatorReset(4.2f);
+
+    // Test
+    // The battery was not fully charged, the voltage at rest reads 50 %
+    for (int i = 0; i < 30000; i++) {
+        batteryEstimatorUpdate(3.84f, false, idleMotorRatios, deltaTime);
+    }
+
+    // Assert
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 0.5f, batteryEstimatorGetStateOfCharge());
+}
+
+void testThatTheReturnStateOfChargeGrowsWithTheDistance() {
+    // Fixture
+    batteryEstimatorReset(3.95f);
+    for (int i = 0; i < 100; i++) {
+        batteryEstimatorUpdate(3.571f, true, hoverMotorRatios, deltaTime);
+    }
+
+    // Test
+    const float nearReturnStateOfCharge = batteryEstimatorGetReturnStateOfCharge(1.0f, 0.2f);
+    const float farReturnStateOfCharge = batteryEstimatorGetReturnStateOfCharge(20.0f, 0.2f);
+
+    // Assert
+    TEST_ASSERT_TRUE(nearReturnStateOfCharge > 0.05f);
+    TEST_ASSERT_TRUE(farReturnStateOfCharge > nearReturnStateOfCharge);
+    // 100 s of hovering at about 2 A with the safety margin
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 0.35f, farReturnStateOfCharge);
+}
@@ -0,0 +1,144 @@
+// File under test breadcrumb_trail.c
+#include "breadcrumb_trail.h"
+
+#include "occupancy_grid.h"
+#include "unity.h"
+
+#include "mock_cfassert.h"
+
+// At the center of a cell, so that rays along the axes do not follow cell boundaries
+static const point_t base = {.x = 0.1f, .y = 0.1f, .z = 0.3f};
+
+static point_t makePoint(float x, float y) {
+    const point_t point = {.x = x, .y = y, .z = base.z};
+    return point;
+}
+
+static void mapCorridorsFromTheBase(void) {
+    uint16_t ranges[RANGE_T_END] = {0};
+    ranges[rangeFront] = 3000;
+    ranges[rangeLeft] = 3000;
+    occupancyGridAddRangeReadings(&base, 0.0f, ranges);
+}
+
+void setUp(void) {
+    occupancyGridInit();
+    occupancyGridReset();
+    breadcrumbTrailInit();
+    breadcrumbTrailReset(&base);
+}
+
+void tearDown(void) {
+    // Empty
+}
+
+void testThatTheBaseIsTheOnlyBreadcrumbAfterReset() {
+    // Fixture
+    // Test
+    uint8_t actual = breadcrumbTrailGetCount();
+
+    // Assert
+    TEST_ASSERT_EQUAL(1, actual);
+}
+
+void testThatBreadcrumbsAreDroppedAtTheSpacing() {
+    // Fixture
+    const point_t closePosition = makePoint(0.3f, 0.1f);
+    const point_t farPosition = makePoint(0.7f, 0.1f);
+
+    // Test
+    breadcrumbTrailAdd(&closePosition);
+    breadcrumbTrailAdd(&farPosition);
+
+    // Assert
+    TEST_ASSERT_EQUAL(2, breadcrumbTrailGetCount());
+}
+
+void testThatTheTrailIsFollowedBackwardsWithoutAMap() {
+    // Fixture
+    const point_t positions[] = {makePoint(0.7f, 0.1f), makePoint(1.3f, 0.1f), makePoint(1.9f, 0.1f)};
+    for (uint8_t i = 0; i < sizeof(positions) / sizeof(positions[0]); i++) {
+        breadcrumbTrailAdd(&positions[i]);
+    }
+    point_t waypoint;
+
+    // Test
+    bool actual = breadcrumbTrailGetNextWaypoint(&positions[2], &waypoint);
+
+    // Assert
+    // The latest breadcrumb is where the drone already is
+    TEST_ASSERT_TRUE(actual);
+    TEST_ASSERT_EQUAL_FLOAT(1.3f, waypoint.x);
+    TEST_ASSERT_EQUAL_FLOAT(0.1f, waypoint.y);
+    TEST_ASSERT_EQUAL(3, breadcrumbTrailGetCount());
+}
+
+void testThatBreadcrumbsInSightAreSkipped() {
+    // Fixture
+    mapCorridorsFromTheBase();
+    const point_t positions[] = {makePoint(0.7f, 0.1f), makePoint(1.3f, 0.1f), makePoint(1.9f, 0.1f)};
+    for (uint8_t i = 0; i < sizeof(positions) / sizeof(positions[0]); i++) {
+        breadcrumbTrailAdd(&positions[i]);
+    }
+    point_t waypoint;
+
+    // Test
+    bool actual = breadcrumbTrailGetNextWaypoint(&positions[2], &waypoint);
+
+    // Assert
+    TEST_ASSERT_TRUE(actual);
+    TEST_ASSERT_EQUAL_FLOAT(base.x, waypoint.x);
+    TEST_ASSERT_EQUAL_FLOAT(base.y, waypoint.y);
+    TEST_ASSERT_EQUAL(1, breadcrumbTrailGetCount());
+}
+
+void testThatLoopsAreCutFromTheTrail() {
+    // Fixture
+    mapCorridorsFromTheBase();
+    const point_t positions[] = {makePoint(0.7f, 0.1f), makePoint(1.3f, 0.1f)};
+    for (uint8_t i = 0; i < sizeof(positions) / sizeof(positions[0]); i++) {
+        breadcrumbTrailAdd(&positions[i]);
+    }
+    const point_t backNearTheBase = makePoint(0.1f, 0.5f);
+
+    // Test
+    breadcrumbTrailAdd(&backNearTheBase);
+
+    // Assert
+    TEST_ASSERT_EQUAL(1, breadcrumbTrailGetCount());
+}
+
+void testThatAFullTrailKeepsTheBaseAndTheLatestBreadcrumb() {
+    // Fixture
+    point_t position = base;
+    for (uint8_t i = 1; i <= 2 * BREADCRUMB_TRAIL_MAX_COUNT; i++) {
+        position = makePoint(base.x + i * BREADCRUMB_TRAIL_SPACING, base.y);
+        breadcrumbTrailAdd(&position);
+    }
+    const point_t awayFromTheTrail = makePoint(position.x, position.y + 1.0f);
+    point_t waypoint;
+
+    // Test
+    bool actual = breadcrumbTrailGetNextWaypoint(&awayFromTheTrail, &waypoint);
+
+    // Assert
+    TEST_ASSERT_TRUE(actual);
+    TEST_ASSERT_TRUE(breadcrumbTrailGetCount() <= BREADCRUMB_TRAIL_MAX_COUNT);
+    TEST_ASSERT_EQUAL_FLOAT(position.x, waypoint.x);
+    TEST_ASSERT_EQUAL_FLOAT(position.y, waypoint.y);
+}
+
+void testThatTheLengthFollowsTheTrailBackToTheBase() {
+    // Fixture
+    const point_t positions[] = {makePoint(0.7f, 0.1f), makePoint(1.3f, 0.1f)};
+    for (uint8_t i = 0; i < sizeof(positions) / sizeof(positions[0]); i++) {
+        breadcrumbTrailAdd(&positions[i]);
+    }
+    const point_t position = makePoint(1.3f, 0.5f);
+
+    // Test
+    float actual = breadcrumbTrailGetLength(&position);
+
+    // Assert
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.6f, actual);
+}
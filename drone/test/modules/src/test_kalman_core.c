@@ -0,0 +1,498 @@
+// File under test kalman_core.c
+#include "kalman_core.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "unity.h"
+#include "outlierFilter.h"
+#include "physicalConstants.h"
+
+#include "mock_cfassert.h"
+
+// @BUILD_LIB ARM_DSP_MATH
+
+/**
+ * The replayed sequence is a synthetic flow deck flight generated by getFlightStep, not a recorded log: 100 Hz predictions of the
+ * estimator task, flow and ToF updates at 100 Hz, barometer updates at 50 Hz and position updates at 10 Hz from a motion capture
+ * system. It takes off, turns in yaw while circling and lands.
+ */
+#define FLIGHT_STEP_COUNT 3000
+#define FLIGHT_DT 0.01f
+#define POSITION_UPDATE_PERIOD 10
+#define BARO_UPDATE_PERIOD 2
+
+#define BENCHMARK_PREDICTION_COUNT 20000
+#define BENCHMARK_UPDATE_COUNT 20000
+
+static const float maxDivergence = 1e-5f;
+// The flow measurement is not linear in the height, so linearizing it before or after the ToF update gives slightly different results
+static const float maxBatchDivergence = 2e-3f;
+
+typedef enum {
+    UPDATE_DENSE,
+    UPDATE_SPARSE,
+    UPDATE_BATCH,
+} updateMode_t;
+
+typedef struct {
+    Axis3f acc;
+    Axis3f gyro;
+    float thrust;
+    bool isFlying;
+    flowMeasurement_t flow;
+    tofMeasurement_t tof;
+    float baroAsl;
+    positionMeasurement_t position;
+} flightStep_t;
+
+static kalmanCoreData_t denseCoreData;
+static kalmanCoreData_t sparseCoreData;
+static kalmanCoreData_t batchCoreData;
+
+// Helpers
+static void getFlightStep(int step, flightStep_t* flightStep);
+static void runFlightStep(kalmanCoreData_t* coreData, updateMode_t updateMode, int step, const flightStep_t* flightStep);
+static float getDivergence(const kalmanCoreData_t* expected, const kalmanCoreData_t* actual);
+static void runFlowDeckUpdates(kalmanCoreData_t* coreData, const flightStep_t* flightStep);
+static double measureFlight(updateMode_t updateMode, double* multiplyAccumulates);
+static double measurePredictions(bool isSparse, double* multiplyAccumulates);
+static double measureUpdates(bool isSparse, double* multiplyAccumulates);
+static double measureFlowDeckUpdates(bool isBatched, double* multiplyAccumulates);
+
+void setUp(void) {
+    kalmanCoreInit(&denseCoreData);
+    kalmanCoreInit(&sparseCoreData);
+    kalmanCoreInit(&batchCoreData);
+}
+
+void tearDown(void) {
+    kalmanCoreSetSparseCovarianceUpdate(true);
+}
+
+void testThatTheSparsePredictionMatchesTheDensePrediction() {
+    // Fixture
+    // Correlate the states so that every block of the covariance is used
+    flightStep_t flightStep;
+    for (int step = 0; step < 200; step++) {
+        getFlightStep(step, &flightStep);
+        runFlightStep(&denseCoreData, UPDATE_DENSE, step, &flightStep);
+    }
+    memcpy(&sparseCoreData, &denseCoreData, sizeof(kalmanCoreData_t));
+    sparseCoreData.Pm.pData = (float*)sparseCoreData.P;
+
+    // Test
+    kalmanCoreSetSparseCovarianceUpdate(false);
+    kalmanCorePredict(&denseCoreData, flightStep.thrust, &flightStep.acc, &flightStep.gyro, FLIGHT_DT, true);
+    kalmanCoreSetSparseCovarianceUpdate(true);
+    kalmanCorePredict(&sparseCoreData, flightStep.thrust, &flightStep.acc, &flightStep.gyro, FLIGHT_DT, true);
+
+    // Assert
+    TEST_ASSERT_EQUAL_FLOAT_ARRAY((float*)denseCoreData.P, (float*)sparseCoreData.P, KC_STATE_DIM * KC_STATE_DIM);
+    TEST_ASSERT_EQUAL_FLOAT_ARRAY(denseCoreData.S, sparseCoreData.S, KC_STATE_DIM);
+}
+
+void testThatTheSparseUpdatesMatchTheDenseUpdates() {
+    // Fixture
+    flightStep_t flightStep;
+    for (int step = 0; step < 200; step++) {
+        getFlightStep(step, &flightStep);
+        runFlightStep(&denseCoreData, UPDATE_DENSE, step, &flightStep);
+    }
+    memcpy(&sparseCoreData, &denseCoreData, sizeof(kalmanCoreData_t));
+    sparseCoreData.Pm.pData = (float*)sparseCoreData.P;
+
+    // Test
+    // A position update has one nonzero element in h, and a flow update two
+    kalmanCoreSetSparseCovarianceUpdate(false);
+    kalmanCoreUpdateWithPosition(&denseCoreData, &flightStep.position);
+    kalmanCoreUpdateWithFlow(&denseCoreData, &flightStep.flow, &flightStep.gyro);
+    kalmanCoreSetSparseCovarianceUpdate(true);
+    kalmanCoreUpdateWithPosition(&sparseCoreData, &flightStep.position);
+    kalmanCoreUpdateWithFlow(&sparseCoreData, &flightStep.flow, &flightStep.gyro);
+
+    // Assert
+    TEST_ASSERT_EQUAL_FLOAT_ARRAY((float*)denseCoreData.P, (float*)sparseCoreData.P, KC_STATE_DIM * KC_STATE_DIM);
+    TEST_ASSERT_EQUAL_FLOAT_ARRAY(denseCoreData.S, sparseCoreData.S, KC_STATE_DIM);
+}
+
+void testThatReplayingAFlightGivesTheSameEstimateWithBothCovarianceUpdates() {
+    // Fixture
+    flightStep_t flightStep;
+    float actualMaxDivergence = 0.0f;
+
+    // Test
+    for (int step = 0; step < FLIGHT_STEP_COUNT; step++) {
+        getFlightStep(step, &flightStep);
+        runFlightStep(&denseCoreData, UPDATE_DENSE, step, &flightStep);
+        runFlightStep(&sparseCoreData, UPDATE_SPARSE, step, &flightStep);
+
+        float divergence = getDivergence(&denseCoreData, &sparseCoreData);
+        if (divergence > actualMaxDivergence) {
+            actualMaxDivergence = divergence;
+        }
+    }
+
+    // Assert
+    printf("Max divergence between the dense and sparse covariance updates over %d steps: %e\n", FLIGHT_STEP_COUNT,
+           (double)actualMaxDivergence);
+    TEST_ASSERT_TRUE(actualMaxDivergence <= maxDivergence);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 0.0f, sparseCoreData.S[KC_STATE_Z]);
+}
+
+void testBenchmarkOfTheCovarianceUpdates() {
+    // Fixture
+    flightStep_t flightStep;
+    float actualMaxDivergence = 0.0f;
+    double densePredictionOperations, sparsePredictionOperations;
+    double denseUpdateOperations, sparseUpdateOperations;
+    double denseFlightOperations, sparseFlightOperations;
+
+    // Test
+    double densePredictionTime = measurePredictions(false, &densePredictionOperations);
+    double sparsePredictionTime = measurePredictions(true, &sparsePredictionOperations);
+    double denseUpdateTime = measureUpdates(false, &denseUpdateOperations);
+    double sparseUpdateTime = measureUpdates(true, &sparseUpdateOperations);
+    double denseFlightTime = measureFlight(UPDATE_DENSE, &denseFlightOperations);
+    double sparseFlightTime = measureFlight(UPDATE_SPARSE, &sparseFlightOperations);
+
+    kalmanCoreInit(&sparseCoreData);
+    for (int step = 0; step < FLIGHT_STEP_COUNT; step++) {
+        getFlightStep(step, &flightStep);
+        runFlightStep(&denseCoreData, UPDATE_DENSE, step, &flightStep);
+        runFlightStep(&sparseCoreData, UPDATE_SPARSE, step, &flightStep);
+        actualMaxDivergence = fmaxf(actualMaxDivergence, getDivergence(&denseCoreData, &sparseCoreData));
+    }
+
+    // Assert
+    // The multiply-accumulates are counted by kalman_core.c, the host times only compare the paths on this machine
+    printf("Covariance update      host time (dense / sparse)    multiply-accumulates (dense / sparse)\n");
+    printf("Prediction             %8.3f / %8.3f us          %8.0f / %.0f\n", densePredictionTime, sparsePredictionTime,
+           densePredictionOperations, sparsePredictionOperations);
+    printf("Position update        %8.3f / %8.3f us          %8.0f / %.0f\n", denseUpdateTime, sparseUpdateTime, denseUpdateOperations,
+           sparseUpdateOperations);
+    printf("Flight step            %8.3f / %8.3f us          %8.0f / %.0f\n", denseFlightTime, sparseFlightTime, denseFlightOperations,
+           sparseFlightOperations);
+    printf("Max divergence over the %d steps of the synthetic flight: %e\n", FLIGHT_STEP_COUNT, (double)actualMaxDivergence);
+    TEST_ASSERT_TRUE(sparsePredictionOperations < densePredictionOperations);
+    TEST_ASSERT_TRUE(sparseUpdateOperations < denseUpdateOperations);
+    TEST_ASSERT_TRUE(actualMaxDivergence <= maxDivergence);
+}
+
+void testThatABatchOfOneMeasurementMatchesTheScalarUpdate() {
+    // Fixture
+    heightMeasurement_t height = {.height = 0.4f, .stdDev = 0.01f};
+
+    // Test
+    kalmanCoreUpdateWithAbsoluteHeight(&sparseCoreData, &height);
+    kalmanCoreBeginBatchUpdate(&batchCoreData);
+    kalmanCoreUpdateWithAbsoluteHeight(&batchCoreData, &height);
+    kalmanCoreEndBatchUpdate(&batchCoreData);
+
+    // Assert
+    TEST_ASSERT_TRUE(getDivergence(&sparseCoreData, &batchCoreData) <= maxDivergence);
+}
+
+void testThatABatchOfLinearMeasurementsMatchesTheSequentialUpdates() {
+    // Fixture
+    flightStep_t flightStep;
+    for (int step = 0; step < 200; step++) {
+        getFlightStep(step, &flightStep);
+        runFlightStep(&sparseCoreData, UPDATE_SPARSE, step, &flightStep);
+    }
+    memcpy(&batchCoreData, &sparseCoreData, sizeof(kalmanCoreData_t));
+    batchCoreData.Pm.pData = (float*)batchCoreData.P;
+    positionMeasurement_t position = {.x = 0.1f, .y = -0.1f, .z = 0.5f, .stdDev = 0.01f};
+
+    // Test
+    // The three coordinates of a position measurement are applied together
+    kalmanCoreUpdateWithPosition(&sparseCoreData, &position);
+    kalmanCoreBeginBatchUpdate(&batchCoreData);
+    kalmanCoreUpdateWithPosition(&batchCoreData, &position);
+    kalmanCoreEndBatchUpdate(&batchCoreData);
+
+    // Assert
+    TEST_ASSERT_TRUE(getDivergence(&sparseCoreData, &batchCoreData) <= maxDivergence);
+}
+
+void testThatAFullBatchIsAppliedBeforeTheNextMeasurement() {
+    // Fixture
+    heightMeasurement_t height = {.height = 0.4f, .stdDev = 0.01f};
+    kalmanCoreBeginBatchUpdate(&batchCoreData);
+
+    // Test
+    for (int i = 0; i < KC_MAX_BATCH_SIZE; i++) {
+        kalmanCoreUpdateWithAbsoluteHeight(&batchCoreData, &height);
+    }
+
+    // Assert
+    TEST_ASSERT_EQUAL(0, batchCoreData.batch.size);
+    TEST_ASSERT_TRUE(batchCoreData.S[KC_STATE_Z] > 0.3f);
+    kalmanCoreEndBatchUpdate(&batchCoreData);
+}
+
+void testThatABatchWhichIsNotPositiveDefiniteFallsBackToSequentialUpdates() {
+    // Fixture
+    // A degenerate covariance makes HPH' + R negative
+    sparseCoreData.P[KC_STATE_Z][KC_STATE_Z] = -1.0f;
+    memcpy(&batchCoreData, &sparseCoreData, sizeof(kalmanCoreData_t));
+    batchCoreData.Pm.pData = (float*)batchCoreData.P;
+    heightMeasurement_t height = {.height = 0.4f, .stdDev = 0.1f};
+    heightMeasurement_t nextHeight = {.height = 0.5f, .stdDev = 0.1f};
+
+    // Test
+    kalmanCoreUpdateWithAbsoluteHeight(&sparseCoreData, &height);
+    kalmanCoreUpdateWithAbsoluteHeight(&sparseCoreData, &nextHeight);
+    kalmanCoreBeginBatchUpdate(&batchCoreData);
+    kalmanCoreUpdateWithAbsoluteHeight(&batchCoreData, &height);
+    kalmanCoreUpdateWithAbsoluteHeight(&batchCoreData, &nextHeight);
+    kalmanCoreEndBatchUpdate(&batchCoreData);
+
+    // Assert
+    TEST_ASSERT_EQUAL_UINT32(1, batchCoreData.batch.fallbackCount);
+    TEST_ASSERT_TRUE(getDivergence(&sparseCoreData, &batchCoreData) <= maxDivergence);
+}
+
+void testThatReplayingAFlightWithBatchUpdatesGivesTheSameEstimateAsSequentialUpdates() {
+    // Fixture
+    flightStep_t flightStep;
+    float actualMaxDivergence = 0.0f;
+
+    // Test
+    for (int step = 0; step < FLIGHT_STEP_COUNT; step++) {
+        getFlightStep(step, &flightStep);
+        runFlightStep(&sparseCoreData, UPDATE_SPARSE, step, &flightStep);
+        runFlightStep(&batchCoreData, UPDATE_BATCH, step, &flightStep);
+
+        float divergence = getDivergence(&sparseCoreData, &batchCoreData);
+        if (divergence > actualMaxDivergence) {
+            actualMaxDivergence = divergence;
+        }
+    }
+
+    // Assert
+    printf("Max divergence between the sequential and batch updates over %d steps: %e\n", FLIGHT_STEP_COUNT,
+           (double)actualMaxDivergence);
+    TEST_ASSERT_TRUE(actualMaxDivergence <= maxBatchDivergence);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 0.0f, batchCoreData.S[KC_STATE_Z]);
+}
+
+void testThatTheBatchUpdateOfTheFlowDeckMatchesTheSequentialUpdates() {
+    // Fixture
+    flightStep_t flightStep;
+    for (int step = 0; step < FLIGHT_STEP_COUNT / 2; step++) {
+        getFlightStep(step, &flightStep);
+        runFlightStep(&sparseCoreData, UPDATE_SPARSE, step, &flightStep);
+    }
+    memcpy(&batchCoreData, &sparseCoreData, sizeof(kalmanCoreData_t));
+    batchCoreData.Pm.pData = (float*)batchCoreData.P;
+    getFlightStep(FLIGHT_STEP_COUNT / 2, &flightStep);
+
+    // Test
+    runFlowDeckUpdates(&sparseCoreData, &flightStep);
+    kalmanCoreBeginBatchUpdate(&batchCoreData);
+    runFlowDeckUpdates(&batchCoreData, &flightStep);
+    kalmanCoreEndBatchUpdate(&batchCoreData);
+
+    // Assert
+    TEST_ASSERT_EQUAL_UINT32(0, batchCoreData.batch.fallbackCount);
+    TEST_ASSERT_TRUE(getDivergence(&sparseCoreData, &batchCoreData) <= maxBatchDivergence);
+}
+
+void testBenchmarkOfTheBatchUpdates() {
+    // Fixture
+    double sequentialOperations, batchOperations;
+    double sequentialFlightOperations, batchFlightOperations;
+
+    // Test
+    double sequentialTime = measureFlowDeckUpdates(false, &sequentialOperations);
+    double batchTime = measureFlowDeckUpdates(true, &batchOperations);
+    double sequentialFlightTime = measureFlight(UPDATE_SPARSE, &sequentialFlightOperations);
+    double batchFlightTime = measureFlight(UPDATE_BATCH, &batchFlightOperations);
+
+    // Assert
+    // The multiply-accumulates are counted by kalman_core.c, the host times only compare the paths on this machine
+    printf("Flow deck updates      host time (sequential / batch)    multiply-accumulates (sequential / batch)\n");
+    printf("Flow and ToF           %8.3f / %8.3f us              %8.0f / %.0f\n", sequentialTime, batchTime, sequentialOperations,
+           batchOperations);
+    printf("Flight step            %8.3f / %8.3f us              %8.0f / %.0f\n", sequentialFlightTime, batchFlightTime,
+           sequentialFlightOperations, batchFlightOperations);
+    TEST_ASSERT_TRUE(batchOperations < sequentialOperations);
+}
+
+// Helpers
+
+static void getFlightStep(int step, flightStep_t* flightStep) {
+    const float time = step * FLIGHT_DT;
+    const float flightTime = FLIGHT_STEP_COUNT * FLIGHT_DT;
+    const float takeOffTime = 2.0f;
+    const float landingTime = flightTime - 4.0f;
+    const float height = 0.4f;
+    const float radius = 0.5f;
+    const float angularVelocity = 0.5f; // rad/s
+
+    memset(flightStep, 0, sizeof(flightStep_t));
+    flightStep->isFlying = time > takeOffTime && time < landingTime + 2.0f;
+
+    // Circle at a constant height while turning to face the direction of travel, with a small vibration on the sensors
+    float z = 0.0f;
+    if (time > takeOffTime && time < landingTime) {
+        z = height * fminf(1.0f, (time - takeOffTime) / 2.0f);
+    } else if (time >= landingTime && time < landingTime + 2.0f) {
+        z = height * (1.0f - (time - landingTime) / 2.0f);
+    }
+    const bool isCircling = time > takeOffTime + 2.0f && time < landingTime;
+    const float yawRate = isCircling ? angularVelocity : 0.0f;
+    const float vibration = 0.02f * sinf(2.0f * PI * 7.0f * time);
+    const float gyroBias = 0.001f; // The prediction needs a nonzero rotation
+
+    flightStep->gyro = (Axis3f){.x = gyroBias + vibration, .y = gyroBias - vibration, .z = gyroBias + yawRate + vibration};
+    flightStep->acc = (Axis3f){.x = vibration, .y = isCircling ? radius * angularVelocity * angularVelocity : 0.0f, .z = GRAVITY_MAGNITUDE};
+    flightStep->thrust = GRAVITY_MAGNITUDE;
+
+    float vx = isCircling ? radius * angularVelocity : 0.0f;
+    flightStep->flow = (flowMeasurement_t){.stdDevX = 2.0f, .stdDevY = 2.0f, .dt = FLIGHT_DT};
+    flightStep->flow.dpixelx = z > 0.1f ? FLIGHT_DT * 30.0f / (4.2f * DEG_TO_RAD) * vx / z : 0.0f;
+    flightStep->flow.dpixely = vibration;
+    flightStep->tof = (tofMeasurement_t){.distance = z + vibration * 0.1f, .stdDev = 0.0025f};
+    flightStep->baroAsl = 100.0f + z + vibration;
+
+    float angle = isCircling ? angularVelocity * (time - takeOffTime - 2.0f) : 0.0f;
+    flightStep->position = (positionMeasurement_t){.stdDev = 0.01f};
+    flightStep->position.x = radius * sinf(angle);
+    flightStep->position.y = radius * (1.0f - cosf(angle));
+    flightStep->position.z = z;
+}
+
+static void runFlightStep(kalmanCoreData_t* coreData, updateMode_t updateMode, int step, const flightStep_t* flightStep) {
+    Axis3f acc = flightStep->acc;
+    Axis3f gyro = flightStep->gyro;
+    positionMeasurement_t position = flightStep->position;
+
+    kalmanCoreSetSparseCovarianceUpdate(updateMode != UPDATE_DENSE);
+    kalmanCorePredict(coreData, flightStep->thrust, &acc, &gyro, FLIGHT_DT, flightStep->isFlying);
+    kalmanCoreAddProcessNoise(coreData, FLIGHT_DT);
+
+    if (updateMode == UPDATE_BATCH) {
+        kalmanCoreBeginBatchUpdate(coreData);
+    }
+    runFlowDeckUpdates(coreData, flightStep);
+    if (step % BARO_UPDATE_PERIOD == 0) {
+        kalmanCoreUpdateWithBaro(coreData, flightStep->baroAsl, flightStep->isFlying);
+    }
+    if (step % POSITION_UPDATE_PERIOD == 0) {
+        kalmanCoreUpdateWithPosition(coreData, &position);
+    }
+    if (updateMode == UPDATE_BATCH) {
+        kalmanCoreEndBatchUpdate(coreData);
+    }
+
+    kalmanCoreFinalize(coreData, step);
+}
+
+static void runFlowDeckUpdates(kalmanCoreData_t* coreData, const flightStep_t* flightStep) {
+    // The prediction takes the gyro in rad/s and the flow update in deg/s
+    const Axis3f* gyro = &flightStep->gyro;
+    Axis3f gyroDegrees = {.x = gyro->x * RAD_TO_DEG, .y = gyro->y * RAD_TO_DEG, .z = gyro->z * RAD_TO_DEG};
+    flowMeasurement_t flow = flightStep->flow;
+    tofMeasurement_t tof = flightStep->tof;
+
+    kalmanCoreUpdateWithFlow(coreData, &flow, &gyroDegrees);
+    kalmanCoreUpdateWithTof(coreData, &tof);
+}
+
+// The largest difference of the state or covariance, relative to the value when it is larger than 1
+static float getDivergence(const kalmanCoreData_t* expected, const kalmanCoreData_t* actual) {
+    float divergence = 0.0f;
+    for (int i = 0; i < KC_STATE_DIM; i++) {
+        divergence = fmaxf(divergence, fabsf(actual->S[i] - expected->S[i]) / fmaxf(1.0f, fabsf(expected->S[i])));
+        for (int j = 0; j < KC_STATE_DIM; j++) {
+            divergence = fmaxf(divergence, fabsf(actual->P[i][j] - expected->P[i][j]) / fmaxf(1.0f, fabsf(expected->P[i][j])));
+        }
+    }
+    for (int i = 0; i < 4; i++) {
+        divergence = fmaxf(divergence, fabsf(actual->q[i] - expected->q[i]));
+    }
+    return divergence;
+}
+
+// Returns the average host time of a flight step (us), and sets its average count of multiply-accumulates
+static double measureFlight(updateMode_t updateMode, double* multiplyAccumulates) {
+    flightStep_t flightStep;
+    kalmanCoreInit(&sparseCoreData);
+    kalmanCoreResetMultiplyAccumulateCount();
+
+    clock_t start = clock();
+    for (int step = 0; step < FLIGHT_STEP_COUNT; step++) {
+        getFlightStep(step, &flightStep);
+        runFlightStep(&sparseCoreData, updateMode, step, &flightStep);
+    }
+    double time = (double)(clock() - start) / CLOCKS_PER_SEC * 1e6 / FLIGHT_STEP_COUNT;
+
+    *multiplyAccumulates = (double)kalmanCoreGetMultiplyAccumulateCount() / FLIGHT_STEP_COUNT;
+    return time;
+}
+
+// Returns the average host time of a prediction (us), and sets its average count of multiply-accumulates
+static double measurePredictions(bool isSparse, double* multiplyAccumulates) {
+    flightStep_t flightStep;
+    getFlightStep(FLIGHT_STEP_COUNT / 2, &flightStep);
+    kalmanCoreInit(&sparseCoreData);
+    kalmanCoreSetSparseCovarianceUpdate(isSparse);
+    kalmanCoreResetMultiplyAccumulateCount();
+
+    clock_t start = clock();
+    for (int i = 0; i < BENCHMARK_PREDICTION_COUNT; i++) {
+        kalmanCorePredict(&sparseCoreData, flightStep.thrust, &flightStep.acc, &flightStep.gyro, FLIGHT_DT, true);
+        kalmanCoreAddProcessNoise(&sparseCoreData, FLIGHT_DT);
+    }
+    double time = (double)(clock() - start) / CLOCKS_PER_SEC * 1e6 / BENCHMARK_PREDICTION_COUNT;
+
+    *multiplyAccumulates = (double)kalmanCoreGetMultiplyAccumulateCount() / BENCHMARK_PREDICTION_COUNT;
+    return time;
+}
+
+// Returns the average host time of a scalar update (us), and sets its average count of multiply-accumulates
+static double measureUpdates(bool isSparse, double* multiplyAccumulates) {
+    heightMeasurement_t height = {.height = 0.4f, .stdDev = 0.01f};
+    kalmanCoreInit(&sparseCoreData);
+    kalmanCoreSetSparseCovarianceUpdate(isSparse);
+    kalmanCoreResetMultiplyAccumulateCount();
+
+    clock_t start = clock();
+    for (int i = 0; i < BENCHMARK_UPDATE_COUNT; i++) {
+        kalmanCoreUpdateWithAbsoluteHeight(&sparseCoreData, &height);
+        kalmanCoreAddProcessNoise(&sparseCoreData, FLIGHT_DT);
+    }
+    double time = (double)(clock() - start) / CLOCKS_PER_SEC * 1e6 / BENCHMARK_UPDATE_COUNT;
+
+    *multiplyAccumulates = (double)kalmanCoreGetMultiplyAccumulateCount() / BENCHMARK_UPDATE_COUNT;
+    return time;
+}
+
+// Returns the average host time of the flow and ToF updates of an estimator loop (us), and sets their average count of
+// multiply-accumulates
+static double measureFlowDeckUpdates(bool isBatched, double* multiplyAccumulates) {
+    flightStep_t flightStep;
+    getFlightStep(FLIGHT_STEP_COUNT / 2, &flightStep);
+    kalmanCoreInit(&sparseCoreData);
+    kalmanCoreSetSparseCovarianceUpdate(true);
+    kalmanCoreResetMultiplyAccumulateCount();
+
+    clock_t start = clock();
+    for (int i = 0; i < BENCHMARK_UPDATE_COUNT; i++) {
+        if (isBatched) {
+            kalmanCoreBeginBatchUpdate(&sparseCoreData);
+            runFlowDeckUpdates(&sparseCoreData, &flightStep);
+            kalmanCoreEndBatchUpdate(&sparseCoreData);
+        } else {
+            runFlowDeckUpdates(&sparseCoreData, &flightStep);
+        }
+        kalmanCoreAddProcessNoise(&sparseCoreData, FLIGHT_DT);
+    }
+    double time = (double)(clock() - start) / CLOCKS_PER_SEC * 1e6 / BENCHMARK_UPDATE_COUNT;
+
+    *multiplyAccumulates = (double)kalmanCoreGetMultiplyAccumulateCount() / BENCHMARK_UPDATE_COUNT;
+    return time;
+}
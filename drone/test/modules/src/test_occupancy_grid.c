@@ -0,0 +1,309 @@
+// File under test occupancy_grid.c
+#include "occupancy_grid.h"
+
+#include <math.h>
+#include "unity.h"
+
+#include "mock_cfassert.h"
+
+// At the center of a cell, so that rays along the axes do not follow cell boundaries
+static const point_t origin = {.x = 0.1f, .y = 0.1f, .z = 0.3f};
+static uint16_t ranges[RANGE_T_END];
+
+bool isBehindTheOrigin(float x, float y);
+
+void setUp(void) {
+    occupancyGridInit();
+    occupancyGridReset();
+
+    for (int i = 0; i < RANGE_T_END; i++) {
+        ranges[i] = 0;
+    }
+}
+
+void tearDown(void) {
+    // Empty
+}
+
+void testThatCellsAreUnknownAfterReset() {
+    // Fixture
+    // Test
+    occupancyGridCellState_t actual = occupancyGridGetCellState(0.5f, 0.1f);
+
+    // Assert
+    TEST_ASSERT_EQUAL(OCCUPANCY_GRID_UNKNOWN, actual);
+}
+
+void testThatCellsCrossedByAReadingAreFree() {
+    // Fixture
+    ranges[rangeFront] = 1000;
+
+    // Test
+    occupancyGridAddRangeReadings(&origin, 0.0f, ranges);
+
+    // Assert
+    TEST_ASSERT_EQUAL(OCCUPANCY_GRID_FREE, occupancyGridGetCellState(0.1f, 0.1f));
+    TEST_ASSERT_EQUAL(OCCUPANCY_GRID_FREE, occupancyGridGetCellState(0.9f, 0.1f));
+}
+
+void testThatTheCellHitByAReadingIsOccupied() {
+    // Fixture
+    ranges[rangeFront] = 1000;
+
+    // Test
+    occupancyGridAddRangeReadings(&origin, 0.0f, ranges);
+
+    // Assert
+    TEST_ASSERT_EQUAL(OCCUPANCY_GRID_OCCUPIED, occupancyGridGetCellState(1.1f, 0.1f));
+    TEST_ASSERT_EQUAL(OCCUPANCY_GRID_UNKNOWN, occupancyGridGetCellState(1.3f, 0.1f));
+}
+
+void testThatReadingsAreRotatedByTheYaw() {
+    // Fixture
+    ranges[rangeFront] = 1000;
+
+    // Test
+    occupancyGridAddRangeReadings(&origin, 90.0f, ranges);
+
+    // Assert
+    TEST_ASSERT_EQUAL(OCCUPANCY_GRID_OCCUPIED, occupancyGridGetCellState(0.1f, 1.1f));
+    TEST_ASSERT_EQUAL(OCCUPANCY_GRID_UNKNOWN, occupancyGridGetCellState(1.1f, 0.1f));
+}
+
+void testThatEachSensorIsCastInItsDirection() {
+    // Fixture
+    ranges[rangeFront] = 1000;
+    ranges[rangeLeft] = 600;
+    ranges[rangeBack] = 1400;
+    ranges[rangeRight] = 200;
+
+    // Test
+    occupancyGridAddRangeReadings(&origin, 0.0f, ranges);
+
+    // Assert
+    TEST_ASSERT_EQUAL(OCCUPANCY_GRID_OCCUPIED, occupancyGridGetCellState(1.1f, 0.1f));
+    TEST_ASSERT_EQUAL(OCCUPANCY_GRID_OCCUPIED, occupancyGridGetCellState(0.1f, 0.7f));
+    TEST_ASSERT_EQUAL(OCCUPANCY_GRID_OCCUPIED, occupancyGridGetCellState(-1.3f, 0.1f));
+    TEST_ASSERT_EQUAL(OCCUPANCY_GRID_OCCUPIED, occupancyGridGetCellState(0.1f, -0.1f));
+}
+
+void testThatReadingsAboveTheThresholdDoNotHitAnything() {
+    // Fixture
+    ranges[rangeFront] = 3000;
+
+    // Test
+    occupancyGridAddRangeReadings(&origin, 0.0f, ranges);
+
+    // Assert
+    TEST_ASSERT_EQUAL(OCCUPANCY_GRID_FREE, occupancyGridGetCellState(1.9f, 0.1f));
+    TEST_ASSERT_EQUAL(OCCUPANCY_GRID_FREE, occupancyGridGetCellState(2.1f, 0.1f));
+    TEST_ASSERT_EQUAL(OCCUPANCY_GRID_UNKNOWN, occupancyGridGetCellState(2.3f, 0.1f));
+}
+
+void testThatFailedReadingsAreIgnored() {
+    // Fixture
+    // Test
+    occupancyGridAddRangeReadings(&origin, 0.0f, ranges);
+
+    // Assert
+    TEST_ASSERT_EQUAL(OCCUPANCY_GRID_UNKNOWN, occupancyGridGetCellState(0.1f, 0.1f));
+}
+
+void testThatCellsOutsideTheGridAreUnknown() {
+    // Fixture
+    const point_t edge = {.x = 6.3f, .y = 0.1f, .z = 0.3f};
+    ranges[rangeFront] = 1000;
+
+    // Test
+    occupancyGridAddRangeReadings(&edge, 0.0f, ranges);
+
+    // Assert
+    TEST_ASSERT_EQUAL(OCCUPANCY_GRID_FREE, occupancyGridGetCellState(6.3f, 0.1f));
+    TEST_ASSERT_EQUAL(OCCUPANCY_GRID_UNKNOWN, occupancyGridGetCellState(6.5f, 0.1f));
+}
+
+void testThatAnOccupiedCellBecomesFreeAfterRepeatedMisses() {
+    // Fixture
+    ranges[rangeFront] = 1000;
+    occupancyGridAddRangeReadings(&origin, 0.0f, ranges);
+    ranges[rangeFront] = 1400;
+
+    // Test
+    for (int i = 0; i < 4; i++) {
+        occupancyGridAddRangeReadings(&origin, 0.0f, ranges);
+    }
+
+    // Assert
+    TEST_ASSERT_EQUAL(OCCUPANCY_GRID_FREE, occupancyGridGetCellState(1.1f, 0.1f));
+}
+
+void testThatNeighbouringCellsAreStoredIndependently() {
+    // Fixture
+    // Cells with the same row and consecutive columns share a byte
+    const point_t nextPosition = {.x = 0.1f, .y = 0.3f, .z = 0.3f};
+    ranges[rangeFront] = 1000;
+    occupancyGridAddRangeReadings(&origin, 0.0f, ranges);
+
+    // Test
+    ranges[rangeFront] = 1200;
+    occupancyGridAddRangeReadings(&nextPosition, 0.0f, ranges);
+
+    // Assert
+    TEST_ASSERT_EQUAL(OCCUPANCY_GRID_OCCUPIED, occupancyGridGetCellState(1.1f, 0.1f));
+    TEST_ASSERT_EQUAL(OCCUPANCY_GRID_UNKNOWN, occupancyGridGetCellState(1.3f, 0.1f));
+    TEST_ASSERT_EQUAL(OCCUPANCY_GRID_FREE, occupancyGridGetCellState(1.1f, 0.3f));
+    TEST_ASSERT_EQUAL(OCCUPANCY_GRID_OCCUPIED, occupancyGridGetCellState(1.3f, 0.3f));
+}
+
+void testThatResetClearsTheGrid() {
+    // Fixture
+    ranges[rangeFront] = 1000;
+    occupancyGridAddRangeReadings(&origin, 0.0f, ranges);
+
+    // Test
+    occupancyGridReset();
+
+    // Assert
+    TEST_ASSERT_EQUAL(OCCUPANCY_GRID_UNKNOWN, occupancyGridGetCellState(1.1f, 0.1f));
+    TEST_ASSERT_EQUAL(OCCUPANCY_GRID_UNKNOWN, occupancyGridGetCellState(0.5f, 0.1f));
+}
+
+void testThatASegmentAcrossFreeCellsIsFree() {
+    // Fixture
+    ranges[rangeFront] = 1000;
+    occupancyGridAddRangeReadings(&origin, 0.0f, ranges);
+    const point_t end = {.x = 0.9f, .y = 0.1f, .z = 0.3f};
+
+    // Test
+    bool actual = occupancyGridIsSegmentFree(&origin, &end);
+
+    // Assert
+    TEST_ASSERT_TRUE(actual);
+}
+
+void testThatASegmentAcrossAnOccupiedOrUnknownCellIsNotFree() {
+    // Fixture
+    ranges[rangeFront] = 1000;
+    occupancyGridAddRangeReadings(&origin, 0.0f, ranges);
+    const point_t pastTheObstacle = {.x = 1.3f, .y = 0.1f, .z = 0.3f};
+    const point_t unexplored = {.x = 0.1f, .y = 0.9f, .z = 0.3f};
+
+    // Test
+    // Assert
+    TEST_ASSERT_FALSE(occupancyGridIsSegmentFree(&origin, &pastTheObstacle));
+    TEST_ASSERT_FALSE(occupancyGridIsSegmentFree(&origin, &unexplored));
+}
+
+void testThatNoHeadingIsFoundInAnUnknownGrid() {
+    // Fixture
+    float heading;
+
+    // Test
+    bool actual = occupancyGridFindLeastExploredHeading(&origin, &heading);
+
+    // Assert
+    TEST_ASSERT_FALSE(actual);
+}
+
+void testThatTheLeastExploredHeadingIsFound() {
+    // Fixture
+    // Explore every heading except the one behind the drone
+    ranges[rangeFront] = 3000;
+    ranges[rangeLeft] = 3000;
+    ranges[rangeRight] = 3000;
+    occupancyGridAddRangeReadings(&origin, 0.0f, ranges);
+    occupancyGridAddRangeReadings(&origin, 45.0f, ranges);
+    occupancyGridAddRangeReadings(&origin, -45.0f, ranges);
+    float heading;
+
+    // Test
+    bool actual = occupancyGridFindLeastExploredHeading(&origin, &heading);
+
+    // Assert
+    TEST_ASSERT_TRUE(actual);
+    TEST_ASSERT_EQUAL_FLOAT(-180.0f, heading);
+}
+
+void testThatHeadingsBlockedByObstaclesAreAvoided() {
+    // Fixture
+    // Explore ahead, and find an obstacle which hides the unknown cells behind the drone
+    ranges[rangeFront] = 3000;
+    ranges[rangeBack] = 200;
+    occupancyGridAddRangeReadings(&origin, 0.0f, ranges);
+    float heading;
+
+    // Test
+    bool actual = occupancyGridFindLeastExploredHeading(&origin, &heading);
+
+    // Assert
+    TEST_ASSERT_TRUE(actual);
+    TEST_ASSERT_TRUE(heading != 0.0f && heading != -180.0f);
+}
+
+void testThatNoFrontierIsFoundInAnUnknownGrid() {
+    // Fixture
+    point_t frontier;
+
+    // Test
+    bool actual = occupancyGridFindNearestFrontier(&origin, NULL, 0, NULL, &frontier);
+
+    // Assert
+    TEST_ASSERT_FALSE(actual);
+}
+
+void testThatTheNearestFrontierIsFound() {
+    // Fixture
+    // The corridor ahead ends 1 m away, the one to the left 0.6 m away
+    ranges[rangeFront] = 1000;
+    ranges[rangeLeft] = 600;
+    ranges[rangeBack] = 2000;
+    ranges[rangeRight] = 2000;
+    occupancyGridAddRangeReadings(&origin, 0.0f, ranges);
+    point_t frontier;
+
+    // Test
+    bool actual = occupancyGridFindNearestFrontier(&origin, NULL, 0, NULL, &frontier);
+
+    // Assert
+    // Every free cell next to the drone borders unknown cells
+    TEST_ASSERT_TRUE(actual);
+    TEST_ASSERT_FLOAT_WITHIN(0.25f, origin.x, frontier.x);
+    TEST_ASSERT_FLOAT_WITHIN(0.25f, origin.y, frontier.y);
+}
+
+void testThatClaimedFrontiersAreSkipped() {
+    // Fixture
+    ranges[rangeFront] = 3000;
+    ranges[rangeBack] = 3000;
+    occupancyGridAddRangeReadings(&origin, 0.0f, ranges);
+    const point_t claimedFrontiers[] = {{.x = 0.1f, .y = 0.1f, .z = 0.3f}};
+    point_t frontier;
+
+    // Test
+    bool actual = occupancyGridFindNearestFrontier(&origin, claimedFrontiers, 1, NULL, &frontier);
+
+    // Assert
+    TEST_ASSERT_TRUE(actual);
+    TEST_ASSERT_TRUE(fabsf(frontier.x - origin.x) > 0.9f);
+}
+
+void testThatFrontiersExploredByOtherDronesAreSkipped() {
+    // Fixture
+    ranges[rangeFront] = 3000;
+    ranges[rangeBack] = 3000;
+    occupancyGridAddRangeReadings(&origin, 0.0f, ranges);
+    point_t frontier;
+
+    // Test
+    bool actual = occupancyGridFindNearestFrontier(&origin, NULL, 0, isBehindTheOrigin, &frontier);
+
+    // Assert
+    TEST_ASSERT_TRUE(actual);
+    TEST_ASSERT_TRUE(frontier.x > origin.x + 0.1f);
+}
+
+// Helpers
+
+bool isBehindTheOrigin(float x, float y) {
+    return x < origin.x + 0.1f;
+}
@@ -0,0 +1,244 @@
+// File under test spsc_queue.c
+#include "spsc_queue.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include "unity.h"
+
+#include "mock_cfassert.h"
+
+#define QUEUE_CAPACITY 8
+#define STRESS_ITEM_COUNT 1000000
+#define PAYLOAD_SIZE 7
+
+typedef struct {
+    uint32_t sequence;
+    // Derived from the sequence number, to detect items read while they are written
+    uint32_t payload[PAYLOAD_SIZE];
+} item_t;
+
+static item_t buffer[QUEUE_CAPACITY];
+static spscQueue_t queue;
+
+static void fillItem(item_t* item, uint32_t sequence);
+static bool isItemConsistent(const item_t* item);
+static void* produce(void* parameters);
+static void waitForTheOtherThread(uint32_t handledCount);
+
+void setUp(void) {
+    spscQueueInit(&queue, buffer, sizeof(item_t), QUEUE_CAPACITY);
+}
+
+void tearDown(void) {
+    // Empty
+}
+
+void testThatANewQueueIsEmpty() {
+    // Fixture
+    item_t item;
+
+    // Test
+    // Assert
+    TEST_ASSERT_EQUAL_UINT32(0, spscQueueGetPendingCount(&queue));
+    TEST_ASSERT_FALSE(spscQueuePop(&queue, &item));
+}
+
+void testThatItemsArePoppedInOrder() {
+    // Fixture
+    item_t item;
+    for (uint32_t i = 0; i < 3; i++) {
+        fillItem(&item, i);
+        spscQueuePush(&queue, &item);
+    }
+
+    // Test
+    // Assert
+    for (uint32_t i = 0; i < 3; i++) {
+        TEST_ASSERT_TRUE(spscQueuePop(&queue, &item));
+        TEST_ASSERT_EQUAL_UINT32(i, item.sequence);
+    }
+    TEST_ASSERT_FALSE(spscQueuePop(&queue, &item));
+}
+
+void testThatPushingToAFullQueueCountsAnOverrun() {
+    // Fixture
+    item_t item;
+    for (uint32_t i = 0; i < QUEUE_CAPACITY; i++) {
+        fillItem(&item, i);
+        TEST_ASSERT_TRUE(spscQueuePush(&queue, &item));
+    }
+
+    // Test
+    fillItem(&item, QUEUE_CAPACITY);
+    bool actual = spscQueuePush(&queue, &item);
+
+    // Assert
+    TEST_ASSERT_FALSE(actual);
+    TEST_ASSERT_EQUAL_UINT32(1, spscQueueGetOverrunCount(&queue));
+    TEST_ASSERT_EQUAL_UINT32(QUEUE_CAPACITY, spscQueueGetPendingCount(&queue));
+
+    // The dropped item is the new one
+    spscQueuePop(&queue, &item);
+    TEST_ASSERT_EQUAL_UINT32(0, item.sequence);
+}
+
+void testThatPendingItemsAreReadInPlaceUntilReleased() {
+    // Fixture
+    item_t item;
+    for (uint32_t i = 0; i < 5; i++) {
+        fillItem(&item, i);
+        spscQueuePush(&queue, &item);
+    }
+
+    // Test
+    uint32_t count = spscQueueGetPendingCount(&queue);
+    const item_t* third = spscQueueGetPending(&queue, 2);
+    spscQueueRelease(&queue, 3);
+
+    // Assert
+    TEST_ASSERT_EQUAL_UINT32(5, count);
+    TEST_ASSERT_EQUAL_UINT32(2, third->sequence);
+    TEST_ASSERT_EQUAL_UINT32(2, spscQueueGetPendingCount(&queue));
+    spscQueuePop(&queue, &item);
+    TEST_ASSERT_EQUAL_UINT32(3, item.sequence);
+}
+
+void testThatResetDropsThePendingItems() {
+    // Fixture
+    item_t item;
+    fillItem(&item, 0);
+    spscQueuePush(&queue, &item);
+    spscQueuePush(&queue, &item);
+
+    // Test
+    spscQueueReset(&queue);
+
+    // Assert
+    TEST_ASSERT_EQUAL_UINT32(0, spscQueueGetPendingCount(&queue));
+    TEST_ASSERT_TRUE(spscQueuePush(&queue, &item));
+    TEST_ASSERT_EQUAL_UINT32(1, spscQueueGetPendingCount(&queue));
+}
+
+void testThatTheIndicesWrapAround() {
+    // Fixture
+    queue.writeIndex = UINT32_MAX - 2;
+    queue.readIndex = UINT32_MAX - 2;
+    item_t item;
+
+    // Test
+    for (uint32_t i = 0; i < QUEUE_CAPACITY; i++) {
+        fillItem(&item, i);
+        TEST_ASSERT_TRUE(spscQueuePush(&queue, &item));
+    }
+
+    // Assert
+    TEST_ASSERT_FALSE(spscQueuePush(&queue, &item));
+    TEST_ASSERT_EQUAL_UINT32(QUEUE_CAPACITY, spscQueueGetPendingCount(&queue));
+    for (uint32_t i = 0; i < QUEUE_CAPACITY; i++) {
+        TEST_ASSERT_TRUE(spscQueuePop(&queue, &item));
+        TEST_ASSERT_EQUAL_UINT32(i, item.sequence);
+    }
+}
+
+void testThatAllItemsArriveIntactWhenTheProducerWaitsForSpace() {
+    // Fixture
+    bool waitForSpace = true;
+    pthread_t producer;
+    uint32_t expectedSequence = 0;
+    bool isConsistent = true;
+
+    // Test
+    pthread_create(&producer, NULL, produce, &waitForSpace);
+    while (expectedSequence < STRESS_ITEM_COUNT) {
+        uint32_t count = spscQueueGetPendingCount(&queue);
+        for (uint32_t i = 0; i < count; i++) {
+            const item_t* item = spscQueueGetPending(&queue, i);
+            isConsistent &= isItemConsistent(item) && item->sequence == expectedSequence;
+            expectedSequence++;
+        }
+        spscQueueRelease(&queue, count);
+        waitForTheOtherThread(count);
+    }
+    pthread_join(producer, NULL);
+
+    // Assert
+    TEST_ASSERT_TRUE(isConsistent);
+    TEST_ASSERT_EQUAL_UINT32(0, spscQueueGetPendingCount(&queue));
+    TEST_ASSERT_EQUAL_UINT32(0, spscQueueGetOverrunCount(&queue));
+}
+
+void testThatDroppedItemsAreCountedAsOverrunsUnderLoad() {
+    // Fixture
+    bool waitForSpace = false;
+    pthread_t producer;
+    uint32_t receivedCount = 0;
+    uint32_t lastSequence = 0;
+    bool isConsistent = true;
+
+    // Test
+    pthread_create(&producer, NULL, produce, &waitForSpace);
+    while (lastSequence < STRESS_ITEM_COUNT - 1) {
+        uint32_t count = spscQueueGetPendingCount(&queue);
+        for (uint32_t i = 0; i < count; i++) {
+            const item_t* item = spscQueueGetPending(&queue, i);
+            isConsistent &= isItemConsistent(item) && (receivedCount == 0 || item->sequence > lastSequence);
+            lastSequence = item->sequence;
+            receivedCount++;
+        }
+        spscQueueRelease(&queue, count);
+        waitForTheOtherThread(count);
+
+        // The last item may be dropped too
+        if (receivedCount + spscQueueGetOverrunCount(&queue) == STRESS_ITEM_COUNT) {
+            break;
+        }
+    }
+    pthread_join(producer, NULL);
+
+    // Assert
+    TEST_ASSERT_TRUE(isConsistent);
+    TEST_ASSERT_EQUAL_UINT32(STRESS_ITEM_COUNT, receivedCount + spscQueueGetOverrunCount(&queue));
+}
+
+// Helpers ////////////////////////////////////////////////
+
+static void fillItem(item_t* item, uint32_t sequence) {
+    item->sequence = sequence;
+    for (int i = 0; i < PAYLOAD_SIZE; i++) {
+        item->payload[i] = sequence * (i + 1) ^ 0xa5a5a5a5;
+    }
+}
+
+static bool isItemConsistent(const item_t* item) {
+    for (int i = 0; i < PAYLOAD_SIZE; i++) {
+        if (item->payload[i] != (item->sequence * (i + 1) ^ 0xa5a5a5a5)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void* produce(void* parameters) {
+    const bool waitForSpace = *(bool*)parameters;
+    item_t item;
+
+    for (uint32_t sequence = 0; sequence < STRESS_ITEM_COUNT; sequence++) {
+        fillItem(&item, sequence);
+        while (!spscQueuePush(&queue, &item) && waitForSpace) {
+            // A full queue is not an overrun here, undo the count and retry
+            queue.overrunCount--;
+            waitForTheOtherThread(0);
+        }
+    }
+
+    return NULL;
+}
+
+// Lets the other thread run when there is nothing to do, the test would otherwise crawl on a single core
+static void waitForTheOtherThread(uint32_t handledCount) {
+    if (handledCount == 0) {
+        sched_yield();
+    }
+}
@@ -0,0 +1,130 @@
+// File under test stage_timing.c
+#include "stage_timing.h"
+
+#include "unity.h"
+
+#include "mock_cfassert.h"
+
+// In MHz, as on the Crazyflie
+static const uint32_t clockFrequency = 168;
+
+static void addSamples(stageTimingStage_t stage, uint32_t duration, int count);
+
+void setUp(void) {
+    stageTimingInit(clockFrequency);
+    stageTimingReset();
+}
+
+void tearDown(void) {
+    // Empty
+}
+
+void testThatAStageIsTimedWithTheCycleCounter() {
+    // Fixture
+    stageTimingSetHostCycles(1000);
+
+    // Test
+    for (int i = 0; i < STAGE_TIMING_WINDOW; i++) {
+        stageTimingStart(STAGE_TIMING_CONTROLLER);
+        stageTimingSetHostCycles(stageTimingGetCycles() + 25 * clockFrequency);
+        stageTimingStop(STAGE_TIMING_CONTROLLER);
+    }
+
+    // Assert
+    const stageTimingStats_t* actual = stageTimingGetStats(STAGE_TIMING_CONTROLLER);
+    TEST_ASSERT_EQUAL(25, actual->min);
+    TEST_ASSERT_EQUAL(25, actual->max);
+    TEST_ASSERT_EQUAL_FLOAT(25.0f, actual->average);
+}
+
+void testThatTheDurationIsRightAcrossAWrapAroundOfTheCounter() {
+    // Fixture
+    stageTimingSetHostCycles(UINT32_MAX - 9);
+
+    // Test
+    for (int i = 0; i < STAGE_TIMING_WINDOW; i++) {
+        stageTimingStart(STAGE_TIMING_ESTIMATOR);
+        stageTimingSetHostCycles(stageTimingGetCycles() + 20 * clockFrequency);
+        stageTimingStop(STAGE_TIMING_ESTIMATOR);
+        stageTimingSetHostCycles(UINT32_MAX - 9);
+    }
+
+    // Assert
+    TEST_ASSERT_EQUAL(20, stageTimingGetStats(STAGE_TIMING_ESTIMATOR)->max);
+}
+
+void testThatTheStatisticsArePublishedAtTheEndOfAWindow() {
+    // Fixture
+    addSamples(STAGE_TIMING_COMMANDER, 10, STAGE_TIMING_WINDOW - 1);
+
+    // Test
+    float averageBefore = stageTimingGetStats(STAGE_TIMING_COMMANDER)->average;
+    addSamples(STAGE_TIMING_COMMANDER, 10, 1);
+
+    // Assert
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, averageBefore);
+    TEST_ASSERT_EQUAL_FLOAT(10.0f, stageTimingGetStats(STAGE_TIMING_COMMANDER)->average);
+}
+
+void testThatTheStatisticsCoverTheSamplesOfTheWindow() {
+    // Fixture
+    // 1 % of the loops are slow
+    addSamples(STAGE_TIMING_COLLISION_AVOIDANCE, 10, 980);
+    addSamples(STAGE_TIMING_COLLISION_AVOIDANCE, 30, 10);
+
+    // Test
+    addSamples(STAGE_TIMING_COLLISION_AVOIDANCE, 90, 10);
+
+    // Assert
+    const stageTimingStats_t* actual = stageTimingGetStats(STAGE_TIMING_COLLISION_AVOIDANCE);
+    TEST_ASSERT_EQUAL(10, actual->min);
+    TEST_ASSERT_EQUAL(90, actual->max);
+    TEST_ASSERT_EQUAL_FLOAT(11.0f, actual->average);
+    // The upper edge of the 16-32 us bin
+    TEST_ASSERT_EQUAL(32, actual->p99);
+}
+
+void testThatThePercentileIsBinnedUpToTheLoopBudget() {
+    // Fixture
+    addSamples(STAGE_TIMING_ESTIMATOR, 10, 980);
+    addSamples(STAGE_TIMING_ESTIMATOR, 600, 10);
+
+    // Test
+    addSamples(STAGE_TIMING_ESTIMATOR, 950, 10);
+
+    // Assert
+    const stageTimingStats_t* actual = stageTimingGetStats(STAGE_TIMING_ESTIMATOR);
+    TEST_ASSERT_EQUAL(950, actual->max);
+    // The upper edge of the 592-608 us bin
+    TEST_ASSERT_EQUAL(608, actual->p99);
+}
+
+void testThatThePercentileIsTheMaximumWhenItIsInTheLastBin() {
+    // Fixture
+    addSamples(STAGE_TIMING_POWER_DISTRIBUTION, 10, 500);
+
+    // Test
+    addSamples(STAGE_TIMING_POWER_DISTRIBUTION, 1500, 500);
+
+    // Assert
+    const stageTimingStats_t* actual = stageTimingGetStats(STAGE_TIMING_POWER_DISTRIBUTION);
+    TEST_ASSERT_EQUAL(1500, actual->max);
+    TEST_ASSERT_EQUAL(1500, actual->p99);
+}
+
+void testThatThePercentileDoesNotExceedTheMaximum() {
+    // Fixture
+    // Test
+    addSamples(STAGE_TIMING_CONTROLLER, 5, STAGE_TIMING_WINDOW);
+
+    // Assert
+    TEST_ASSERT_EQUAL(5, stageTimingGetStats(STAGE_TIMING_CONTROLLER)->p99);
+}
+
+// Helpers ////////////////////////////////////////////////
+
+static void addSamples(stageTimingStage_t stage, uint32_t duration, int count) {
+    for (int i = 0; i < count; i++) {
+        stageTimingAddSample(stage, duration * clockFrequency);
+    }
+}
@@ -0,0 +1,263 @@
+// File under test toc_index.c
+#include "toc_index.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "unity.h"
+
+#include "mock_cfassert.h"
+
+// A TOC the size of the firmware's log TOC, laid out like the .log section: group start, variables, group stop
+#define GROUP_COUNT 72
+#define VARIABLES_PER_GROUP 8
+#define VARIABLE_COUNT (GROUP_COUNT * VARIABLES_PER_GROUP)
+#define ENTRY_COUNT (GROUP_COUNT * (VARIABLES_PER_GROUP + 2))
+#define NAME_LENGTH 16
+#define BUCKET_COUNT 1024
+#define BENCHMARK_PASS_COUNT 200
+
+#define TOC_GROUP 0x80
+#define TOC_START 1
+
+typedef struct {
+    uint8_t type;
+    char name[NAME_LENGTH];
+} tocEntry_t;
+
+static tocEntry_t toc[ENTRY_COUNT];
+static uint16_t buckets[BUCKET_COUNT];
+static uint16_t entryIndices[VARIABLE_COUNT];
+static tocIndex_t tocIndex;
+
+static void buildToc(void);
+static void addTocToIndex(void);
+static bool entryMatches(uint16_t entryIndex, const char* group, const char* name);
+static int linearFind(const char* group, const char* name);
+static int linearGetEntryIndex(int id);
+static double measureNameLookups(bool useIndex);
+static double measureIdLookups(bool useIndex);
+
+void setUp(void) {
+    buildToc();
+    tocIndexInit(&tocIndex, buckets, BUCKET_COUNT, entryIndices, VARIABLE_COUNT);
+}
+
+void tearDown(void) {
+    // Empty
+}
+
+void testThatEveryVariableIsFoundByName() {
+    // Fixture
+    addTocToIndex();
+
+    // Test
+    // Assert
+    for (int group = 0; group < GROUP_COUNT; group++) {
+        for (int variable = 0; variable < VARIABLES_PER_GROUP; variable++) {
+            const int expectedId = group * VARIABLES_PER_GROUP + variable;
+            const int expectedEntryIndex = group * (VARIABLES_PER_GROUP + 2) + 1 + variable;
+            int actual = tocIndexFind(&tocIndex, toc[expectedEntryIndex - 1 - variable].name, toc[expectedEntryIndex].name, entryMatches);
+            TEST_ASSERT_EQUAL(expectedId, actual);
+            TEST_ASSERT_EQUAL(expectedEntryIndex, tocIndexGetEntryIndex(&tocIndex, actual));
+        }
+    }
+}
+
+void testThatTheIdsMapToTheEntriesLikeALinearScan() {
+    // Fixture
+    addTocToIndex();
+
+    // Test
+    // Assert
+    TEST_ASSERT_EQUAL(VARIABLE_COUNT, tocIndexGetVariableCount(&tocIndex));
+    for (int id = -1; id <= VARIABLE_COUNT; id++) {
+        TEST_ASSERT_EQUAL(linearGetEntryIndex(id), tocIndexGetEntryIndex(&tocIndex, id));
+    }
+}
+
+void testThatAMissingVariableIsNotFound() {
+    // Fixture
+    addTocToIndex();
+
+    // Test
+    // Assert
+    TEST_ASSERT_EQUAL(-1, tocIndexFind(&tocIndex, "group3", "missing", entryMatches));
+    TEST_ASSERT_EQUAL(-1, tocIndexFind(&tocIndex, "missing", "var3", entryMatches));
+    // A group is not a variable
+    TEST_ASSERT_EQUAL(-1, tocIndexFind(&tocIndex, "group3", "group3", entryMatches));
+}
+
+void testThatTheGroupTellsVariablesWithTheSameNameApart() {
+    // Fixture
+    addTocToIndex();
+
+    // Test
+    int first = tocIndexFind(&tocIndex, "group1", "var2", entryMatches);
+    int second = tocIndexFind(&tocIndex, "group2", "var2", entryMatches);
+
+    // Assert
+    TEST_ASSERT_EQUAL(1 * VARIABLES_PER_GROUP + 2, first);
+    TEST_ASSERT_EQUAL(2 * VARIABLES_PER_GROUP + 2, second);
+}
+
+void testThatTheFirstOfDuplicatedVariablesIsFound() {
+    // Fixture
+    strcpy(toc[3].name, toc[2].name);
+    addTocToIndex();
+
+    // Test
+    int actual = tocIndexFind(&tocIndex, "group0", toc[2].name, entryMatches);
+
+    // Assert
+    TEST_ASSERT_EQUAL(linearFind("group0", toc[2].name), tocIndexGetEntryIndex(&tocIndex, actual));
+    TEST_ASSERT_EQUAL(2, tocIndexGetEntryIndex(&tocIndex, actual));
+}
+
+void testThatAFullIndexRejectsVariables() {
+    // Fixture
+    uint16_t smallBuckets[4];
+    uint16_t smallEntryIndices[8];
+    tocIndexInit(&tocIndex, smallBuckets, 4, smallEntryIndices, 8);
+
+    // Test
+    // Assert
+    // One bucket stays empty
+    TEST_ASSERT_TRUE(tocIndexAddVariable(&tocIndex, "group0", "var0", 1));
+    TEST_ASSERT_TRUE(tocIndexAddVariable(&tocIndex, "group0", "var1", 2));
+    TEST_ASSERT_TRUE(tocIndexAddVariable(&tocIndex, "group0", "var2", 3));
+    TEST_ASSERT_FALSE(tocIndexAddVariable(&tocIndex, "group0", "var3", 4));
+    TEST_ASSERT_EQUAL(-1, tocIndexFind(&tocIndex, "group0", "var3", entryMatches));
+}
+
+void testBenchmarkOfTheLookupsOverAFullToc() {
+    // Fixture
+    addTocToIndex();
+
+    // Test
+    const double linearNameTime = measureNameLookups(false);
+    const double indexNameTime = measureNameLookups(true);
+    const double linearIdTime = measureIdLookups(false);
+    const double indexIdTime = measureIdLookups(true);
+
+    // Assert
+    printf("TOC of %d variables in %d groups      host time per lookup (linear scan / index)\n", VARIABLE_COUNT, GROUP_COUNT);
+    printf("By group and name (logGetVarId, paramGetVarId)   %.3f / %.3f us\n", linearNameTime, indexNameTime);
+    printf("By id (variableGetIndex)                          %.3f / %.3f us\n", linearIdTime, indexIdTime);
+    TEST_ASSERT_TRUE(indexNameTime < linearNameTime);
+    TEST_ASSERT_TRUE(indexIdTime < linearIdTime);
+}
+
+// Helpers ////////////////////////////////////////////////
+
+static void buildToc(void) {
+    int entry = 0;
+    for (int group = 0; group < GROUP_COUNT; group++) {
+        toc[entry].type = TOC_GROUP | TOC_START;
+        snprintf(toc[entry].name, NAME_LENGTH, "group%d", group);
+        entry++;
+
+        for (int variable = 0; variable < VARIABLES_PER_GROUP; variable++) {
+            toc[entry].type = 0;
+            snprintf(toc[entry].name, NAME_LENGTH, "var%d", variable);
+            entry++;
+        }
+
+        toc[entry].type = TOC_GROUP;
+        snprintf(toc[entry].name, NAME_LENGTH, "stop_group%d", group);
+        entry++;
+    }
+}
+
+// As log.c and param.c do at startup
+static void addTocToIndex(void) {
+    const char* group = "";
+    for (int i = 0; i < ENTRY_COUNT; i++) {
+        if (toc[i].type & TOC_GROUP) {
+            if (toc[i].type & TOC_START) {
+                group = toc[i].name;
+            }
+        } else {
+            TEST_ASSERT_TRUE(tocIndexAddVariable(&tocIndex, group, toc[i].name, i));
+        }
+    }
+}
+
+static const char* getGroupName(int entryIndex) {
+    for (int i = entryIndex; i >= 0; i--) {
+        if ((toc[i].type & TOC_GROUP) && (toc[i].type & TOC_START)) {
+            return toc[i].name;
+        }
+    }
+
+    return "";
+}
+
+static bool entryMatches(uint16_t entryIndex, const char* group, const char* name) {
+    return !strcmp(name, toc[entryIndex].name) && !strcmp(group, getGroupName(entryIndex));
+}
+
+// The lookups that log.c and param.c did before the index
+static int linearFind(const char* group, const char* name) {
+    const char* currentGroup = "";
+    for (int i = 0; i < ENTRY_COUNT; i++) {
+        if (toc[i].type & TOC_GROUP) {
+            if (toc[i].type & TOC_START) {
+                currentGroup = toc[i].name;
+            }
+        } else if (!strcmp(group, currentGroup) && !strcmp(name, toc[i].name)) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+static int linearGetEntryIndex(int id) {
+    int n = 0;
+    for (int i = 0; i < ENTRY_COUNT; i++) {
+        if (!(toc[i].type & TOC_GROUP)) {
+            if (n == id) {
+                return i;
+            }
+            n++;
+        }
+    }
+
+    return -1;
+}
+
+static double measureNameLookups(bool useIndex) {
+    volatile int sink = 0;
+
+    clock_t start = clock();
+    for (int pass = 0; pass < BENCHMARK_PASS_COUNT; pass++) {
+        for (int i = 0; i < ENTRY_COUNT; i++) {
+            if (toc[i].type & TOC_GROUP) {
+                continue;
+            }
+
+            const char* group = getGroupName(i);
+            if (useIndex) {
+                sink += tocIndexGetEntryIndex(&tocIndex, tocIndexFind(&tocIndex, group, toc[i].name, entryMatches));
+            } else {
+                sink += linearFind(group, toc[i].name);
+            }
+        }
+    }
+
+    return (double)(clock() - start) / CLOCKS_PER_SEC * 1e6 / (BENCHMARK_PASS_COUNT * VARIABLE_COUNT);
+}
+
+static double measureIdLookups(bool useIndex) {
+    volatile int sink = 0;
+
+    clock_t start = clock();
+    for (int pass = 0; pass < BENCHMARK_PASS_COUNT; pass++) {
+        for (int id = 0; id < VARIABLE_COUNT; id++) {
+            sink += useIndex ? tocIndexGetEntryIndex(&tocIndex, id) : linearGetEntryIndex(id);
+        }
+    }
+
+    return (double)(clock() - start) / CLOCKS_PER_SEC * 1e6 / (BENCHMARK_PASS_COUNT * VARIABLE_COUNT);
+}
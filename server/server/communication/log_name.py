@@ -11,3 +11,4 @@ class LogName(enum.Enum):
     RSSI = 'rssi'
     DRONE_STATUS = 'drone-status'
     CONSOLE = 'console'
+    MAP_CELLS = 'map-cells' # Only used for ARGoS, sent as binary map frames
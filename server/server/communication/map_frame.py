@@ -0,0 +1,42 @@
+import struct
+from typing import List
+from server.types.tuples import MapCell, Point
+
+# Must match the layout of MapFrameHeader and the cell records in argos/utils/map_frame.h
+MAP_FRAME_MAGIC = 0xB8
+MAP_FRAME_VERSION = 1
+_HEADER_STRUCT = struct.Struct('<BBHfff')
+_CELL_STRUCT = struct.Struct('<HHBH')
+MILLIMETER_TO_METER_FACTOR = 0.001
+
+
+class MapFrameError(Exception):
+    pass
+
+
+def is_map_frame(message_bytes: bytes) -> bool:
+    return len(message_bytes) > 0 and message_bytes[0] == MAP_FRAME_MAGIC
+
+
+def decode_map_frame(message_bytes: bytes) -> List[MapCell]:
+    # Returns the changed cells, with the position of their center in meters
+    if len(message_bytes) < _HEADER_STRUCT.size:
+        raise MapFrameError(f'Map frame too short: {len(message_bytes)} bytes')
+
+    _magic, version, cell_count, cell_size, origin_x, origin_y = _HEADER_STRUCT.unpack_from(message_bytes)
+    if version != MAP_FRAME_VERSION:
+        raise MapFrameError(f'Unsupported map frame version: {version}')
+
+    expected_size = _HEADER_STRUCT.size + cell_count * _CELL_STRUCT.size
+    if len(message_bytes) != expected_size:
+        raise MapFrameError(f'Invalid map frame size: expected {expected_size} bytes, received {len(message_bytes)}')
+
+    cells = []
+    for column, row, state, height in _CELL_STRUCT.iter_unpack(message_bytes[_HEADER_STRUCT.size:]):
+        center = Point(
+            origin_x + (column + 0.5) * cell_size,
+            origin_y + (row + 0.5) * cell_size,
+            height * MILLIMETER_TO_METER_FACTOR,
+        )
+        cells.append(MapCell(column, row, state, center))
+    return cells
@@ -0,0 +1,115 @@
+import struct
+from typing import Optional, Set, Tuple
+from server.types.tuples import Orientation, Point, Range, Scan, ScanRecord
+
+# Must match the packets in drone/app_api/src/mapping_stream.h, sent over the app channel of the platform port
+APP_CHANNEL = 2
+MAPPING_STREAM_BUFFER_SIZE = 32
+SCAN_RECORD_TYPE = 0
+RETRANSMIT_REQUEST_TYPE = 1
+_SCAN_RECORD_STRUCT = struct.Struct('<BHH3hhbb6BB2bb6B')
+_RETRANSMIT_REQUEST_STRUCT = struct.Struct('<BHB')
+_SEQUENCE_MODULO = 1 << 16
+_TIMESTAMP_MODULO = 1 << 16
+MILLIMETER_TO_METER_FACTOR = 0.001
+CENTIDEGREE_TO_DEGREE_FACTOR = 0.01
+DECIDEGREE_TO_DEGREE_FACTOR = 0.1
+CENTIMETER_TO_MILLIMETER_FACTOR = 10
+
+
+class MappingStreamError(Exception):
+    pass
+
+
+def decode_scan_record(packet_bytes: bytes) -> ScanRecord:
+    if len(packet_bytes) != _SCAN_RECORD_STRUCT.size or packet_bytes[0] != SCAN_RECORD_TYPE:
+        raise MappingStreamError(f'Invalid scan record of {len(packet_bytes)} bytes')
+
+    (_type, sequence, timestamp, x, y, z, yaw, roll, pitch, *fields) = _SCAN_RECORD_STRUCT.unpack(packet_bytes)
+    ranges = fields[0:6]
+    next_timestamp_delta, next_delta_x, next_delta_y, next_delta_yaw = fields[6:10]
+    next_ranges = fields[10:16]
+
+    # The second scan is delta-encoded from the first one and shares its roll, pitch and altitude
+    yaw_degrees = yaw * CENTIDEGREE_TO_DEGREE_FACTOR
+    next_yaw_degrees = (yaw_degrees + next_delta_yaw * DECIDEGREE_TO_DEGREE_FACTOR + 180) % 360 - 180
+    scans = [
+        (timestamp, x, y, yaw_degrees, ranges),
+        ((timestamp + next_timestamp_delta) % _TIMESTAMP_MODULO, x + next_delta_x, y + next_delta_y, next_yaw_degrees, next_ranges),
+    ]
+
+    return ScanRecord(sequence, [
+        Scan(
+            scan_timestamp,
+            Orientation(roll, pitch, scan_yaw),
+            Point(scan_x * MILLIMETER_TO_METER_FACTOR, scan_y * MILLIMETER_TO_METER_FACTOR, z * MILLIMETER_TO_METER_FACTOR),
+            _decode_ranges(scan_ranges),
+        ) for scan_timestamp, scan_x, scan_y, scan_yaw, scan_ranges in scans
+    ])
+
+
+def _decode_ranges(ranges: Tuple[int, ...]) -> Range:
+    front, back, left, right, up, down = (value * CENTIMETER_TO_MILLIMETER_FACTOR for value in ranges) # In rangeDirection_t order
+    return Range(front=front, left=left, back=back, right=right, up=up, down=down)
+
+
+def encode_retransmit_request(first_sequence: int, count: int) -> bytes:
+    return _RETRANSMIT_REQUEST_STRUCT.pack(RETRANSMIT_REQUEST_TYPE, first_sequence, count)
+
+
+class MappingStreamReceiver:
+    # Detects the records of a drone's stream which were lost, and the ones received again after a retransmit request
+    RETRANSMIT_RETRY_RECORD_COUNT = 10 # Records received before asking again for the records still missing
+
+    def __init__(self, is_retransmission_enabled: bool):
+        self._is_retransmission_enabled = is_retransmission_enabled
+        self._next_sequence: Optional[int] = None
+        self._missing_sequences: Set[int] = set()
+        self._has_new_gap = False
+        self._records_since_request = 0
+        self.lost_record_count = 0 # Records which went missing and are no longer stored by the drone
+
+    def add(self, sequence: int) -> Optional[bool]:
+        # Returns True for a record newer than the others, False for a missing record received late and None for a duplicate
+        if self._next_sequence is None:
+            self._next_sequence = (sequence + 1) % _SEQUENCE_MODULO
+            return True
+
+        # Sequences wrap around, so a record is newer if it is less than half the sequence range ahead
+        gap = (sequence - self._next_sequence) % _SEQUENCE_MODULO
+        if gap < _SEQUENCE_MODULO // 2:
+            if gap > 0:
+                self._missing_sequences.update((self._next_sequence + i) % _SEQUENCE_MODULO for i in range(gap))
+                self._has_new_gap = True
+            self._next_sequence = (sequence + 1) % _SEQUENCE_MODULO
+            self._records_since_request += 1
+            self._forget_unstored_records()
+            return True
+
+        if sequence in self._missing_sequences:
+            self._missing_sequences.remove(sequence)
+            return False
+        return None
+
+    def take_retransmit_request(self) -> Optional[Tuple[int, int]]:
+        # Returns the first sequence and the count of the records to ask for again, right after a gap and then periodically since
+        # requests and retransmitted records can be lost too
+        if not self._is_retransmission_enabled or len(self._missing_sequences) == 0:
+            return None
+        if not self._has_new_gap and self._records_since_request < self.RETRANSMIT_RETRY_RECORD_COUNT:
+            return None
+
+        self._has_new_gap = False
+        self._records_since_request = 0
+        ages = [self._get_age(sequence) for sequence in self._missing_sequences]
+        oldest_sequence = (self._next_sequence - max(ages)) % _SEQUENCE_MODULO
+        return oldest_sequence, max(ages) - min(ages) + 1
+
+    def _get_age(self, sequence: int) -> int:
+        # 1 for the latest record
+        return (self._next_sequence - sequence) % _SEQUENCE_MODULO
+
+    def _forget_unstored_records(self):
+        unstored_sequences = [sequence for sequence in self._missing_sequences if self._get_age(sequence) > MAPPING_STREAM_BUFFER_SIZE]
+        self._missing_sequences.difference_update(unstored_sequences)
+        self.lost_record_count += len(unstored_sequences)
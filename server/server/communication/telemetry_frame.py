@@ -0,0 +1,63 @@
+import struct
+from typing import Any, Dict, Iterator, List, Tuple
+from server.communication.log_name import LogName
+
+# Must match the layout of TelemetryFrameHeader and the telemetry field descriptors in argos/utils/telemetry_frame.h
+TELEMETRY_FRAME_MAGIC = 0xB7
+TELEMETRY_FRAME_VERSION = 2
+_HEADER_STRUCT = struct.Struct('<BBHI')
+_RECORD_HEADER_STRUCT = struct.Struct('<HB')
+
+# Log groups in the order of the bits of a record's group mask, with the layout of their fields
+_TELEMETRY_GROUPS = [
+    (LogName.BATTERY_LEVEL, struct.Struct('<B'), ['hivexplore.batteryLevel']),
+    (LogName.ORIENTATION, struct.Struct('<3f'), ['stateEstimate.roll', 'stateEstimate.pitch', 'stateEstimate.yaw']),
+    (LogName.POSITION, struct.Struct('<3f'), ['stateEstimate.x', 'stateEstimate.y', 'stateEstimate.z']),
+    (LogName.VELOCITY, struct.Struct('<3f'), ['stateEstimate.vx', 'stateEstimate.vy', 'stateEstimate.vz']),
+    (LogName.RANGE, struct.Struct('<6H'), ['range.front', 'range.left', 'range.back', 'range.right', 'range.up', 'range.zrange']),
+    (LogName.RSSI, struct.Struct('<B'), ['radio.rssi']),
+    (LogName.DRONE_STATUS, struct.Struct('<B'), ['hivexplore.droneStatus']),
+]
+
+
+class TelemetryFrameError(Exception):
+    pass
+
+
+def is_telemetry_frame(message_bytes: bytes) -> bool:
+    return len(message_bytes) > 0 and message_bytes[0] == TELEMETRY_FRAME_MAGIC
+
+
+def decode_telemetry_frame(message_bytes: bytes) -> Iterator[Tuple[int, List[Tuple[LogName, Dict[str, Any]]]]]:
+    # Yields the drone index and the log groups of each record, in the same order as the JSON telemetry packets
+    if len(message_bytes) < _HEADER_STRUCT.size:
+        raise TelemetryFrameError(f'Telemetry frame too short: {len(message_bytes)} bytes')
+
+    _magic, version, record_count, _tick = _HEADER_STRUCT.unpack_from(message_bytes)
+    if version != TELEMETRY_FRAME_VERSION:
+        raise TelemetryFrameError(f'Unsupported telemetry frame version: {version}')
+
+    offset = _HEADER_STRUCT.size
+    for _ in range(record_count):
+        if offset + _RECORD_HEADER_STRUCT.size > len(message_bytes):
+            raise TelemetryFrameError(f'Truncated telemetry frame: {len(message_bytes)} bytes for {record_count} records')
+
+        drone_index, group_mask = _RECORD_HEADER_STRUCT.unpack_from(message_bytes, offset)
+        offset += _RECORD_HEADER_STRUCT.size
+
+        log_groups = []
+        for group_index, (log_name, group_struct, variable_names) in enumerate(_TELEMETRY_GROUPS):
+            if not group_mask & (1 << group_index):
+                continue
+
+            if offset + group_struct.size > len(message_bytes):
+                raise TelemetryFrameError(f'Truncated telemetry frame: {len(message_bytes)} bytes for {record_count} records')
+
+            values = group_struct.unpack_from(message_bytes, offset)
+            offset += group_struct.size
+            log_groups.append((log_name, dict(zip(variable_names, values))))
+
+        yield drone_index, log_groups
+
+    if offset != len(message_bytes):
+        raise TelemetryFrameError(f'Invalid telemetry frame size: expected {offset} bytes, received {len(message_bytes)}')
@@ -4,6 +4,8 @@ import logging
 import socket
 from typing import Any, Callable, Dict, List, Optional, Union
 from server.communication.log_name import LogName
+from server.communication.map_frame import MapFrameError, decode_map_frame, is_map_frame
+from server.communication.telemetry_frame import TelemetryFrameError, decode_telemetry_frame, is_telemetry_frame
 from server.communication.unix_socket_event import UnixSocketEvent
 from server.logger.logger import Logger
 
@@ -19,6 +21,7 @@ class UnixSocketClient:
         self._logger = logger
         self._callbacks: Dict[Union[LogName, UnixSocketEvent], List[Callable]] = {}
         self._message_queue: asyncio.Queue
+        self._drone_ids: List[str] = []
         self._create_socket()
 
     async def serve(self):
@@ -84,6 +87,14 @@ class UnixSocketClient:
             if len(message_bytes) == 0:
                 raise UnixSocketError('Socket connection broken in receive handler')
 
+            if is_telemetry_frame(message_bytes):
+                self._handle_telemetry_frame(message_bytes)
+                continue
+
+            if is_map_frame(message_bytes):
+                self._handle_map_frame(message_bytes)
+                continue
+
             try:
                 message = json.loads(message_bytes.decode('utf-8'))
 
@@ -93,23 +104,48 @@ class UnixSocketClient:
                     self._logger.log_server_data(logging.WARN, f'UnixSocketClient warning: Invalid log name received: {message["logName"]}')
                     continue
 
-                if log_name in EVENT_DENYLIST:
-                    self._logger.log_server_data(logging.ERROR,
-                                                 f'UnixSocketClient error: Forbidden log name received: {message["logName"]}')
-                    continue
+                if log_name == LogName.DRONE_IDS:
+                    # Keep drone IDs to resolve the drone indices of binary telemetry frames
+                    self._drone_ids = message['variables']
+
+                self._dispatch(log_name, message['droneId'], message['variables'])
 
+            except (json.JSONDecodeError, KeyError) as exc:
+                self._logger.log_server_data(logging.ERROR, f'UnixSocketClient error: Invalid message received: {exc}')
+
+    def _handle_telemetry_frame(self, message_bytes: bytes):
+        try:
+            for drone_index, log_groups in decode_telemetry_frame(message_bytes):
                 try:
-                    callbacks = self._callbacks[log_name]
-                except KeyError:
-                    self._logger.log_server_data(logging.WARN,
-                                                 f'UnixSocketClient warning: No callbacks bound for log name: {message["logName"]}')
+                    drone_id = self._drone_ids[drone_index]
+                except IndexError:
+                    self._logger.log_server_data(logging.WARN, f'UnixSocketClient warning: Unknown drone index received: {drone_index}')
                     continue
 
-                for callback in callbacks:
-                    callback(message['droneId'], message['variables'])
+                for log_name, variables in log_groups:
+                    self._dispatch(log_name, drone_id, variables)
+        except TelemetryFrameError as exc:
+            self._logger.log_server_data(logging.ERROR, f'UnixSocketClient error: Invalid telemetry frame received: {exc}')
 
-            except (json.JSONDecodeError, KeyError) as exc:
-                self._logger.log_server_data(logging.ERROR, f'UnixSocketClient error: Invalid message received: {exc}')
+    def _handle_map_frame(self, message_bytes: bytes):
+        try:
+            self._dispatch(LogName.MAP_CELLS, None, decode_map_frame(message_bytes))
+        except MapFrameError as exc:
+            self._logger.log_server_data(logging.ERROR, f'UnixSocketClient error: Invalid map frame received: {exc}')
+
+    def _dispatch(self, log_name: LogName, drone_id: Optional[str], variables: Any):
+        if log_name in EVENT_DENYLIST:
+            self._logger.log_server_data(logging.ERROR, f'UnixSocketClient error: Forbidden log name received: {log_name.value}')
+            return
+
+        try:
+            callbacks = self._callbacks[log_name]
+        except KeyError:
+            self._logger.log_server_data(logging.WARN, f'UnixSocketClient warning: No callbacks bound for log name: {log_name.value}')
+            return
+
+        for callback in callbacks:
+            callback(drone_id, variables)
 
     async def _send_handler(self):
         while True:
@@ -9,6 +9,9 @@ def main():
         subparsers = parser.add_subparsers(dest='mode', required=True)
         drone_parser = subparsers.add_parser('drone', help='use the Crazyradio to connect to Crazyflies')
         drone_parser.add_argument('--debug', action='store_true', help='enable the Crazyflie debug driver')
+        drone_parser.add_argument('--no-retransmission',
+                                  action='store_true',
+                                  help='do not ask the Crazyflies to send lost mapping records again')
         subparsers.add_parser('argos', help='use ARGoS to simulate the drones')
 
         args = parser.parse_args()
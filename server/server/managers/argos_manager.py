@@ -8,7 +8,7 @@ from server.logger.logger import Logger
 from server.managers.drone_manager import DroneManager
 from server.managers.map_generator import MapGenerator
 from server.types.mission_state import MissionState
-from server.types.tuples import Point
+from server.types.tuples import MapCell, Point
 
 
 class ArgosManager(DroneManager):
@@ -29,6 +29,7 @@ class ArgosManager(DroneManager):
         self._unix_socket_client.bind(LogName.RSSI, self._log_rssi_callback)
         self._unix_socket_client.bind(LogName.DRONE_STATUS, self._log_drone_status_callback)
         self._unix_socket_client.bind(LogName.CONSOLE, self._log_console_callback)
+        self._unix_socket_client.bind(LogName.MAP_CELLS, self._map_cells_callback)
 
         await self._unix_socket_client.serve()
 
@@ -58,6 +59,9 @@ class ArgosManager(DroneManager):
         self._send_drone_ids()
         self._logger.log_server_data(logging.INFO, f'Received drone IDs: {self._drone_ids}')
 
+    def _map_cells_callback(self, _drone_id: Optional[str], cells: List[MapCell]):
+        self._map_generator.add_map_cells(cells)
+
     def _log_console_callback(self, drone_id: str, data: str):
         for line in data.split('\n'):
             super()._log_console_callback(drone_id, line)
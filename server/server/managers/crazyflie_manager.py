@@ -5,7 +5,10 @@ from typing import Any, Dict, List
 import cflib
 from cflib.crazyflie import Crazyflie
 from cflib.crazyflie.log import LogConfig
+from cflib.crtp.crtpstack import CRTPPacket, CRTPPort
 from server.communication.log_name import LogName
+from server.communication.mapping_stream import (APP_CHANNEL, MappingStreamError, MappingStreamReceiver, decode_scan_record,
+                                                 encode_retransmit_request)
 from server.communication.param_name import ParamName
 from server.communication.web_socket_event import WebSocketEvent
 from server.communication.web_socket_server import WebSocketServer
@@ -13,16 +16,19 @@ from server.logger.logger import Logger
 from server.managers.drone_manager import DroneManager
 from server.managers.map_generator import MapGenerator
 from server.types.mission_state import MissionState
-from server.types.tuples import Point
+from server.types.tuples import Point, Scan
 from server.utils.config_parser import CRAZYFLIES_CONFIG_FILENAME, load_crazyflies_config
 
 
 class CrazyflieManager(DroneManager):
-    def __init__(self, web_socket_server: WebSocketServer, logger: Logger, map_generator: MapGenerator, enable_debug_driver: bool):
+    def __init__(self, web_socket_server: WebSocketServer, logger: Logger, map_generator: MapGenerator, enable_debug_driver: bool,
+                 is_retransmission_enabled: bool):
         super().__init__(web_socket_server, logger, map_generator)
         self._connected_crazyflies: Dict[str, Crazyflie] = {}
         self._pending_crazyflies: Dict[str, Crazyflie] = {}
         self._crazyflies_config: Dict[str, Dict[str, Any]] = {}
+        self._is_retransmission_enabled = is_retransmission_enabled
+        self._mapping_stream_receivers: Dict[str, MappingStreamReceiver] = {}
 
         cflib.crtp.init_drivers(enable_debug_driver=enable_debug_driver)
 
@@ -95,31 +101,12 @@ class CrazyflieManager(DroneManager):
                 'data_callback': lambda _timestamp, data, logconf: self._log_battery_callback(logconf.cf.link_uri, data),
                 'error_callback': self._log_error_callback,
             },
-            {
-                'log_config': LogConfig(name=LogName.ORIENTATION.value, period_in_ms=POLLING_PERIOD_MS),
-                'variables': ['stateEstimate.roll', 'stateEstimate.pitch', 'stateEstimate.yaw'],
-                'data_callback': lambda _timestamp, data, logconf: self._log_orientation_callback(logconf.cf.link_uri, data),
-                'error_callback': self._log_error_callback,
-            },
-            {
-                'log_config': LogConfig(name=LogName.POSITION.value, period_in_ms=POLLING_PERIOD_MS),
-                'variables': ['stateEstimate.x', 'stateEstimate.y', 'stateEstimate.z'],
-                'data_callback': lambda _timestamp, data, logconf: self._log_position_callback(logconf.cf.link_uri, data),
-                'error_callback': self._log_error_callback,
-            },
             {
                 'log_config': LogConfig(name=LogName.VELOCITY.value, period_in_ms=POLLING_PERIOD_MS),
                 'variables': ['stateEstimate.vx', 'stateEstimate.vy', 'stateEstimate.vz'],
                 'data_callback': lambda _timestamp, data, logconf: self._log_velocity_callback(logconf.cf.link_uri, data),
                 'error_callback': self._log_error_callback,
             },
-            {
-                'log_config': LogConfig(name=LogName.RANGE.value,
-                                        period_in_ms=POLLING_PERIOD_MS), # Must be added after orientation and position
-                'variables': ['range.front', 'range.left', 'range.back', 'range.right', 'range.up', 'range.zrange'],
-                'data_callback': lambda _timestamp, data, logconf: self._log_range_callback(logconf.cf.link_uri, data),
-                'error_callback': self._log_error_callback,
-            },
             {
                 'log_config': LogConfig(name=LogName.RSSI.value, period_in_ms=POLLING_PERIOD_MS),
                 'variables': ['radio.rssi'],
@@ -149,6 +136,13 @@ class CrazyflieManager(DroneManager):
             except AttributeError as exc:
                 self._logger.log_server_data(logging.ERROR, f'CrazyflieManager error: Could not add log configuration: {exc}')
 
+    def _setup_mapping_stream(self, crazyflie: Crazyflie):
+        # The orientation, position and ranges are streamed together over the app channel instead of being logged
+        link_uri = crazyflie.link_uri
+        self._mapping_stream_receivers[link_uri] = MappingStreamReceiver(self._is_retransmission_enabled)
+        crazyflie.add_port_callback(CRTPPort.PLATFORM,
+                                    lambda packet: self._app_channel_callback(link_uri, packet) if packet.channel == APP_CHANNEL else None)
+
     def _setup_param(self, crazyflie: Crazyflie):
         crazyflie.param.add_update_callback(group='hivexplore', name=ParamName.MISSION_STATE.value, cb=self._param_update_callback)
         crazyflie.param.add_update_callback(group='hivexplore', name=ParamName.IS_LED_ENABLED.value, cb=self._param_update_callback)
@@ -177,6 +171,7 @@ class CrazyflieManager(DroneManager):
         del self._pending_crazyflies[link_uri]
 
         self._setup_log(self._connected_crazyflies[link_uri])
+        self._setup_mapping_stream(self._connected_crazyflies[link_uri])
         self._setup_param(self._connected_crazyflies[link_uri])
 
         # Setup console logging
@@ -193,6 +188,7 @@ class CrazyflieManager(DroneManager):
         self._drone_statuses.pop(link_uri, None)
         self._drone_leds.pop(link_uri, None)
         self._drone_battery_levels.pop(link_uri, None)
+        self._mapping_stream_receivers.pop(link_uri, None)
 
         self._send_drone_ids()
 
@@ -219,6 +215,62 @@ class CrazyflieManager(DroneManager):
     def _log_error_callback(self, logconf, msg):
         self._logger.log_server_data(logging.ERROR, f'Error when logging {logconf.name}: {msg}')
 
+    # App channel callbacks
+
+    def _app_channel_callback(self, drone_id: str, packet: CRTPPacket):
+        receiver = self._mapping_stream_receivers.get(drone_id)
+        if receiver is None:
+            return
+
+        try:
+            record = decode_scan_record(packet.data)
+        except MappingStreamError as exc:
+            self._logger.log_server_data(logging.ERROR, f'CrazyflieManager error: {exc} from {drone_id}')
+            return
+
+        lost_record_count = receiver.lost_record_count
+        is_latest_record = receiver.add(record.sequence)
+        if receiver.lost_record_count > lost_record_count:
+            self._logger.log_drone_data(logging.WARN, drone_id,
+                                        f'Lost {receiver.lost_record_count - lost_record_count} mapping records')
+
+        if is_latest_record:
+            for scan in record.scans:
+                self._handle_latest_scan(drone_id, scan)
+        elif is_latest_record is not None and self._mission_state not in (MissionState.Standby, MissionState.Landed):
+            base_offset = self._get_drone_base_offset(drone_id)
+            for scan in record.scans:
+                position = Point(*(coordinate + offset for coordinate, offset in zip(scan.position, base_offset)))
+                self._map_generator.add_past_range_reading(drone_id, scan.orientation, position, scan.range)
+
+        retransmit_request = receiver.take_retransmit_request()
+        if retransmit_request is not None and drone_id in self._connected_crazyflies:
+            request_packet = CRTPPacket()
+            request_packet.set_header(CRTPPort.PLATFORM, APP_CHANNEL)
+            request_packet.data = encode_retransmit_request(*retransmit_request)
+            self._connected_crazyflies[drone_id].send_packet(request_packet)
+
+    def _handle_latest_scan(self, drone_id: str, scan: Scan):
+        # Same as the log groups, in the order the map generator expects them
+        self._log_orientation_callback(drone_id, {
+            'stateEstimate.roll': scan.orientation.roll,
+            'stateEstimate.pitch': scan.orientation.pitch,
+            'stateEstimate.yaw': scan.orientation.yaw,
+        })
+        self._log_position_callback(drone_id, {
+            'stateEstimate.x': scan.position.x,
+            'stateEstimate.y': scan.position.y,
+            'stateEstimate.z': scan.position.z,
+        })
+        self._log_range_callback(drone_id, {
+            'range.front': scan.range.front,
+            'range.left': scan.range.left,
+            'range.back': scan.range.back,
+            'range.right': scan.range.right,
+            'range.up': scan.range.up,
+            'range.zrange': scan.range.down,
+        })
+
     # Param callbacks
 
     def _param_update_callback(self, name, value):
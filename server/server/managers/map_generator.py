@@ -1,11 +1,12 @@
 import logging
 import math
-from typing import Dict, List, Tuple
+from typing import Dict, List, Set, Tuple
 import numpy as np
 from server.communication.web_socket_event import WebSocketEvent
 from server.communication.web_socket_server import WebSocketServer
 from server.logger.logger import Logger
-from server.types.tuples import Orientation, Point, Range
+from server.types.map_cell_state import MapCellState
+from server.types.tuples import MapCell, Orientation, Point, Range
 
 
 class MapGenerator:
@@ -15,6 +16,9 @@ class MapGenerator:
         self._last_orientations: Dict[str, Orientation] = {}
         self._last_positions: Dict[str, Point] = {}
         self._points: List[Point] = []
+        # Set once ARGoS sends its own map, which then replaces the points calculated from range readings
+        self._is_map_streamed = False
+        self._plotted_cells: Set[Tuple[int, int]] = set()
 
         self._web_socket_server.bind(WebSocketEvent.CONNECT, self._web_socket_connect_callback)
 
@@ -27,17 +31,40 @@ class MapGenerator:
 
     def add_range_reading(self, drone_id: str, range_reading: Range):
         points = self._calculate_points_from_readings(self._last_orientations[drone_id], self._last_positions[drone_id], range_reading)
-        self._points.extend(points)
-        self._logger.log_map_data(logging.INFO, drone_id, points)
-        self._web_socket_server.send_message(WebSocketEvent.MAP_POINTS, points)
+        self._add_points(drone_id, points)
 
         lines = self._calculate_drone_sensor_lines(self._last_positions[drone_id], points)
         self._web_socket_server.send_message(WebSocketEvent.DRONE_SENSOR_LINES, {'droneId': drone_id, 'sensorLines': lines})
 
+    def add_past_range_reading(self, drone_id: str, orientation: Orientation, position: Point, range_reading: Range):
+        # For readings received after newer ones, which are mapped from their own pose without moving the drone's sensor lines
+        self._add_points(drone_id, self._calculate_points_from_readings(orientation, position, range_reading))
+
+    def add_map_cells(self, cells: List[MapCell]):
+        self._is_map_streamed = True
+
+        # The client can only add points, so each occupied cell is plotted once until the map is cleared
+        points = []
+        for cell in cells:
+            if cell.state == MapCellState.Occupied and (cell.column, cell.row) not in self._plotted_cells:
+                self._plotted_cells.add((cell.column, cell.row))
+                points.append(cell.center)
+
+        if len(points) > 0:
+            self._points.extend(points)
+            self._web_socket_server.send_message(WebSocketEvent.MAP_POINTS, points)
+
     def clear(self):
         self._points.clear()
+        self._plotted_cells.clear()
         self._web_socket_server.send_message(WebSocketEvent.CLEAR_MAP, None)
 
+    def _add_points(self, drone_id: str, points: List[Point]):
+        if not self._is_map_streamed:
+            self._points.extend(points)
+            self._logger.log_map_data(logging.INFO, drone_id, points)
+            self._web_socket_server.send_message(WebSocketEvent.MAP_POINTS, points)
+
     def _calculate_points_from_readings(self, last_orientation: Orientation, last_position: Point, range_reading: Range) -> List[Point]:
         IS_DOWN_SENSOR_PLOTTING_ENABLED = False
         SENSOR_THRESHOLD = 2000
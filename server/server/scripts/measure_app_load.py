@@ -0,0 +1,67 @@
+import re
+import statistics
+import sys
+import time
+from typing import Dict, List
+import cflib
+from cflib.crazyflie import Crazyflie
+from cflib.crazyflie.syncCrazyflie import SyncCrazyflie
+
+# Lines of the firmware's task dump (sysload.c): load in %, unused stack and task name, separated by tabs
+TASK_DUMP_LINE_REGEX = re.compile(r'^\s*(\d+\.\d+)\s+(\d+)\s+(\S+)\s*$')
+MEASURED_TASKS = ['app', 'STABILIZER', 'MR', 'IDLE']
+SAMPLE_COUNT = 10
+SETTLING_DELAY_S = 2
+
+
+def main():
+    if len(sys.argv) != 2:
+        print('Incorrect program usage.\nExample usage: python3 -m server.scripts.measure_app_load radio://0/80/2M/E7E7E7E701')
+        sys.exit(1)
+
+    cflib.crtp.init_drivers(enable_debug_driver=False)
+
+    print('Trying to connect to:', sys.argv[1])
+    with SyncCrazyflie(sys.argv[1], cf=Crazyflie(rw_cache='./cache')) as sync_crazyflie:
+        crazyflie = sync_crazyflie.cf
+        console_lines: List[str] = ['']
+        crazyflie.console.receivedChar.add_callback(lambda text: _append_console_text(console_lines, text))
+
+        # Compare the app's loop polling at a fixed period with the loop woken up by new data
+        for is_loop_event_driven in (False, True):
+            crazyflie.param.set_value('hivexplore.isLoopEventDriven', int(is_loop_event_driven))
+            time.sleep(SETTLING_DELAY_S)
+            loads = _measure_task_loads(crazyflie, console_lines)
+
+            print(f'\n{"Event-driven" if is_loop_event_driven else "Fixed period"} app loop, average load over {SAMPLE_COUNT} s:')
+            for task_name in MEASURED_TASKS:
+                if task_name in loads:
+                    print(f'{task_name:>12}: {statistics.mean(loads[task_name]):.2f} %')
+
+
+def _append_console_text(console_lines: List[str], text: str):
+    lines = text.split('\n')
+    console_lines[-1] += lines[0]
+    console_lines.extend(lines[1:])
+
+
+def _measure_task_loads(crazyflie: Crazyflie, console_lines: List[str]) -> Dict[str, List[float]]:
+    # The first dump covers the time since the previous dump, so it is only used to start the measurement
+    crazyflie.param.set_value('system.taskDump', 1)
+    time.sleep(1)
+    console_lines[:] = ['']
+
+    loads: Dict[str, List[float]] = {}
+    for _ in range(SAMPLE_COUNT):
+        crazyflie.param.set_value('system.taskDump', 1)
+        time.sleep(1)
+
+    for line in console_lines:
+        match = TASK_DUMP_LINE_REGEX.match(line)
+        if match is not None:
+            loads.setdefault(match.group(3), []).append(float(match.group(1)))
+    return loads
+
+
+if __name__ == '__main__':
+    main()
@@ -17,7 +17,8 @@ class Server:
 
         self._drone_manager: DroneManager
         if args.mode == 'drone':
-            self._drone_manager = CrazyflieManager(self._web_socket_server, self._logger, self._map_generator, args.debug)
+            self._drone_manager = CrazyflieManager(self._web_socket_server, self._logger, self._map_generator, args.debug,
+                                                   not args.no_retransmission)
         elif args.mode == 'argos':
             self._drone_manager = ArgosManager(self._web_socket_server, self._logger, self._map_generator)
 
@@ -0,0 +1,9 @@
+from enum import IntEnum
+
+
+# Must match MapCellState in argos/utils/map_frame.h
+# pylint: disable=invalid-name
+class MapCellState(IntEnum):
+    Unknown = 0
+    Free = 1
+    Occupied = 2
@@ -2,5 +2,8 @@ from collections import namedtuple
 
 Orientation = namedtuple('Orientation', ['roll', 'pitch', 'yaw'])
 Point = namedtuple('Point', ['x', 'y', 'z'])
+MapCell = namedtuple('MapCell', ['column', 'row', 'state', 'center'])
 Range = namedtuple('Range', ['front', 'left', 'back', 'right', 'up', 'down'])
+ScanRecord = namedtuple('ScanRecord', ['sequence', 'scans'])
+Scan = namedtuple('Scan', ['timestamp', 'orientation', 'position', 'range'])
 Velocity = namedtuple('Velocity', ['vx', 'vy', 'vz'])